@@ -0,0 +1,506 @@
+/*
+  ==============================================================================
+
+    EngineBenchmark.cpp
+
+    Headless throughput benchmark for the plugin's audio thread. Each run
+    drives a CompressorEngine through the same per-block calls as
+    AutoCompressorAudioProcessor::processBlock() (settings handoff,
+    loudness FIFO, auto or manual parameters, compression) over a grid of
+    block sizes, sample rates, modes, channel counts and input signals,
+    and reports ns per sample and bytes per second. As in the plugin, the
+    analysis runs on an AnalysisWorker in every mode and only the audio
+    thread is timed; the -inline modes run it inside the timed calls
+    instead, as an offline render does. Results can be written
+    as JSON and compared against an earlier run; the comparison fails when
+    any case got slower than the threshold allows.
+
+      cumpressor_benchmark [--quick] [--blocks 64,512] [--rates 48000]
+                           [--modes auto,manual,auto-inline,manual-inline]
+                           [--channels 1,2]
+                           [--signals silence,sine,noise] [--seconds 0.25]
+                           [--repeats 5] [--json results.json]
+                           [--baseline old.json] [--threshold 10]
+                           [--isa baseline|avx2|avx512]
+      cumpressor_benchmark --compare old.json new.json [--threshold 10]
+
+  ==============================================================================
+*/
+
+#include "AnalysisWorker.h"
+#include "CompressorEngine.h"
+#include "SimdKernels.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+ #include <xmmintrin.h>
+#endif
+
+using namespace autocomp;
+
+namespace
+{
+    //==============================================================================
+    struct Options
+    {
+        std::vector<int> blockSizes { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192 };
+        std::vector<int> sampleRates { 44100, 48000, 96000, 192000 };
+        std::vector<std::string> modes { "auto", "auto-inline", "manual", "manual-inline" };
+        std::vector<int> channelCounts { 1, 2 };
+        std::vector<std::string> signals { "silence", "sine", "noise" };
+        double seconds = 0.25;          // audio per timed repetition
+        int repeats = 5;
+        double threshold = 10.0;        // percent slower that counts as a regression
+        kernels::InstructionSet instructionSet = kernels::getGainKernels().instructionSet;
+        std::string jsonPath, baselinePath;
+        std::vector<std::string> comparePaths;
+    };
+
+    struct Result
+    {
+        std::string name, mode, signal;
+        int channels = 0, sampleRate = 0, blockSize = 0;
+        double nsPerSample = 0.0, minNsPerSample = 0.0, bytesPerSecond = 0.0, realtimeFactor = 0.0;
+    };
+
+    // Same as juce::ScopedNoDenormals in processBlock()
+    struct ScopedFlushDenormals
+    {
+#if defined(__SSE2__) || defined(_M_X64)
+        ScopedFlushDenormals() : saved(_mm_getcsr()) { _mm_setcsr(saved | 0x8040); }
+        ~ScopedFlushDenormals() { _mm_setcsr(saved); }
+        unsigned int saved;
+#endif
+    };
+
+    //==============================================================================
+    std::vector<std::string> split(const std::string& text)
+    {
+        std::vector<std::string> parts;
+        std::stringstream stream(text);
+
+        for (std::string part; std::getline(stream, part, ',');)
+            if (! part.empty())
+                parts.push_back(part);
+
+        return parts;
+    }
+
+    std::vector<int> splitInts(const std::string& text)
+    {
+        std::vector<int> values;
+
+        for (const auto& part : split(text))
+            values.push_back(std::atoi(part.c_str()));
+
+        return values;
+    }
+
+    void printUsage()
+    {
+        std::printf("usage: cumpressor_benchmark [--quick] [--blocks N,..] [--rates HZ,..]\n"
+                    "                            [--modes auto,auto-inline,manual,manual-inline] [--channels 1,2]\n"
+                    "                            [--signals silence,sine,noise] [--seconds S]\n"
+                    "                            [--repeats N] [--json FILE] [--baseline FILE] [--threshold PERCENT]\n"
+                    "                            [--isa baseline|avx2|avx512]\n"
+                    "       cumpressor_benchmark --compare BASELINE CURRENT [--threshold PERCENT]\n");
+    }
+
+    // Returns false (after printing usage) for --help or a bad argument
+    bool parseOptions(int argc, char** argv, Options& options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string argument = argv[i];
+            const auto hasValue = i + 1 < argc;
+
+            if (argument == "--quick")
+            {
+                options.blockSizes = { 64, 512, 4096 };
+                options.sampleRates = { 48000 };
+                options.seconds = 0.1;
+                options.repeats = 3;
+            }
+            else if (argument == "--blocks" && hasValue)     options.blockSizes = splitInts(argv[++i]);
+            else if (argument == "--rates" && hasValue)      options.sampleRates = splitInts(argv[++i]);
+            else if (argument == "--modes" && hasValue)      options.modes = split(argv[++i]);
+            else if (argument == "--channels" && hasValue)   options.channelCounts = splitInts(argv[++i]);
+            else if (argument == "--signals" && hasValue)    options.signals = split(argv[++i]);
+            else if (argument == "--seconds" && hasValue)    options.seconds = std::atof(argv[++i]);
+            else if (argument == "--repeats" && hasValue)    options.repeats = std::max(std::atoi(argv[++i]), 1);
+            else if (argument == "--json" && hasValue)       options.jsonPath = argv[++i];
+            else if (argument == "--baseline" && hasValue)   options.baselinePath = argv[++i];
+            else if (argument == "--threshold" && hasValue)  options.threshold = std::atof(argv[++i]);
+            else if (argument == "--isa" && hasValue)
+            {
+                const std::string name = argv[++i];
+                options.instructionSet = name == "avx512" ? kernels::InstructionSet::avx512
+                                       : name == "avx2" ? kernels::InstructionSet::avx2
+                                                        : kernels::InstructionSet::baseline;
+            }
+            else if (argument == "--compare" && i + 2 < argc)
+            {
+                options.comparePaths = { argv[i + 1], argv[i + 2] };
+                i += 2;
+            }
+            else
+            {
+                printUsage();
+                return false;
+            }
+        }
+
+        for (const auto& mode : options.modes)
+        {
+            if (mode != "auto" && mode != "auto-inline" && mode != "manual" && mode != "manual-inline")
+            {
+                printUsage();
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    //==============================================================================
+    // Deterministic test input, one buffer per channel
+    std::vector<std::vector<float>> makeSignal(const std::string& signal, int numChannels, int numSamples, double sampleRate)
+    {
+        std::vector<std::vector<float>> channels(static_cast<size_t>(numChannels),
+                                                 std::vector<float>(static_cast<size_t>(numSamples), 0.0f));
+        std::uint32_t seed = 0x12345678u;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto& data = channels[static_cast<size_t>(ch)];
+
+            for (size_t i = 0; i < data.size(); ++i)
+            {
+                if (signal == "sine")
+                {
+                    // 1 kHz at -6 dBFS, well over the default thresholds
+                    data[i] = 0.5f * static_cast<float>(std::sin(6.283185307179586 * 1000.0 * static_cast<double>(i) / sampleRate
+                                                                 + 0.5 * ch));
+                }
+                else if (signal == "noise")
+                {
+                    seed = seed * 1664525u + 1013904223u;
+                    data[i] = 0.6f * (static_cast<float>(seed >> 8) / 8388608.0f - 1.0f);
+                }
+            }
+        }
+
+        return channels;
+    }
+
+    //==============================================================================
+    // One block the way processBlock() does it; the JUCE-only parts (bus
+    // buffers, parameter pointers, latency reporting) have no engine cost
+    void processBlock(CompressorEngine& engine, const std::string& mode, float* const* channels, int numChannels, int numSamples)
+    {
+        engine.beginBlock();
+        engine.setOversamplingFactor(1);
+        engine.setLookahead(0.0f);
+        engine.setNumBands(1);
+
+        engine.setLoudnessTarget(-14.0f);
+        engine.analyzeAudioLevel(channels, numChannels, numSamples);
+
+        if (mode.compare(0, 6, "manual") == 0)
+            engine.setTargetSettings({ -24.0f, 4.0f, 5.0f, 120.0f, 3.0f });
+        else
+            engine.applyAutoParameters();
+
+        engine.setDetectorHighPass(0.0f);
+        engine.setStereoLink(StereoLink::linked);
+        engine.compress(channels, numChannels, numSamples);
+    }
+
+    Result runCase(const Options& options, const std::string& mode, int numChannels,
+                   const std::string& signal, int sampleRate, int blockSize)
+    {
+        const auto totalSamples = std::max(static_cast<int>(options.seconds * sampleRate), blockSize);
+        const auto input = makeSignal(signal, numChannels, totalSamples, sampleRate);
+        auto work = input;
+
+        auto engine = std::make_unique<CompressorEngine>();
+        engine->prepare(sampleRate, blockSize, numChannels);
+        engine->setInstructionSet(options.instructionSet);
+
+        // The plugin in real time runs the analysis on the worker in either
+        // mode, so only the audio thread's share is timed. -inline: offline
+        // rendering, the analysis runs inside the timed calls.
+        AnalysisWorker worker(*engine);
+        const auto inlineAnalysis = mode.size() > 7 && mode.compare(mode.size() - 7, 7, "-inline") == 0;
+
+        if (! inlineAnalysis)
+            worker.start();
+
+        ScopedFlushDenormals flushDenormals;
+        std::vector<double> timings;
+
+        // One untimed pass to warm caches and let auto mode settle
+        for (int repetition = -1; repetition < options.repeats; ++repetition)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                std::copy(input[static_cast<size_t>(ch)].begin(), input[static_cast<size_t>(ch)].end(),
+                          work[static_cast<size_t>(ch)].begin());
+
+            float* channels[CompressorEngine::maxChannels];
+            const auto start = std::chrono::steady_clock::now();
+
+            for (int offset = 0; offset < totalSamples; offset += blockSize)
+            {
+                const auto count = std::min(blockSize, totalSamples - offset);
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                    channels[ch] = work[static_cast<size_t>(ch)].data() + offset;
+
+                processBlock(*engine, mode, channels, numChannels, count);
+            }
+
+            const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+            if (repetition >= 0)
+                timings.push_back(elapsed.count());
+        }
+
+        worker.stop();
+
+        std::sort(timings.begin(), timings.end());
+        const auto median = timings[timings.size() / 2];
+        const auto samples = static_cast<double>(totalSamples) * numChannels;
+
+        Result result;
+        result.mode = mode;
+        result.signal = signal;
+        result.channels = numChannels;
+        result.sampleRate = sampleRate;
+        result.blockSize = blockSize;
+        result.name = mode + "/" + (numChannels == 1 ? "mono" : numChannels == 2 ? "stereo" : std::to_string(numChannels) + "ch")
+                    + "/" + signal + "/" + std::to_string(sampleRate) + "/" + std::to_string(blockSize);
+        result.nsPerSample = median / samples;
+        result.minNsPerSample = timings.front() / samples;
+        result.bytesPerSecond = samples * sizeof(float) / (median * 1e-9);
+        result.realtimeFactor = (static_cast<double>(totalSamples) / sampleRate) / (median * 1e-9);
+        return result;
+    }
+
+    //==============================================================================
+    bool writeJson(const std::string& path, const std::vector<Result>& results)
+    {
+        std::ofstream file(path);
+
+        if (! file)
+            return false;
+
+        file << "{\n  \"benchmark\": \"cumpressor_engine\",\n"
+             << "  \"instructionSet\": \"" << simd::instructionSet << "\",\n"
+             << "  \"results\": [\n";
+
+        char line[512];
+
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const auto& r = results[i];
+            std::snprintf(line, sizeof(line),
+                          "    { \"name\": \"%s\", \"mode\": \"%s\", \"channels\": %d, \"signal\": \"%s\", "
+                          "\"sampleRate\": %d, \"blockSize\": %d, \"nsPerSample\": %.4f, \"minNsPerSample\": %.4f, "
+                          "\"bytesPerSecond\": %.0f, \"realtimeFactor\": %.1f }%s\n",
+                          r.name.c_str(), r.mode.c_str(), r.channels, r.signal.c_str(), r.sampleRate, r.blockSize,
+                          r.nsPerSample, r.minNsPerSample, r.bytesPerSecond, r.realtimeFactor,
+                          i + 1 < results.size() ? "," : "");
+            file << line;
+        }
+
+        file << "  ]\n}\n";
+        return static_cast<bool>(file);
+    }
+
+    // Reads back what writeJson() wrote: name -> nsPerSample. Only the flat
+    // objects inside "results" are looked at, so this is not a general parser.
+    bool readJson(const std::string& path, std::map<std::string, double>& timings)
+    {
+        std::ifstream file(path);
+
+        if (! file)
+            return false;
+
+        const std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        auto position = text.find("\"results\"");
+
+        if (position == std::string::npos)
+            return false;
+
+        auto stringValue = [&](size_t objectStart, size_t objectEnd, const char* key, std::string& value)
+        {
+            const auto keyPosition = text.find(std::string("\"") + key + "\"", objectStart);
+
+            if (keyPosition == std::string::npos || keyPosition > objectEnd)
+                return false;
+
+            const auto open = text.find('"', text.find(':', keyPosition) + 1);
+            const auto close = text.find('"', open + 1);
+
+            if (open == std::string::npos || close == std::string::npos || close > objectEnd)
+                return false;
+
+            value = text.substr(open + 1, close - open - 1);
+            return true;
+        };
+
+        auto numberValue = [&](size_t objectStart, size_t objectEnd, const char* key, double& value)
+        {
+            const auto keyPosition = text.find(std::string("\"") + key + "\"", objectStart);
+
+            if (keyPosition == std::string::npos || keyPosition > objectEnd)
+                return false;
+
+            value = std::strtod(text.c_str() + text.find(':', keyPosition) + 1, nullptr);
+            return true;
+        };
+
+        while ((position = text.find('{', position)) != std::string::npos)
+        {
+            const auto end = text.find('}', position);
+
+            if (end == std::string::npos)
+                break;
+
+            std::string name;
+            double nsPerSample = 0.0;
+
+            if (stringValue(position, end, "name", name) && numberValue(position, end, "nsPerSample", nsPerSample))
+                timings[name] = nsPerSample;
+
+            position = end + 1;
+        }
+
+        return true;
+    }
+
+    // Prints every case side by side and returns the number of regressions
+    // beyond the threshold. Baseline cases the current run did not measure
+    // are listed as missing but are not counted as regressions, so a run
+    // over a narrower set of options can still be checked against a full
+    // baseline.
+    int compare(const std::map<std::string, double>& baseline, const std::map<std::string, double>& current, double threshold)
+    {
+        int regressions = 0, matched = 0, missing = 0;
+
+        std::printf("\n%-44s %12s %12s %9s\n", "case", "baseline", "current", "change");
+
+        for (const auto& [name, nsPerSample] : current)
+        {
+            const auto found = baseline.find(name);
+
+            if (found == baseline.end() || found->second <= 0.0)
+            {
+                std::printf("%-44s %12s %12.3f %9s\n", name.c_str(), "-", nsPerSample, "new");
+                continue;
+            }
+
+            ++matched;
+            const auto change = 100.0 * (nsPerSample - found->second) / found->second;
+            const auto regressed = change > threshold;
+            regressions += regressed ? 1 : 0;
+
+            std::printf("%-44s %12.3f %12.3f %+8.1f%%%s\n", name.c_str(), found->second, nsPerSample, change,
+                        regressed ? "  REGRESSION" : "");
+        }
+
+        for (const auto& [name, nsPerSample] : baseline)
+        {
+            if (current.count(name) != 0)
+                continue;
+
+            ++missing;
+            std::printf("%-44s %12.3f %12s %9s\n", name.c_str(), nsPerSample, "-", "missing");
+        }
+
+        std::printf("\n%d of %d cases slower than +%.1f%%", regressions, matched, threshold);
+
+        if (missing > 0)
+            std::printf(", %d baseline case%s not run", missing, missing == 1 ? "" : "s");
+
+        std::printf("\n");
+        return regressions;
+    }
+}
+
+//==============================================================================
+int main(int argc, char** argv)
+{
+    Options options;
+
+    if (! parseOptions(argc, argv, options))
+        return argc > 1 && std::strcmp(argv[argc - 1], "--help") == 0 ? 0 : 2;
+
+    if (! options.comparePaths.empty())
+    {
+        std::map<std::string, double> baseline, current;
+
+        if (! readJson(options.comparePaths[0], baseline) || ! readJson(options.comparePaths[1], current))
+        {
+            std::printf("could not read %s or %s\n", options.comparePaths[0].c_str(), options.comparePaths[1].c_str());
+            return 2;
+        }
+
+        return compare(baseline, current, options.threshold) == 0 ? 0 : 1;
+    }
+
+    std::printf("instruction set: %s, gain stage: %s\n", simd::instructionSet,
+                kernels::getName(kernels::getGainKernels(options.instructionSet).instructionSet));
+    std::printf("%-44s %10s %10s %12s %10s\n", "case", "ns/sample", "min", "MB/s", "x realtime");
+
+    std::vector<Result> results;
+
+    for (const auto& mode : options.modes)
+        for (auto numChannels : options.channelCounts)
+            for (const auto& signal : options.signals)
+                for (auto sampleRate : options.sampleRates)
+                    for (auto blockSize : options.blockSizes)
+                    {
+                        const auto result = runCase(options, mode, std::clamp(numChannels, 1, CompressorEngine::maxChannels),
+                                                    signal, sampleRate, std::max(blockSize, 1));
+                        std::printf("%-44s %10.3f %10.3f %12.1f %10.1f\n", result.name.c_str(), result.nsPerSample,
+                                    result.minNsPerSample, result.bytesPerSecond / 1e6, result.realtimeFactor);
+                        std::fflush(stdout);
+                        results.push_back(result);
+                    }
+
+    if (! options.jsonPath.empty() && ! writeJson(options.jsonPath, results))
+    {
+        std::printf("could not write %s\n", options.jsonPath.c_str());
+        return 2;
+    }
+
+    if (options.baselinePath.empty())
+        return 0;
+
+    std::map<std::string, double> baseline, current;
+
+    if (! readJson(options.baselinePath, baseline))
+    {
+        std::printf("could not read %s\n", options.baselinePath.c_str());
+        return 2;
+    }
+
+    for (const auto& result : results)
+        current[result.name] = result.nsPerSample;
+
+    return compare(baseline, current, options.threshold) == 0 ? 0 : 1;
+}
@@ -0,0 +1,264 @@
+/*
+  ==============================================================================
+
+    StateBenchmark.cpp
+
+    Session-load cost of the plugin's saved state. Saves a state for each of
+    many instances (distinct values per instance, like a real session), then
+    times restoring them all: state::read() plus matching each entry to its
+    parameter, which is what setStateInformation() does before handing the
+    values to the parameters. Every restored value is checked against what
+    was saved.
+
+    Built against JUCE (CUMPRESSOR_JUCE_DIR set) it also times the previous
+    XML state the same way: parse the text copyXmlToBinary() stored, build
+    the ValueTree replaceState() takes, and read each PARAM child back. The
+    speedup is printed at the end. Without JUCE only the binary chunk is
+    measured.
+
+      cumpressor_state_benchmark [--instances 500] [--repeats 5]
+
+  ==============================================================================
+*/
+
+#include "StateChunk.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#if CUMPRESSOR_STATE_BENCHMARK_XML
+ #include <JuceHeader.h>
+#endif
+
+namespace state = autocomp::state;
+
+namespace
+{
+    // The plugin's parameter IDs (createParameterLayout)
+    const char* const parameterIds[] = { "autoCompress", "mode", "level", "threshold", "ratio", "attack", "release",
+                                         "makeup", "targetLoudness", "lookahead", "oversampling", "bands", "sidechain",
+                                         "detectorHighPass", "linkMode" };
+
+    constexpr int numParameters = static_cast<int>(sizeof(parameterIds) / sizeof(parameterIds[0]));
+
+    struct Options
+    {
+        int instances = 500;
+        int repeats = 5;
+    };
+
+    using Instance = std::vector<float>;    // one value per parameter, in parameterIds order
+
+    std::vector<Instance> makeSession(int numInstances)
+    {
+        std::vector<Instance> session(static_cast<size_t>(numInstances), Instance(numParameters));
+        std::uint32_t seed = 0x5eed1234u;
+
+        for (auto& instance : session)
+            for (auto& value : instance)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                value = -60.0f + 80.0f * static_cast<float>(seed >> 8) / 16777216.0f;
+            }
+
+        return session;
+    }
+
+    // Median of repeats of load(), in ns per instance
+    template <typename Load>
+    double time(const Options& options, Load&& load)
+    {
+        std::vector<double> timings;
+        load();     // warm-up
+
+        for (int repeat = 0; repeat < options.repeats; ++repeat)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            load();
+            const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+            timings.push_back(elapsed.count() / options.instances);
+        }
+
+        std::sort(timings.begin(), timings.end());
+        return timings[timings.size() / 2];
+    }
+
+    //==============================================================================
+    struct BinaryStates
+    {
+        std::vector<std::vector<std::uint8_t>> chunks;
+        std::uint32_t ids[numParameters];
+
+        explicit BinaryStates(const std::vector<Instance>& session)
+        {
+            for (int i = 0; i < numParameters; ++i)
+                ids[i] = state::hashId(parameterIds[i]);
+
+            for (const auto& instance : session)
+            {
+                state::ParameterValue values[numParameters];
+
+                for (int i = 0; i < numParameters; ++i)
+                    values[i] = { ids[i], instance[static_cast<size_t>(i)] };
+
+                chunks.emplace_back(state::getSize(numParameters));
+                state::write(values, numParameters, chunks.back().data(), chunks.back().size());
+            }
+        }
+
+        // Same matching as setStateInformation()
+        bool load(std::vector<Instance>& restored) const
+        {
+            for (size_t instance = 0; instance < chunks.size(); ++instance)
+            {
+                state::ParameterValue values[state::maxParameters];
+                const auto count = state::read(chunks[instance].data(), chunks[instance].size(), values, state::maxParameters);
+
+                if (count < 0)
+                    return false;
+
+                for (int parameter = 0; parameter < numParameters; ++parameter)
+                    for (int i = 0; i < count; ++i)
+                        if (values[i].id == ids[parameter])
+                            restored[instance][static_cast<size_t>(parameter)] = values[i].value;
+            }
+
+            return true;
+        }
+    };
+
+#if CUMPRESSOR_STATE_BENCHMARK_XML
+    //==============================================================================
+    // The state as getStateInformation() used to write it: APVTS XML text
+    struct XmlStates
+    {
+        std::vector<juce::MemoryBlock> blocks;
+
+        explicit XmlStates(const std::vector<Instance>& session)
+        {
+            for (const auto& instance : session)
+            {
+                juce::ValueTree tree("AutoCompressor");
+
+                for (int i = 0; i < numParameters; ++i)
+                {
+                    juce::ValueTree parameter("PARAM");
+                    parameter.setProperty("id", parameterIds[i], nullptr);
+                    parameter.setProperty("value", instance[static_cast<size_t>(i)], nullptr);
+                    tree.appendChild(parameter, nullptr);
+                }
+
+                const auto text = tree.createXml()->toString();
+                blocks.emplace_back(text.toRawUTF8(), text.getNumBytesAsUTF8());
+            }
+        }
+
+        // getXmlFromBinary(), ValueTree::fromXml() and the lookups replaceState() does
+        bool load(std::vector<Instance>& restored) const
+        {
+            for (size_t instance = 0; instance < blocks.size(); ++instance)
+            {
+                const auto& block = blocks[instance];
+                const auto xml = juce::parseXML(juce::String::fromUTF8(static_cast<const char*>(block.getData()),
+                                                                       static_cast<int>(block.getSize())));
+
+                if (xml == nullptr)
+                    return false;
+
+                const auto tree = juce::ValueTree::fromXml(*xml);
+
+                for (int parameter = 0; parameter < numParameters; ++parameter)
+                {
+                    const auto child = tree.getChildWithProperty("id", parameterIds[parameter]);
+                    restored[instance][static_cast<size_t>(parameter)] = static_cast<float>(child.getProperty("value"));
+                }
+            }
+
+            return true;
+        }
+    };
+#endif
+
+    bool matches(const std::vector<Instance>& session, const std::vector<Instance>& restored, float tolerance)
+    {
+        for (size_t instance = 0; instance < session.size(); ++instance)
+            for (size_t i = 0; i < session[instance].size(); ++i)
+                if (std::abs(session[instance][i] - restored[instance][i]) > tolerance)
+                    return false;
+
+        return true;
+    }
+
+    bool parseOptions(int argc, char** argv, Options& options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string argument = argv[i];
+            const auto hasValue = i + 1 < argc;
+
+            if (argument == "--instances" && hasValue)     options.instances = std::max(std::atoi(argv[++i]), 1);
+            else if (argument == "--repeats" && hasValue)  options.repeats = std::max(std::atoi(argv[++i]), 1);
+            else
+            {
+                std::printf("usage: cumpressor_state_benchmark [--instances 500] [--repeats 5]\n");
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+//==============================================================================
+int main(int argc, char** argv)
+{
+    Options options;
+
+    if (! parseOptions(argc, argv, options))
+        return argc > 1 && std::string(argv[argc - 1]) == "--help" ? 0 : 2;
+
+    const auto session = makeSession(options.instances);
+    std::vector<Instance> restored(session.size(), Instance(numParameters));
+
+    std::printf("%d instances, %d parameters each\n", options.instances, numParameters);
+    std::printf("%-8s %14s %16s %16s\n", "format", "bytes/state", "ns/instance", "ms/session");
+
+    const BinaryStates binary(session);
+    auto loaded = true;
+    const auto binaryNs = time(options, [&] { loaded = binary.load(restored) && loaded; });
+
+    if (! loaded || ! matches(session, restored, 0.0f))
+    {
+        std::printf("binary state did not restore the saved values\n");
+        return 1;
+    }
+
+    std::printf("%-8s %14zu %16.1f %16.3f\n", "binary", binary.chunks.front().size(), binaryNs,
+                binaryNs * options.instances * 1e-6);
+
+#if CUMPRESSOR_STATE_BENCHMARK_XML
+    const XmlStates xml(session);
+    const auto xmlNs = time(options, [&] { loaded = xml.load(restored) && loaded; });
+
+    // juce::var keeps doubles; the text round trip may lose the last float bit
+    if (! loaded || ! matches(session, restored, 1e-4f))
+    {
+        std::printf("XML state did not restore the saved values\n");
+        return 1;
+    }
+
+    std::printf("%-8s %14zu %16.1f %16.3f\n", "xml", xml.blocks.front().getSize(), xmlNs,
+                xmlNs * options.instances * 1e-6);
+    std::printf("binary loads %.1fx faster\n", xmlNs / binaryNs);
+#else
+    std::printf("(configure with CUMPRESSOR_JUCE_DIR to compare against the XML state)\n");
+#endif
+
+    return 0;
+}
@@ -0,0 +1,44 @@
+/*
+  ==============================================================================
+
+    AnalysisWorker.cpp
+
+  ==============================================================================
+*/
+
+#include "AnalysisWorker.h"
+#include "CompressorEngine.h"
+
+namespace autocomp
+{
+
+void AnalysisWorker::start()
+{
+    if (isRunning())
+        return;
+
+    shouldExit.store(false);
+    engine.setBackgroundAnalysis(true);
+    thread = std::thread([this] { run(); });
+}
+
+void AnalysisWorker::stop()
+{
+    if (! isRunning())
+        return;
+
+    shouldExit.store(true);
+    thread.join();
+    engine.setBackgroundAnalysis(false);
+}
+
+void AnalysisWorker::run()
+{
+    while (! shouldExit.load())
+    {
+        engine.processPendingAnalysis();
+        std::this_thread::sleep_for(pollInterval);
+    }
+}
+
+} // namespace autocomp
@@ -0,0 +1,56 @@
+/*
+  ==============================================================================
+
+    AnalysisWorker.h
+
+    Background thread that drains a CompressorEngine's analysis FIFO and
+    runs the auto-mode analysis, so the audio thread only copies samples
+    into the FIFO. Results reach the audio thread through the engine's
+    triple buffer.
+
+    start()/stop() must not overlap CompressorEngine::prepare() or reset():
+    stop the worker, prepare the engine, then start it again.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace autocomp
+{
+
+class CompressorEngine;
+
+class AnalysisWorker
+{
+public:
+    // How often the FIFO is drained; well under one analysis block
+    static constexpr std::chrono::milliseconds pollInterval { 5 };
+
+    explicit AnalysisWorker(CompressorEngine& engineToAnalyse) : engine(engineToAnalyse) {}
+    ~AnalysisWorker() { stop(); }
+
+    AnalysisWorker(const AnalysisWorker&) = delete;
+    AnalysisWorker& operator= (const AnalysisWorker&) = delete;
+
+    // Switches the engine to background analysis and starts the thread
+    void start();
+
+    // Joins the thread and hands the analysis back to the audio thread
+    void stop();
+
+    bool isRunning() const noexcept { return thread.joinable(); }
+
+private:
+    void run();
+
+    CompressorEngine& engine;
+    std::thread thread;
+    std::atomic<bool> shouldExit { false };
+};
+
+} // namespace autocomp
@@ -0,0 +1,127 @@
+/*
+  ==============================================================================
+
+    AudioFifo.h
+
+    Lock-free single-producer/single-consumer FIFO of multichannel audio,
+    along the lines of juce::AbstractFifo plus an AudioBuffer. The capacity
+    is a power of two and every push/pop copies at most two contiguous
+    segments per channel. Memory is allocated in prepare() only.
+
+    One thread may call push(), one (other) thread may call pop().
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace autocomp
+{
+
+class AudioFifo
+{
+public:
+    // Not thread safe: call while neither side is running
+    void prepare(int numChannelsToUse, int minimumCapacity)
+    {
+        std::uint32_t newCapacity = 1;
+
+        while (newCapacity < static_cast<std::uint32_t>(std::max(minimumCapacity, 1)))
+            newCapacity <<= 1;
+
+        numChannels = std::max(numChannelsToUse, 1);
+        capacity = newCapacity;
+        storage.assign(static_cast<size_t>(numChannels) * capacity, 0.0f);
+        reset();
+    }
+
+    // Not thread safe: call while neither side is running
+    void reset() noexcept
+    {
+        readIndex.store(0, std::memory_order_relaxed);
+        writeIndex.store(0, std::memory_order_relaxed);
+    }
+
+    int getNumChannels() const noexcept { return numChannels; }
+    int getCapacity() const noexcept    { return static_cast<int>(capacity); }
+
+    int getNumReady() const noexcept
+    {
+        return static_cast<int>(writeIndex.load(std::memory_order_acquire) - readIndex.load(std::memory_order_acquire));
+    }
+
+    // Producer: copies as many frames as fit, returns the number written.
+    // Channels beyond numSourceChannels are filled with silence. Double
+    // input is narrowed on the way in; the consumer always reads float.
+    template <typename SampleType>
+    int push(const SampleType* const* source, int numSourceChannels, int numSamples) noexcept
+    {
+        const auto write = writeIndex.load(std::memory_order_relaxed);
+        const auto read = readIndex.load(std::memory_order_acquire);
+        const auto count = std::min(numSamples, static_cast<int>(capacity - (write - read)));
+
+        forEachSegment(write, count, [&](int position, int offset, int length)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                auto* dest = channel(ch) + position;
+
+                if (ch < numSourceChannels)
+                    std::copy(source[ch] + offset, source[ch] + offset + length, dest);
+                else
+                    std::fill(dest, dest + length, 0.0f);
+            }
+        });
+
+        writeIndex.store(write + static_cast<std::uint32_t>(count), std::memory_order_release);
+        return count;
+    }
+
+    // Consumer: copies up to numSamples frames out, returns the number read
+    int pop(float* const* dest, int numDestChannels, int numSamples) noexcept
+    {
+        const auto read = readIndex.load(std::memory_order_relaxed);
+        const auto write = writeIndex.load(std::memory_order_acquire);
+        const auto count = std::min(numSamples, static_cast<int>(write - read));
+
+        forEachSegment(read, count, [&](int position, int offset, int length)
+        {
+            for (int ch = 0; ch < std::min(numDestChannels, numChannels); ++ch)
+                std::copy(channel(ch) + position, channel(ch) + position + length, dest[ch] + offset);
+        });
+
+        readIndex.store(read + static_cast<std::uint32_t>(count), std::memory_order_release);
+        return count;
+    }
+
+private:
+    float* channel(int index) noexcept { return storage.data() + static_cast<size_t>(index) * capacity; }
+
+    template <typename Function>
+    void forEachSegment(std::uint32_t start, int count, Function&& function) noexcept
+    {
+        const auto position = static_cast<int>(start & (capacity - 1));
+        const auto first = std::min(count, static_cast<int>(capacity) - position);
+
+        if (first > 0)
+            function(position, 0, first);
+
+        if (count > first)
+            function(0, first, count - first);
+    }
+
+    std::vector<float> storage;     // numChannels x capacity
+    int numChannels = 1;
+    std::uint32_t capacity = 1;
+
+    // Free-running frame counters; each on its own cache line
+    alignas(64) std::atomic<std::uint32_t> readIndex { 0 };
+    alignas(64) std::atomic<std::uint32_t> writeIndex { 0 };
+};
+
+} // namespace autocomp
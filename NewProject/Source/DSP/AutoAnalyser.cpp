@@ -0,0 +1,222 @@
+/*
+  ==============================================================================
+
+    AutoAnalyser.cpp
+
+  ==============================================================================
+*/
+
+#include "AutoAnalyser.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace autocomp
+{
+
+AutoAnalyser::AutoAnalyser()
+    : fft(fftOrder),
+      mono(static_cast<size_t>(blockSize), 0.0f),
+      window(static_cast<size_t>(blockSize)),
+      spectrum(static_cast<size_t>(2 * blockSize), 0.0f)
+{
+    const auto twoPi = 6.283185307179586;
+
+    for (int i = 0; i < blockSize; ++i)
+        window[static_cast<size_t>(i)] = static_cast<float>(0.5 - 0.5 * std::cos(twoPi * i / blockSize));
+}
+
+void AutoAnalyser::prepare(double newSampleRate, int numChannels)
+{
+    sampleRate = newSampleRate;
+    rmsDetector.prepare(std::max(static_cast<int>(rmsWindowSeconds * sampleRate), 1));
+    loudnessMeter.prepare(sampleRate, numChannels);
+    reset();
+}
+
+void AutoAnalyser::reset()
+{
+    rmsDetector.reset();
+    loudnessMeter.reset();
+    blockFill = 0;
+    blockPeak = 0.0f;
+    blockSumSquares = 0.0;
+    result = {};
+}
+
+bool AutoAnalyser::process(const float* const* channels, int numChannels, int numSamples)
+{
+    if (numChannels <= 0)
+        return false;
+
+    const float* slice[64];
+    numChannels = std::min(numChannels, 64);
+    const auto scale = 1.0f / static_cast<float>(numChannels);
+    bool completed = false;
+
+    // Split at block boundaries so each result reflects exactly the frames
+    // up to that boundary, whatever sizes the input arrives in
+    for (int offset = 0; offset < numSamples;)
+    {
+        const auto count = std::min(numSamples - offset, blockSize - blockFill);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            slice[ch] = channels[ch] + offset;
+
+        rmsDetector.process(slice, numChannels, count);
+        loudnessMeter.process(slice, numChannels, count);
+
+        for (int i = 0; i < count; ++i)
+        {
+            auto sum = 0.0f;
+            auto squares = 0.0f;
+            auto peak = blockPeak;
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                const auto x = slice[ch][i];
+                sum += x;
+                squares += x * x;
+                peak = std::max(peak, std::abs(x));
+            }
+
+            mono[static_cast<size_t>(blockFill + i)] = sum * scale;
+            blockSumSquares += squares * scale;
+            blockPeak = peak;
+        }
+
+        offset += count;
+        blockFill += count;
+
+        if (blockFill == blockSize)
+        {
+            analyseBlock();
+            completed = true;
+
+            blockFill = 0;
+            blockPeak = 0.0f;
+            blockSumSquares = 0.0;
+        }
+    }
+
+    return completed;
+}
+
+void AutoAnalyser::analyseBlock()
+{
+    constexpr float silence = 1e-5f; // -100 dB
+
+    const auto blockRms = static_cast<float>(std::sqrt(blockSumSquares / blockSize));
+    const auto audible = blockRms > silence;
+
+    result.rms = rmsDetector.getRms();
+    result.crestDb = audible ? 20.0f * std::log10(std::max(blockPeak, silence) / blockRms) : 0.0f;
+    result.tiltDbPerOctave = audible ? measureTilt() : 0.0f;
+    result.loudness = loudnessMeter.getReading();
+    result.tier = presets::findAutoTier(result.loudness.shortTerm);
+    result.settings = adaptToProgram(presets::autoTiers[static_cast<size_t>(result.tier)].settings,
+                                     result.crestDb, result.tiltDbPerOctave);
+
+    // Don't chase the target on silence: keep the tier's makeup below the gate
+    if (! std::isnan(loudnessTarget) && result.loudness.shortTerm > LoudnessMeter::absoluteGate)
+        result.settings.makeupGain = makeupForTarget(result.settings, result.loudness.shortTerm, loudnessTarget);
+}
+
+float AutoAnalyser::measureTilt()
+{
+    for (int i = 0; i < blockSize; ++i)
+        spectrum[static_cast<size_t>(i)] = mono[static_cast<size_t>(i)] * window[static_cast<size_t>(i)];
+
+    fft.performFrequencyOnlyForwardTransform(spectrum.data());
+
+    // Mean power per bin in octave bands from 62.5 Hz up to 16 kHz
+    constexpr int maxBands = 8;
+    double bandPower[maxBands] {};
+    double totalPower = 0.0, inBandPower = 0.0;
+    int numBands = 0;
+
+    const auto binWidth = sampleRate / blockSize;
+
+    for (int k = 1; k <= blockSize / 2; ++k)
+        totalPower += static_cast<double>(spectrum[static_cast<size_t>(k)]) * spectrum[static_cast<size_t>(k)];
+
+    for (int band = 0; band < maxBands; ++band)
+    {
+        const auto low = 62.5 * std::pow(2.0, band);
+        const auto high = 2.0 * low;
+
+        if (high > 0.5 * sampleRate)
+            break;
+
+        const auto first = static_cast<int>(std::ceil(low / binWidth));
+        const auto last = std::min(static_cast<int>(std::ceil(high / binWidth)), blockSize / 2 + 1);
+
+        if (last <= first)
+            break;
+
+        double power = 0.0;
+
+        for (int k = first; k < last; ++k)
+            power += static_cast<double>(spectrum[static_cast<size_t>(k)]) * spectrum[static_cast<size_t>(k)];
+
+        inBandPower += power;
+        bandPower[numBands++] = power / (last - first);
+    }
+
+    // Nothing in the measured range (DC, or only extreme frequencies)
+    if (numBands < 2 || inBandPower <= 1e-6 * totalPower || inBandPower <= 0.0)
+        return 0.0f;
+
+    // Least-squares slope of band level (dB) against octave number
+    const auto floor = 1e-10 * inBandPower;
+    double meanX = 0.0, meanY = 0.0;
+    double levels[maxBands];
+
+    for (int band = 0; band < numBands; ++band)
+    {
+        levels[band] = 10.0 * std::log10(bandPower[band] + floor);
+        meanX += band;
+        meanY += levels[band];
+    }
+
+    meanX /= numBands;
+    meanY /= numBands;
+
+    double covariance = 0.0, variance = 0.0;
+
+    for (int band = 0; band < numBands; ++band)
+    {
+        covariance += (band - meanX) * (levels[band] - meanY);
+        variance += (band - meanX) * (band - meanX);
+    }
+
+    return static_cast<float>(covariance / variance);
+}
+
+CompressorSettings AutoAnalyser::adaptToProgram(const CompressorSettings& tierSettings,
+                                                float crestDb, float tiltDbPerOctave) noexcept
+{
+    auto adapted = tierSettings;
+
+    // Peaky material: slower attack lets the transients through
+    if (crestDb > transientCrestDb)
+        adapted.attack *= std::min(1.0f + (crestDb - transientCrestDb) / transientCrestDb, 2.0f);
+
+    // Bass-heavy material: slower release avoids gain ripple on low frequencies
+    if (tiltDbPerOctave < heavyLowEndTilt)
+        adapted.release *= std::min(1.0f + (heavyLowEndTilt - tiltDbPerOctave) / -heavyLowEndTilt, 2.0f);
+
+    return adapted;
+}
+
+float AutoAnalyser::makeupForTarget(const CompressorSettings& settings, float inputLufs, float targetLufs) noexcept
+{
+    const auto overshoot = std::max(inputLufs - settings.threshold, 0.0f);
+    const auto predictedReduction = overshoot * (1.0f - 1.0f / settings.ratio);
+    const auto makeup = targetLufs - (inputLufs - predictedReduction);
+
+    // 0.1 dB steps, so a steady input doesn't start a new glide every block
+    return std::clamp(std::round(makeup * 10.0f) / 10.0f, 0.0f, maxMakeupGain);
+}
+
+} // namespace autocomp
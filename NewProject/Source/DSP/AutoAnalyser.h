@@ -0,0 +1,101 @@
+/*
+  ==============================================================================
+
+    AutoAnalyser.h
+
+    Auto-mode program analysis. Consumes the captured input in order and,
+    once per analysis block, measures the BS.1770 loudness, the crest factor
+    and the spectral tilt, then picks an auto tier from the short-term
+    loudness, adapts its settings to the material and, with a loudness
+    target set, sets the makeup gain to reach it. Runs on whichever thread
+    drains the engine's analysis FIFO (normally the AnalysisWorker), never
+    on the audio thread unless the engine is in inline mode.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "CompressorPresets.h"
+#include "Fft.h"
+#include "LoudnessMeter.h"
+#include "SlidingRms.h"
+
+#include <limits>
+#include <vector>
+
+namespace autocomp
+{
+
+// One analysis result, published to the audio thread as a whole
+struct AutoAnalysis
+{
+    float rms = 0.0f;                   // linear, sliding window
+    LoudnessReading loudness;
+    float crestDb = 0.0f;               // peak to RMS over the analysis block
+    float tiltDbPerOctave = 0.0f;       // slope of the spectral density, 0 when unknown
+    int tier = 0;
+    CompressorSettings settings = presets::autoTiers[0].settings;
+};
+
+//==============================================================================
+class AutoAnalyser
+{
+public:
+    static constexpr int fftOrder = 12;
+    static constexpr int blockSize = 1 << fftOrder;
+    static constexpr double rmsWindowSeconds = 0.3;
+
+    // Crest factor above which the attack is lengthened to keep transients
+    static constexpr float transientCrestDb = 12.0f;
+    // Spectral tilt below which the release is lengthened against LF ripple
+    static constexpr float heavyLowEndTilt = -6.0f;
+    static constexpr float maxMakeupGain = 24.0f;
+    static constexpr float noLoudnessTarget = std::numeric_limits<float>::quiet_NaN();
+
+    AutoAnalyser();
+
+    void prepare(double newSampleRate, int numChannels);
+    void reset();
+
+    // Target for the auto-mode makeup gain, or noLoudnessTarget to keep the
+    // tier's own makeup
+    void setLoudnessTarget(float lufs) noexcept { loudnessTarget = lufs; }
+
+    LoudnessMeter& getLoudnessMeter() noexcept { return loudnessMeter; }
+
+    // Feeds frames in order; returns true if at least one analysis block
+    // completed, with the newest result in getResult()
+    bool process(const float* const* channels, int numChannels, int numSamples);
+
+    const AutoAnalysis& getResult() const noexcept { return result; }
+
+    // Tier settings adjusted for peaky or bass-heavy material
+    static CompressorSettings adaptToProgram(const CompressorSettings& tierSettings,
+                                             float crestDb, float tiltDbPerOctave) noexcept;
+
+    // Makeup that brings the input loudness, less the gain reduction the
+    // settings' static curve predicts at that loudness, to the target
+    static float makeupForTarget(const CompressorSettings& settings, float inputLufs, float targetLufs) noexcept;
+
+private:
+    void analyseBlock();
+    float measureTilt();
+
+    Fft fft;
+    SlidingRms rmsDetector;
+    LoudnessMeter loudnessMeter;
+    double sampleRate = 44100.0;
+    float loudnessTarget = noLoudnessTarget;
+
+    std::vector<float> mono;            // channel average over the block
+    std::vector<float> window;          // Hann
+    std::vector<float> spectrum;        // 2 * blockSize, FFT work area
+    int blockFill = 0;
+    float blockPeak = 0.0f;
+    double blockSumSquares = 0.0;
+
+    AutoAnalysis result;
+};
+
+} // namespace autocomp
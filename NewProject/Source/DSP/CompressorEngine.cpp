@@ -0,0 +1,1012 @@
+/*
+  ==============================================================================
+
+    CompressorEngine.cpp
+
+  ==============================================================================
+*/
+
+#include "CompressorEngine.h"
+#include "FastMath.h"
+#include "SimdKernels.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace autocomp
+{
+
+float CompressorEngine::dbToLinear(float db)
+{
+    return std::pow(10.0f, db / 20.0f);
+}
+
+float CompressorEngine::linearToDb(float linear)
+{
+    return 20.0f * std::log10(std::max(linear, 1e-6f));
+}
+
+//==============================================================================
+void CompressorEngine::prepare(double newSampleRate, int newMaximumBlockSize, int numChannels, bool useDoublePrecision)
+{
+    sampleRate = newSampleRate;
+    maximumBlockSize = std::max(newMaximumBlockSize, 1);
+    numPreparedChannels = std::clamp(numChannels, 1, maxChannels);
+    doublePrecision = useDoublePrecision;
+
+    // Scratch and lookahead sized for the highest oversampling factor, so
+    // switching the factor later never allocates
+    blockCapacity = maximumBlockSize * maxOversamplingFactor;
+    gainBuffer.assign(static_cast<size_t>(numPreparedChannels * blockCapacity), 1.0f);
+    unityGain.assign(static_cast<size_t>(blockCapacity), 1.0f);
+    rampBuffer.assign(static_cast<size_t>(numRamps * blockCapacity), 0.0f);
+
+    maxLookaheadSamples = static_cast<int>(std::ceil(maxLookaheadMs * 0.001 * sampleRate)) * maxOversamplingFactor;
+    multiband.prepare(numPreparedChannels, blockCapacity, maxLookaheadSamples, doublePrecision);
+
+    // The precision not in use keeps minimal buffers
+    auto preparePath = [this](auto& path, bool used)
+    {
+        path.oversampler.prepare(used ? numPreparedChannels : 1, used ? maximumBlockSize : 1);
+        path.sidechainOversampler.prepare(used ? numPreparedChannels : 1, used ? maximumBlockSize : 1);
+        path.delayBuffer.assign(used ? static_cast<size_t>(numPreparedChannels * maxLookaheadSamples) : 0, 0);
+        path.dryBuffer.assign(used ? static_cast<size_t>(numPreparedChannels * blockCapacity) : 0, 0);
+        path.keyBuffer.assign(used ? static_cast<size_t>(maximumBlockSize) : 0, 0);
+    };
+
+    preparePath(singlePath, ! doublePrecision);
+    preparePath(doublePath, doublePrecision);
+    lookaheadPeaks.resize(static_cast<size_t>(numPreparedChannels));
+
+    for (auto& peak : lookaheadPeaks)
+        peak.prepare(maxLookaheadSamples + 1);
+
+    updateRateDependentState();
+
+    // Room for a few analysis blocks, so the worker can fall behind briefly
+    analysisFifo.prepare(numPreparedChannels, std::max(4 * analysisBufferSize, 2 * maximumBlockSize));
+    analysisScratch.assign(static_cast<size_t>(numPreparedChannels * analysisBufferSize), 0.0f);
+    analyser.prepare(sampleRate, numPreparedChannels);
+    analysisChannels.store(numPreparedChannels, std::memory_order_relaxed);
+
+    reset();
+}
+
+void CompressorEngine::updateRateDependentState() noexcept
+{
+    // Everything below runs at the processing rate: sampleRate * factor
+    const auto rampLength = static_cast<int>(smoothingTimeSeconds * getProcessingRate());
+
+    for (auto* parameter : { &thresholdLog2, &slope, &attackCoeff, &releaseCoeff, &makeupLinear })
+        parameter->reset(rampLength);
+
+    multiband.setProcessingRate(getProcessingRate(), rampLength);
+    wetMix.reset(static_cast<int>(bypassFadeSeconds * getProcessingRate()));
+    detectorFilter.setCutoff(detectorHighPassHz, getProcessingRate());
+    detectorFilter.reset();
+
+    for (size_t i = 0; i < levelCoefficients.size(); ++i)
+        levelCoefficients[i] = deriveCoefficients(presets::compressionLevels[i]);
+
+    for (size_t i = 0; i < tierCoefficients.size(); ++i)
+        tierCoefficients[i] = deriveCoefficients(presets::autoTiers[i].settings);
+
+    updateCompressorCoefficients();
+
+    lookaheadSamples = -1; // force setLookahead() to re-apply
+    setLookahead(lookaheadMs);
+}
+
+void CompressorEngine::setDetectorHighPass(float hz) noexcept
+{
+    hz = std::max(hz, 0.0f);
+
+    if (hz == detectorHighPassHz)
+        return;
+
+    // Switching on starts from silence; moving the cutoff keeps the state
+    if (! detectorFilter.isActive())
+        detectorFilter.reset();
+
+    detectorHighPassHz = hz;
+    detectorFilter.setCutoff(hz, getProcessingRate());
+}
+
+bool CompressorEngine::setOversamplingFactor(int factor) noexcept
+{
+    if (! singlePath.oversampler.setFactor(factor))
+        return false;
+
+    singlePath.sidechainOversampler.setFactor(factor);
+    doublePath.oversampler.setFactor(factor);
+    doublePath.sidechainOversampler.setFactor(factor);
+
+    // New coefficients and ramps for the new rate; the gain jumps once, the
+    // same as any latency change does
+    updateRateDependentState();
+    return true;
+}
+
+int CompressorEngine::getLatencySamples() const noexcept
+{
+    return lookaheadBaseSamples + static_cast<int>(std::lround(singlePath.oversampler.getLatencyInSamples()));
+}
+
+int CompressorEngine::getTailSamples() const noexcept
+{
+    // Linear-phase filters ring for as long again after their delay
+    const auto filters = static_cast<int>(std::ceil(2.0 * singlePath.oversampler.getLatencyInSamples()));
+    const auto ringOut = getNumBands() > 1 ? static_cast<int>(std::ceil(crossoverRingOutSeconds * sampleRate)) : 0;
+
+    return lookaheadBaseSamples + filters + ringOut;
+}
+
+void CompressorEngine::reset()
+{
+    updateCompressorCoefficients();
+    multiband.reset();
+    detectorFilter.reset();
+
+    analysisFifo.reset();
+    analyser.reset();
+    analysisResults.write({});
+    loudnessReadings.write({});
+    latestAnalysis = {};
+    needsAnalysis = true;
+    analysisSilentSamples = 0;
+
+    clearAudioPaths();
+
+    for (auto& peak : lookaheadPeaks)
+        peak.reset();
+
+    envelopes.fill(1.0); // unity gain: no fade-in after prepare/reset
+    currentRMS = 0.0f;
+    autoTier = -1;
+
+    wetMix.setCurrentAndTargetValue(bypassed ? 0.0f : 1.0f);
+    silentSamples = 0;
+    idle = false;
+}
+
+void CompressorEngine::clearAudioPaths() noexcept
+{
+    singlePath.oversampler.reset();
+    singlePath.sidechainOversampler.reset();
+    doublePath.oversampler.reset();
+    doublePath.sidechainOversampler.reset();
+    clearDelayLines();
+}
+
+void CompressorEngine::clearDelayLines() noexcept
+{
+    std::fill(singlePath.delayBuffer.begin(), singlePath.delayBuffer.end(), 0.0f);
+    std::fill(doublePath.delayBuffer.begin(), doublePath.delayBuffer.end(), 0.0);
+    delayPosition = 0;
+}
+
+template <typename SampleType>
+void CompressorEngine::processBlock(SampleType* const* channels, int numChannels, int numSamples)
+{
+    // 1-2. Measure the input level, re-tier when due
+    updateAutoParameters(channels, numChannels, numSamples);
+
+    // 3. Compress all channels together
+    compress(channels, numChannels, numSamples);
+}
+
+template <typename SampleType>
+void CompressorEngine::updateAutoParameters(const SampleType* const* channels, int numChannels, int numSamples)
+{
+    analyzeAudioLevel(channels, numChannels, numSamples);
+    applyAutoParameters();
+}
+
+void CompressorEngine::applyAutoParameters()
+{
+    // Re-tier once a new analysis result has arrived
+    if (needsAnalysis)
+    {
+        calculateAutoParameters();
+        needsAnalysis = false;
+    }
+}
+
+template <typename SampleType>
+void CompressorEngine::compress(SampleType* const* channels, int numChannels, int numSamples)
+{
+    compress(channels, numChannels, numSamples, channels, numChannels);
+}
+
+template <typename SampleType>
+void CompressorEngine::compress(SampleType* const* channels, int numChannels, int numSamples,
+                                const SampleType* const* detectorChannels, int numDetectorChannels)
+{
+    assert((std::is_same_v<SampleType, double>) == doublePrecision);
+
+    // Fully bypassed: only the delay path runs
+    if (bypassed && ! wetMix.isSmoothing())
+    {
+        bypass(channels, numChannels, numSamples);
+        return;
+    }
+
+    auto& path = getAudioPath<SampleType>();
+    SampleType* slice[maxChannels];
+    const SampleType* detectorSlice[maxChannels];
+    const SampleType* detectorSources[maxChannels];
+    const SampleType* repeatedKey[maxChannels];
+
+    numChannels = std::min(numChannels, maxChannels);
+
+    // Decided once per call: the audio itself, or an external input. Either
+    // way the same kernels run over whatever the pointers address.
+    const auto external = numDetectorChannels > 0 && static_cast<const void*>(detectorChannels) != channels;
+    const auto numSources = external ? std::min(numDetectorChannels, numPreparedChannels) : 0;
+
+    // Unlinked or grouped needs a detector input per audio channel. A key
+    // narrower than the audio is summed to mono (a mono key is used as it
+    // is), so no channel or group is keyed from just one side of it.
+    const auto foldKey = external && stereoLink != StereoLink::linked && numSources > 1 && numSources < numChannels;
+
+    if (external)
+    {
+        numDetectorChannels = stereoLink == StereoLink::linked ? numSources : numChannels;
+
+        for (int channel = 0; channel < numDetectorChannels; ++channel)
+            detectorSources[channel] = detectorChannels[std::min(channel, numSources - 1)];
+    }
+
+    // The folded key is one channel, read by every detector
+    auto detectorInputs = [&](const SampleType* const* key) -> const SampleType* const*
+    {
+        if (! foldKey)
+            return key;
+
+        std::fill(repeatedKey, repeatedKey + numDetectorChannels, key[0]);
+        return repeatedKey;
+    };
+
+    // Metering reads each slice just before and after it is processed, while
+    // it is still in cache
+    const auto measure = isMetering();
+    BlockLevels levels;
+
+    // Silence in, silence out: once the path has flushed, processing would
+    // only release the envelopes, which takes one step per group
+    auto silent = simd::isSilent(channels, numChannels, numSamples);
+
+    if (silent && external)
+        silent = simd::isSilent(detectorChannels, numSources, numSamples);
+
+    idle = countSilence(silent, numSamples) && isSettled();
+
+    if (idle)
+    {
+        releaseEnvelopes(numSamples * getOversamplingFactor());
+
+        if (measure)
+            levelMeter.publish(levels, numChannels * numSamples, getGainReductionDb());
+
+        return;
+    }
+
+    for (int offset = 0; offset < numSamples; offset += maximumBlockSize)
+    {
+        const auto count = std::min(maximumBlockSize, numSamples - offset);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            slice[channel] = channels[channel] + offset;
+
+        if (foldKey)
+        {
+            auto* mono = path.keyBuffer.data();
+            const auto scale = static_cast<SampleType>(1) / static_cast<SampleType>(numSources);
+            std::copy(detectorChannels[0] + offset, detectorChannels[0] + offset + count, mono);
+
+            for (int channel = 1; channel < numSources; ++channel)
+                for (int i = 0; i < count; ++i)
+                    mono[i] += detectorChannels[channel][offset + i];
+
+            for (int i = 0; i < count; ++i)
+                mono[i] *= scale;
+
+            detectorSlice[0] = mono;
+        }
+        else if (external)
+        {
+            for (int channel = 0; channel < numDetectorChannels; ++channel)
+                detectorSlice[channel] = detectorSources[channel] + offset;
+        }
+
+        if (measure)
+            levels.addInput(slice, numChannels, count);
+
+        if (getOversamplingFactor() == 1)
+        {
+            if (external)
+                compressSlice(slice, numChannels, detectorInputs(detectorSlice), numDetectorChannels, count);
+            else
+                compressSlice(slice, numChannels, slice, numChannels, count);
+        }
+        else
+        {
+            // Detector, gain and lookahead at the oversampled rate, so fast
+            // gain changes don't alias and inter-sample peaks are seen
+            const auto oversampledCount = count * getOversamplingFactor();
+            auto* const* oversampled = path.oversampler.upsample(slice, numChannels, count);
+
+            if (external)
+                compressSlice(oversampled, numChannels,
+                              detectorInputs(path.sidechainOversampler.upsample(detectorSlice, foldKey ? 1 : numDetectorChannels, count)),
+                              numDetectorChannels, oversampledCount);
+            else
+                compressSlice(oversampled, numChannels, oversampled, numChannels, oversampledCount);
+
+            path.oversampler.downsample(slice, numChannels, count);
+        }
+
+        if (measure)
+            levels.addOutput(slice, numChannels, count);
+    }
+
+    if (measure)
+        levelMeter.publish(levels, numChannels * numSamples, getGainReductionDb());
+}
+
+template <typename SampleType>
+void CompressorEngine::compressSlice(SampleType* const* channels, int numChannels,
+                                     const SampleType* const* detectorChannels, int numDetectorChannels, int numSamples)
+{
+    const auto broadband = getNumBands() == 1;
+
+    // Lookahead: the detector sees its input before delayAudio() moves the audio
+    if (broadband)
+        computeGainCurve(detectorChannels, numDetectorChannels, numSamples);
+    else
+        multiband.computeGains(detectorChannels, numDetectorChannels, numSamples, linkGroups);
+
+    delayAudio(channels, numChannels, numSamples);
+
+    // Bypass fade: the delayed audio is exactly what bypass() outputs, so
+    // keep it to mix back in. Once faded out the mix stays at 0 until the
+    // next call takes the bypass path.
+    const auto mixing = bypassed || wetMix.isSmoothing();
+    auto* dry = getAudioPath<SampleType>().dryBuffer.data();
+
+    if (mixing)
+        for (int channel = 0; channel < numChannels; ++channel)
+            std::copy(channels[channel], channels[channel] + numSamples, dry + channel * blockCapacity);
+
+    if (broadband)
+        applyGainCurve(channels, numChannels, numSamples);
+    else
+        multiband.applyGains(channels, numChannels, numSamples, linkGroups,
+                             static_cast<const void*>(detectorChannels) == channels);
+
+    if (mixing)
+    {
+        auto* mix = getRamp(mixRamp);
+        wetMix.fill(mix, numSamples);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* wet = channels[channel];
+            const auto* source = dry + channel * blockCapacity;
+
+            for (int i = 0; i < numSamples; ++i)
+                wet[i] = source[i] + static_cast<SampleType>(mix[i]) * (wet[i] - source[i]);
+        }
+    }
+}
+
+template <typename SampleType>
+void CompressorEngine::bypass(SampleType* const* channels, int numChannels, int numSamples)
+{
+    assert((std::is_same_v<SampleType, double>) == doublePrecision);
+
+    auto& path = getAudioPath<SampleType>();
+    SampleType* slice[maxChannels];
+    numChannels = std::min(numChannels, maxChannels);
+
+    const auto measure = isMetering();
+    BlockLevels levels;
+
+    // Nothing but zeros left in the delay path: the output is the input
+    idle = countSilence(simd::isSilent(channels, numChannels, numSamples), numSamples);
+
+    if (idle)
+    {
+        if (measure)
+            levelMeter.publish(levels, numChannels * numSamples, 0.0f);
+
+        return;
+    }
+
+    for (int offset = 0; offset < numSamples; offset += maximumBlockSize)
+    {
+        const auto count = std::min(maximumBlockSize, numSamples - offset);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            slice[channel] = channels[channel] + offset;
+
+        if (getOversamplingFactor() == 1)
+        {
+            delayAudio(slice, numChannels, count);
+        }
+        else
+        {
+            auto* const* oversampled = path.oversampler.upsample(slice, numChannels, count);
+            delayAudio(oversampled, numChannels, count * getOversamplingFactor());
+            path.oversampler.downsample(slice, numChannels, count);
+        }
+
+        // Output is the (delayed) input, so one measurement serves for both
+        if (measure)
+            levels.addOutput(slice, numChannels, count);
+    }
+
+    if (measure)
+    {
+        levels.inputPeak = levels.outputPeak;
+        levels.inputSquares = levels.outputSquares;
+        levelMeter.publish(levels, numChannels * numSamples, 0.0f);
+    }
+}
+
+template <typename SampleType>
+void CompressorEngine::computeGainCurve(const SampleType* const* channels, int numChannels, int numSamples)
+{
+    assert(numSamples <= maximumBlockSize * getOversamplingFactor());
+    numChannels = std::min(numChannels, numPreparedChannels);
+
+    // The gain stage variant for this block: while parameters glide, their
+    // per-sample values are written out once and shared by all groups;
+    // otherwise the steady variants skip the ramps (and the makeup multiply
+    // at 0 dB)
+    const bool gliding = isSmoothing();
+
+    if (gliding)
+    {
+        thresholdLog2.fill(getRamp(thresholdRamp), numSamples);
+        slope.fill(getRamp(slopeRamp), numSamples);
+        attackCoeff.fill(getRamp(attackRamp), numSamples);
+        releaseCoeff.fill(getRamp(releaseRamp), numSamples);
+        makeupLinear.fill(getRamp(makeupRamp), numSamples);
+    }
+
+    kernels::GainStage stage;
+    stage.thresholdLog2 = thresholdLog2.getTargetValue();
+    stage.slope = slope.getTargetValue();
+    stage.attack = attackCoeff.getTargetValue();
+    stage.release = releaseCoeff.getTargetValue();
+    stage.makeup = makeupLinear.getTargetValue();
+    stage.thresholds = getRamp(thresholdRamp);
+    stage.slopes = getRamp(slopeRamp);
+    stage.attacks = getRamp(attackRamp);
+    stage.releases = getRamp(releaseRamp);
+    stage.makeups = getRamp(makeupRamp);
+
+    const auto gainStage = gainKernels->get(gliding, gliding || stage.makeup != 1.0);
+
+    // One detector per link group: the loudest member, every member read
+    // once per SIMD vector of frames (a 12-channel bed is one pass, not 12)
+    int members[maxChannels];
+    const SampleType* memberChannels[maxChannels];
+
+    for (int group = 0; group < linkGroups.getNumGroups(); ++group)
+    {
+        const auto count = linkGroups.getMembers(group, numChannels, members);
+
+        if (count == 0)
+            continue;
+
+        auto* gains = gainBuffer.data() + group * blockCapacity;
+
+        if (detectorFilter.isActive())
+        {
+            detectorFilter.processLevels(channels, members, count, gains, numSamples);
+        }
+        else
+        {
+            for (int i = 0; i < count; ++i)
+                memberChannels[i] = channels[members[i]];
+
+            simd::absMaxAcrossChannels(memberChannels, count, 0, gains, numSamples);
+        }
+
+        if (lookaheadSamples > 0)
+            lookaheadPeaks[static_cast<size_t>(group)].process(gains, gains, numSamples);
+
+        gainStage(gains, numSamples, envelopes[static_cast<size_t>(group)], stage);
+    }
+}
+
+const float* CompressorEngine::getGainCurve(int channel) const noexcept
+{
+    const auto group = linkGroups.getGroup(std::clamp(channel, 0, numPreparedChannels - 1));
+
+    if (group == LinkGroups::excluded)
+        return unityGain.data();
+
+    return gainBuffer.data() + group * blockCapacity;
+}
+
+void CompressorEngine::setStereoLink(StereoLink newLink) noexcept
+{
+    if (newLink == stereoLink)
+        return;
+
+    if (newLink == StereoLink::linked)
+        setLinkGroups(LinkGroups::linked());
+    else if (newLink == StereoLink::unlinked)
+        setLinkGroups(LinkGroups::unlinked());
+
+    if (newLink != StereoLink::grouped)
+        stereoLink = newLink;
+}
+
+void CompressorEngine::setLinkGroups(const LinkGroups& newGroups) noexcept
+{
+    stereoLink = StereoLink::grouped;
+
+    if (newGroups == linkGroups)
+        return;
+
+    // Envelopes and peak windows belong to groups, which now mean other channels
+    linkGroups = newGroups;
+    restartDetectors();
+}
+
+void CompressorEngine::restartDetectors() noexcept
+{
+    envelopes.fill(1.0);
+
+    for (auto& peak : lookaheadPeaks)
+        peak.reset();
+
+    multiband.reset();
+}
+
+void CompressorEngine::setBypassed(bool shouldBypass) noexcept
+{
+    if (shouldBypass == bypassed)
+        return;
+
+    // Coming back from a finished fade-out: the detectors stopped with the
+    // old audio, so start them from unity as after a reset
+    if (! shouldBypass && ! wetMix.isSmoothing())
+        restartDetectors();
+
+    bypassed = shouldBypass;
+    wetMix.setTargetValue(bypassed ? 0.0f : 1.0f);
+}
+
+// Counts silent frames in a row. True if this block is silent and so was
+// everything still in the audio path (the whole tail) before it.
+bool CompressorEngine::countSilence(bool silent, int numSamples) noexcept
+{
+    if (! silent)
+    {
+        silentSamples = 0;
+        return false;
+    }
+
+    const auto flushed = silentSamples >= getTailSamples();
+
+    if (! flushed)
+        silentSamples += numSamples;
+
+    return flushed;
+}
+
+// Nothing gliding or fading: the coefficients stay put over a skipped block
+bool CompressorEngine::isSettled() const noexcept
+{
+    return ! (isSmoothing() || multiband.isSmoothing() || wetMix.isSmoothing());
+}
+
+// A silent block only releases the envelopes (the target is unity):
+// env = 1 - (1 - env) * release^n, numSamples at the processing rate
+void CompressorEngine::releaseEnvelopes(int numSamples) noexcept
+{
+    if (getNumBands() > 1)
+    {
+        multiband.release(numSamples);
+        return;
+    }
+
+    const auto decay = std::pow(static_cast<double>(releaseCoeff.getTargetValue()), numSamples);
+
+    for (auto& envelope : envelopes)
+        envelope = 1.0 - (1.0 - envelope) * decay;
+}
+
+template <typename SampleType>
+void CompressorEngine::delayAudio(SampleType* const* channels, int numChannels, int numSamples) noexcept
+{
+    if (lookaheadSamples <= 0)
+        return;
+
+    auto& delayBuffer = getAudioPath<SampleType>().delayBuffer;
+
+    // Swapping the block with the ring delays it by exactly the ring length:
+    // each sample takes the oldest stored value and leaves itself behind.
+    // Done in at most two contiguous segments per ring pass.
+    auto position = delayPosition;
+
+    for (int channel = 0; channel < std::min(numChannels, numPreparedChannels); ++channel)
+    {
+        auto* ring = delayBuffer.data() + channel * maxLookaheadSamples;
+        auto* data = channels[channel];
+        position = delayPosition;
+
+        for (int done = 0; done < numSamples;)
+        {
+            const auto segment = std::min(numSamples - done, lookaheadSamples - position);
+            std::swap_ranges(data + done, data + done + segment, ring + position);
+
+            done += segment;
+            position += segment;
+
+            if (position == lookaheadSamples)
+                position = 0;
+        }
+    }
+
+    delayPosition = position;
+}
+
+bool CompressorEngine::setLookahead(float milliseconds) noexcept
+{
+    lookaheadMs = std::clamp(milliseconds, 0.0f, maxLookaheadMs);
+
+    // Whole base-rate samples, so the latency stays an integer when oversampled
+    const auto newBaseSamples = std::min(static_cast<int>(std::lround(lookaheadMs * 0.001 * sampleRate)),
+                                         maxLookaheadSamples / maxOversamplingFactor);
+    const auto newSamples = newBaseSamples * getOversamplingFactor();
+
+    if (newSamples == lookaheadSamples)
+        return false;
+
+    const auto latencyChanged = newBaseSamples != lookaheadBaseSamples;
+    lookaheadBaseSamples = newBaseSamples;
+    lookaheadSamples = newSamples;
+
+    // Window covers the delayed sample and everything up to the newest input
+    for (auto& peak : lookaheadPeaks)
+        peak.setWindowLength(lookaheadSamples + 1);
+
+    multiband.setLookahead(lookaheadSamples);
+    clearDelayLines();
+    return latencyChanged;
+}
+
+template <typename SampleType>
+void CompressorEngine::applyGainCurve(SampleType* const* channels, int numChannels, int numSamples) const noexcept
+{
+    for (int channel = 0; channel < std::min(numChannels, numPreparedChannels); ++channel)
+        if (linkGroups.getGroup(channel) != LinkGroups::excluded)
+            simd::multiply(channels[channel], getGainCurve(channel), numSamples);
+}
+
+//==============================================================================
+void CompressorEngine::setSettings(const CompressorSettings& newSettings)
+{
+    settings = newSettings;
+    updateCompressorCoefficients();
+}
+
+void CompressorEngine::setTargetSettings(const CompressorSettings& newSettings)
+{
+    if (newSettings == settings)
+        return;
+
+    settings = newSettings;
+    updateCompressorCoefficients(true);
+}
+
+void CompressorEngine::setCompressionLevel(int level)
+{
+    if (level >= 0 && level < numCompressionLevels)
+        selectPreset(presets::compressionLevels[static_cast<size_t>(level)],
+                     levelCoefficients[static_cast<size_t>(level)], false);
+}
+
+void CompressorEngine::setTargetCompressionLevel(int level)
+{
+    if (level >= 0 && level < numCompressionLevels)
+        selectPreset(presets::compressionLevels[static_cast<size_t>(level)],
+                     levelCoefficients[static_cast<size_t>(level)], true);
+}
+
+bool CompressorEngine::getCompressionLevelSettings(int level, CompressorSettings& result) noexcept
+{
+    if (level < 0 || level >= numCompressionLevels)
+        return false;
+
+    result = presets::compressionLevels[static_cast<size_t>(level)];
+    return true;
+}
+
+void CompressorEngine::requestCompressionLevel(int level) noexcept
+{
+    CompressorSettings levelSettings;
+
+    if (getCompressionLevelSettings(level, levelSettings))
+        requestSettings(levelSettings);
+}
+
+void CompressorEngine::beginBlock()
+{
+    CompressorSettings requested;
+
+    if (pendingSettings.read(requested))
+        setTargetSettings(requested);
+}
+
+//==============================================================================
+template <typename SampleType>
+void CompressorEngine::analyzeAudioLevel(const SampleType* const* channels, int numChannels, int numSamples)
+{
+    if (numChannels <= 0 || numSamples <= 0)
+        return;
+
+    numChannels = std::min(numChannels, numPreparedChannels);
+
+    // Long silence: the analysis already reads silence everywhere
+    const auto silenceLimit = static_cast<int>(analysisSilenceSeconds * sampleRate);
+
+    if (! simd::isSilent(channels, numChannels, numSamples))
+        analysisSilentSamples = 0;
+    else if (analysisSilentSamples >= silenceLimit)
+        return;
+    else
+        analysisSilentSamples += numSamples;
+
+    // The FIFO zero-fills the channels beyond these; the analyser must not
+    // average them in
+    analysisChannels.store(numChannels, std::memory_order_relaxed);
+
+    if (backgroundAnalysis.load(std::memory_order_relaxed))
+    {
+        // Frames that don't fit are dropped; the worker catches up later
+        analysisFifo.push(channels, numChannels, numSamples);
+    }
+    else
+    {
+        const SampleType* slice[maxChannels];
+
+        for (int offset = 0; offset < numSamples;)
+        {
+            for (int channel = 0; channel < numChannels; ++channel)
+                slice[channel] = channels[channel] + offset;
+
+            offset += analysisFifo.push(slice, numChannels, numSamples - offset);
+            processPendingAnalysis();
+        }
+    }
+
+    // A new result re-tiers the settings in updateAutoParameters()
+    if (analysisResults.read(latestAnalysis))
+    {
+        currentRMS = latestAnalysis.rms;
+        needsAnalysis = true;
+    }
+}
+
+bool CompressorEngine::processPendingAnalysis()
+{
+    float* scratch[maxChannels];
+    const auto numChannels = analysisFifo.getNumChannels();
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        scratch[channel] = analysisScratch.data() + channel * analysisBufferSize;
+
+    if (integratedResetPending.exchange(false))
+        analyser.getLoudnessMeter().resetIntegrated();
+
+    analyser.setLoudnessTarget(loudnessTarget.load());
+
+    bool drained = false, published = false;
+
+    while (const auto count = analysisFifo.pop(scratch, numChannels, analysisBufferSize))
+    {
+        drained = true;
+
+        // Read after the pop, which synchronises with the push that stored it
+        const auto numPushed = std::min(analysisChannels.load(std::memory_order_relaxed), numChannels);
+
+        if (analyser.process(scratch, numPushed, count))
+        {
+            analysisResults.write(analyser.getResult());
+            published = true;
+        }
+    }
+
+    if (drained)
+        loudnessReadings.write(analyser.getLoudnessMeter().getReading());
+
+    return published;
+}
+
+void CompressorEngine::calculateAutoParameters()
+{
+    const auto tier = latestAnalysis.tier;
+    const auto& adapted = latestAnalysis.settings;
+    const auto& tierSettings = presets::autoTiers[static_cast<size_t>(tier)].settings;
+
+    // Unadapted tiers come from the table; adapted ones are derived here,
+    // once per analysis block. Same settings as before: no new glide.
+    autoTier = tier;
+    selectPreset(adapted, adapted == tierSettings ? tierCoefficients[static_cast<size_t>(tier)]
+                                                  : deriveCoefficients(adapted), true);
+}
+
+void CompressorEngine::updateCompressorCoefficients(bool smooth)
+{
+    applyCoefficients(deriveCoefficients(settings), smooth);
+}
+
+CompressorEngine::Coefficients CompressorEngine::deriveCoefficients(const CompressorSettings& source) const noexcept
+{
+    // Gain computer constants in the log2 domain, so the per-sample path
+    // needs one log2 and one exp2 and nothing else
+    return { source.threshold * fastmath::log2PerDb,
+             1.0f / source.ratio - 1.0f,
+             timeToCoefficient(source.attack),
+             timeToCoefficient(source.release),
+             fastmath::fastDbToLinear(source.makeupGain) };
+}
+
+void CompressorEngine::applyCoefficients(const Coefficients& coefficients, bool smooth) noexcept
+{
+    auto update = [smooth](SmoothedParameter& parameter, float value)
+    {
+        if (smooth)
+            parameter.setTargetValue(value);
+        else
+            parameter.setCurrentAndTargetValue(value);
+    };
+
+    update(thresholdLog2, coefficients.thresholdLog2);
+    update(slope, coefficients.slope);
+    update(attackCoeff, coefficients.attack);
+    update(releaseCoeff, coefficients.release);
+    update(makeupLinear, coefficients.makeup);
+
+    if (getNumBands() > 1)
+        updateBandParameters(smooth);
+
+    // Let other threads see what is now in use (manual or auto)
+    activeSettings.write(settings);
+}
+
+bool CompressorEngine::setNumBands(int numBands) noexcept
+{
+    if (numBands == getNumBands())
+        return false;
+
+    const auto* layout = presets::findBandLayout(numBands);
+
+    if (numBands != 1 && layout == nullptr)
+        return false;
+
+    multiband.setLayout(numBands, layout != nullptr ? layout->crossovers.data() : nullptr);
+    updateBandParameters(false);
+    return true;
+}
+
+void CompressorEngine::updateBandParameters(bool smooth) noexcept
+{
+    const auto* layout = presets::findBandLayout(getNumBands());
+
+    if (layout == nullptr)
+        return;
+
+    // The broadband settings with the layout's time scaling, derived per
+    // band and laid out one lane per band
+    BandParameters parameters;
+
+    for (size_t band = 0; band < static_cast<size_t>(layout->numBands); ++band)
+    {
+        auto bandSettings = settings;
+        bandSettings.attack *= layout->timeScale[band];
+        bandSettings.release *= layout->timeScale[band];
+
+        const auto coefficients = deriveCoefficients(bandSettings);
+        parameters.thresholdLog2[band] = coefficients.thresholdLog2;
+        parameters.slope[band] = coefficients.slope;
+        parameters.attack[band] = coefficients.attack;
+        parameters.release[band] = coefficients.release;
+        parameters.makeup[band] = coefficients.makeup;
+    }
+
+    multiband.setParameters(parameters, smooth);
+}
+
+void CompressorEngine::selectPreset(const CompressorSettings& preset, const Coefficients& coefficients, bool smooth) noexcept
+{
+    if (smooth && preset == settings)
+        return;
+
+    settings = preset;
+    applyCoefficients(coefficients, smooth);
+}
+
+// exp(-1 / (t * fs)) evaluated as exp2 so no libm call is needed
+float CompressorEngine::timeToCoefficient(float milliseconds) const noexcept
+{
+    constexpr float log2e = 1.44269504089f;
+    return fastmath::fastExp2(-log2e / (std::max(milliseconds, 0.01f) * 0.001f * static_cast<float>(getProcessingRate())));
+}
+
+bool CompressorEngine::isSmoothing() const noexcept
+{
+    return thresholdLog2.isSmoothing() || slope.isSmoothing() || attackCoeff.isSmoothing()
+        || releaseCoeff.isSmoothing() || makeupLinear.isSmoothing();
+}
+
+// Deepest reduction of any link group (and band) at the end of the block,
+// from the envelopes alone (makeup not included)
+float CompressorEngine::getGainReductionDb() const noexcept
+{
+    auto gain = 1.0f;
+
+    for (int group = 0; group < linkGroups.getNumGroups(); ++group)
+    {
+        if (getNumBands() == 1)
+            gain = std::min(gain, getEnvelope(group));
+        else
+            for (int band = 0; band < getNumBands(); ++band)
+                gain = std::min(gain, multiband.getEnvelope(band, group));
+    }
+
+    return -linearToDb(gain);
+}
+
+//==============================================================================
+float CompressorEngine::applyCompression(float inputSample)
+{
+    // Level in log2 units, floored at -120 dB like linearToDb()
+    const auto inputLog2 = fastmath::fastLog2(std::max(std::abs(inputSample), 1e-6f));
+
+    // Static curve: only levels above the threshold are reduced
+    const auto overshoot = std::max(inputLog2 - thresholdLog2.getNextValue(), 0.0f);
+    const auto targetGain = fastmath::fastExp2(overshoot * slope.getNextValue());
+
+    // One-pole envelope follower
+    auto& envelope = envelopes[0];
+    const auto attack = attackCoeff.getNextValue();
+    const auto release = releaseCoeff.getNextValue();
+
+    if (targetGain < envelope)      // attack (gain falling)
+        envelope = targetGain + (envelope - targetGain) * attack;
+    else                            // release (gain rising)
+        envelope = targetGain + (envelope - targetGain) * release;
+
+    return static_cast<float>(inputSample * envelope * makeupLinear.getNextValue());
+}
+
+//==============================================================================
+template void CompressorEngine::processBlock(float* const*, int, int);
+template void CompressorEngine::processBlock(double* const*, int, int);
+template void CompressorEngine::updateAutoParameters(const float* const*, int, int);
+template void CompressorEngine::updateAutoParameters(const double* const*, int, int);
+template void CompressorEngine::compress(float* const*, int, int);
+template void CompressorEngine::compress(double* const*, int, int);
+template void CompressorEngine::compress(float* const*, int, int, const float* const*, int);
+template void CompressorEngine::compress(double* const*, int, int, const double* const*, int);
+template void CompressorEngine::bypass(float* const*, int, int);
+template void CompressorEngine::bypass(double* const*, int, int);
+template void CompressorEngine::computeGainCurve(const float* const*, int, int);
+template void CompressorEngine::computeGainCurve(const double* const*, int, int);
+template void CompressorEngine::delayAudio(float* const*, int, int) noexcept;
+template void CompressorEngine::delayAudio(double* const*, int, int) noexcept;
+template void CompressorEngine::applyGainCurve(float* const*, int, int) const noexcept;
+template void CompressorEngine::applyGainCurve(double* const*, int, int) const noexcept;
+template void CompressorEngine::analyzeAudioLevel(const float* const*, int, int);
+template void CompressorEngine::analyzeAudioLevel(const double* const*, int, int);
+
+} // namespace autocomp
@@ -0,0 +1,420 @@
+/*
+  ==============================================================================
+
+    CompressorEngine.h
+
+    Headless compressor core: level detector, gain computer and the auto-mode
+    analysis. Plain C++17 with no JUCE dependency, so it can be built and
+    profiled on its own (see CMakeLists.txt). All memory is allocated in
+    prepare(); the per-block calls never allocate.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "AudioFifo.h"
+#include "AutoAnalyser.h"
+#include "CompressorPresets.h"
+#include "GainKernels.h"
+#include "HighPassFilter.h"
+#include "LevelMeter.h"
+#include "LinkGroups.h"
+#include "MultibandCompressor.h"
+#include "Oversampler.h"
+#include "SlidingMaximum.h"
+#include "SmoothedParameter.h"
+#include "TripleBuffer.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace autocomp
+{
+
+// How the detector combines channels
+enum class StereoLink
+{
+    linked,     // one detector on the loudest channel, identical gain everywhere
+    unlinked,   // independent detector and envelope per channel
+    grouped     // link groups set with setLinkGroups()
+};
+
+//==============================================================================
+class CompressorEngine
+{
+public:
+    static constexpr int analysisBufferSize = AutoAnalyser::blockSize;
+    static constexpr int numCompressionLevels = static_cast<int>(presets::compressionLevels.size());
+    static constexpr int numAutoTiers = static_cast<int>(presets::autoTiers.size());
+    static constexpr int maxChannels = 16;
+    static constexpr double smoothingTimeSeconds = 0.02;
+    static constexpr double bypassFadeSeconds = 0.01;
+    static constexpr float maxLookaheadMs = 10.0f;
+    static constexpr int maxOversamplingFactor = Oversampler<float>::maxFactor;
+    static constexpr int maxBands = MultibandCompressor::maxBands;
+    static constexpr double rmsWindowSeconds = AutoAnalyser::rmsWindowSeconds;
+
+    CompressorEngine() = default;
+
+    // Allocates everything the engine needs and resets the state. The
+    // audio path (delay line, oversampling, band split) is sized for one
+    // precision: float, or double when doublePrecision is set.
+    void prepare(double newSampleRate, int maximumBlockSize, int numChannels, bool doublePrecision = false);
+    void reset();
+
+    bool isDoublePrecision() const noexcept { return doublePrecision; }
+
+    // The audio-path calls below take float or double channels (explicitly
+    // instantiated for both), in the precision given to prepare(). Audio is
+    // never converted: the detector reads it as it is, and gains, levels and
+    // envelopes are shared by both instantiations.
+
+    // Runs the auto-mode path over one block in place:
+    // analysis, parameter update when due, then compression.
+    template <typename SampleType>
+    void processBlock(SampleType* const* channels, int numChannels, int numSamples);
+
+    // Auto-mode steps 1 and 2: level analysis, re-tier when due
+    template <typename SampleType>
+    void updateAutoParameters(const SampleType* const* channels, int numChannels, int numSamples);
+
+    // Compression in two stages, for any block length:
+    // computeGainCurve() then applyGainCurve() per maximumBlockSize slice,
+    // at the oversampled rate when oversampling is on. In multiband mode
+    // the MultibandCompressor runs both stages instead.
+    template <typename SampleType>
+    void compress(SampleType* const* channels, int numChannels, int numSamples);
+
+    // Same, with the detector reading another input (an external sidechain)
+    // in place of the audio. The pointers are read directly, slice by slice;
+    // with the audio's own pointers this is exactly compress() above.
+    // Linked, the detector reads the loudest sidechain channel. Unlinked or
+    // grouped, a sidechain as wide as the audio keys it channel for channel;
+    // a narrower one keys every channel and group from its mono sum (so a
+    // stereo key on a 5.1 bed drives the fronts and surrounds alike).
+    template <typename SampleType>
+    void compress(SampleType* const* channels, int numChannels, int numSamples,
+                  const SampleType* const* detectorChannels, int numDetectorChannels);
+
+    // Same delay path as compress() without any gain, so the reported
+    // latency holds while compression is switched off
+    template <typename SampleType>
+    void bypass(SampleType* const* channels, int numChannels, int numSamples);
+
+    // Switches compression off or back on, crossfading over bypassFadeSeconds
+    // between the compressed audio and what bypass() would output. Both come
+    // off the same delay path, so the fade needs no latency change. Once the
+    // fade is done compress() runs bypass(); switching back on restarts the
+    // detectors from unity. Audio thread (cheap to call every block).
+    void setBypassed(bool shouldBypass) noexcept;
+    bool isBypassed() const noexcept { return bypassed; }
+
+    // compress() and bypass() skip a block of digital silence (sidechain
+    // included) once the audio path has been silent for the whole tail and
+    // no glide or fade is under way. The output is silence either way; the
+    // envelopes release over the block in closed form, so coming back from
+    // silence sounds the same. True if the last call skipped its block.
+    bool isIdle() const noexcept { return idle; }
+
+    // Stage 1: detector, gain computer, envelope and makeup into the gain
+    // scratch buffer, at the processing rate. numSamples must not exceed
+    // the prepared block size times the oversampling factor. Broadband only.
+    template <typename SampleType>
+    void computeGainCurve(const SampleType* const* channels, int numChannels, int numSamples);
+
+    // Gain curve for a channel from the last computeGainCurve() call.
+    // Channels in one link group share a curve; excluded channels get unity.
+    const float* getGainCurve(int channel) const noexcept;
+
+    // Lookahead delay for the audio path, to run between the two stages.
+    // A no-op while the lookahead is zero.
+    template <typename SampleType>
+    void delayAudio(SampleType* const* channels, int numChannels, int numSamples) noexcept;
+
+    // Stage 2: multiplies the channels by their gain curves
+    template <typename SampleType>
+    void applyGainCurve(SampleType* const* channels, int numChannels, int numSamples) const noexcept;
+
+    int getMaximumBlockSize() const noexcept { return maximumBlockSize; }
+
+    // Lookahead of 0 to maxLookaheadMs. The detector sees that far ahead of
+    // the (delayed) audio. Never allocates; changing it clears the delay
+    // line. Returns true if the latency changed.
+    bool setLookahead(float milliseconds) noexcept;
+
+    // 1x, 2x or 4x oversampling of the detector and gain stage. Never
+    // allocates; the coefficients are re-derived for the new rate and the
+    // filter and lookahead state cleared. Returns true if it changed.
+    bool setOversamplingFactor(int factor) noexcept;
+    int getOversamplingFactor() const noexcept { return singlePath.oversampler.getFactor(); }
+    double getProcessingRate() const noexcept { return sampleRate * getOversamplingFactor(); }
+
+    // Lookahead plus oversampling filter delay, in base-rate samples
+    int getLatencySamples() const noexcept;
+
+    // How long the output can go on after the input stops, in base-rate
+    // samples: the lookahead, the full length of the oversampling filters
+    // (twice their delay) and, in multiband mode, the crossovers ringing out
+    int getTailSamples() const noexcept;
+
+    // 1 (broadband), 3 or 4 bands using presets::bandLayouts. Each band
+    // compresses with the current settings (manual or auto), its attack and
+    // release scaled by the layout. Never allocates and adds no latency;
+    // changing it clears the band state. Returns true if it changed.
+    bool setNumBands(int numBands) noexcept;
+    int getNumBands() const noexcept { return multiband.getNumBands(); }
+    float getBandEnvelope(int band, int channel = 0) const noexcept { return multiband.getEnvelope(band, channel); }
+
+    // High-pass on the broadband detector input, so bass doesn't drive the
+    // gain. 0 switches it off. Cheap to call every block. Multiband mode
+    // ignores it: each band's detector is band-limited already.
+    void setDetectorHighPass(float hz) noexcept;
+    float getDetectorHighPass() const noexcept { return detectorHighPassHz; }
+
+    // linked and unlinked set the matching link groups; grouped is
+    // what setLinkGroups() reports and is ignored here
+    void setStereoLink(StereoLink newLink) noexcept;
+    StereoLink getStereoLink() const noexcept { return stereoLink; }
+
+    // Arbitrary link groups (e.g. LCR, surrounds, heights, LFE excluded).
+    // Each group's detector reads the loudest of its channels in one SIMD
+    // pass. Never allocates; a change restarts the detector envelopes.
+    void setLinkGroups(const LinkGroups& newGroups) noexcept;
+    const LinkGroups& getLinkGroups() const noexcept { return linkGroups; }
+
+    // Manual settings (audio thread, or any thread while not processing).
+    // setSettings() jumps; setTargetSettings() glides over smoothingTimeSeconds.
+    void setSettings(const CompressorSettings& newSettings);
+    void setTargetSettings(const CompressorSettings& newSettings);
+    const CompressorSettings& getSettings() const noexcept { return settings; }
+    void setCompressionLevel(int level); // 0-4
+    void setTargetCompressionLevel(int level);
+    static bool getCompressionLevelSettings(int level, CompressorSettings& result) noexcept;
+
+    // Lock-free handoff for other threads. One thread may request settings,
+    // the audio thread picks them up in beginBlock(); one thread may read
+    // back the settings in use (manual or auto) with getActiveSettings().
+    void requestSettings(const CompressorSettings& newSettings) noexcept { pendingSettings.write(newSettings); }
+    void requestCompressionLevel(int level) noexcept;
+    void beginBlock();
+    CompressorSettings getActiveSettings() noexcept { return activeSettings.latest(); }
+
+    // Auto-mode analysis. The audio thread only pushes the input into the
+    // analysis FIFO; the AutoAnalyser (loudness, crest factor, spectral
+    // tilt) runs wherever processPendingAnalysis() is called and publishes
+    // one result per analysisBufferSize frames. applyAutoParameters()
+    // re-tiers the settings from the newest result. Digital silence stops
+    // being pushed after analysisSilenceSeconds, when every analysis window
+    // holds silence already and more of it would change nothing. The
+    // analysis averages the channels passed in, however many were prepared,
+    // so a wider prepare() (room for a sidechain) leaves the readings alone.
+    template <typename SampleType>
+    void analyzeAudioLevel(const SampleType* const* channels, int numChannels, int numSamples);
+    void applyAutoParameters();
+    void calculateAutoParameters();
+    bool isAnalysisDue() const noexcept { return needsAnalysis; }
+    int getAutoTier() const noexcept { return autoTier; }
+    const AutoAnalysis& getLatestAnalysis() const noexcept { return latestAnalysis; }
+
+    // Inline (default): analyzeAudioLevel() also runs the analysis, on the
+    // audio thread. Background: one other thread, normally an AnalysisWorker,
+    // must call processPendingAnalysis(). Switch while that thread is stopped.
+    void setBackgroundAnalysis(bool shouldRunInBackground) noexcept { backgroundAnalysis.store(shouldRunInBackground); }
+    bool isBackgroundAnalysis() const noexcept { return backgroundAnalysis.load(); }
+
+    // Analysis consumer: drains the FIFO and publishes any finished result.
+    // Returns true if a result was published.
+    bool processPendingAnalysis();
+
+    // Auto mode sets the makeup so the output reaches this loudness (any thread)
+    void setLoudnessTarget(float lufs) noexcept { loudnessTarget.store(lufs); }
+    void clearLoudnessTarget() noexcept { loudnessTarget.store(AutoAnalyser::noLoudnessTarget); }
+
+    // Loudness of the analysed input for one reader thread (the editor),
+    // updated every time the analysis FIFO is drained
+    LoudnessReading getLoudness() noexcept { return loudnessReadings.latest(); }
+
+    // Restarts the integrated loudness (any thread)
+    void resetIntegratedLoudness() noexcept { integratedResetPending.store(true); }
+
+    // Input/output peak and RMS and gain reduction for one reader thread
+    // (the editor). While metering is on, compress() and bypass() measure
+    // the audio as it goes through and publish once per call; off (the
+    // default), they skip it entirely. Either flag may be set from any thread.
+    void setMetering(bool shouldMeter) noexcept { metering.store(shouldMeter, std::memory_order_relaxed); }
+    bool isMetering() const noexcept { return metering.load(std::memory_order_relaxed); }
+    LevelReading readLevels() noexcept { return levelMeter.read(); }
+
+    // Instruction set for the gain stage: the widest this CPU supports
+    // unless forced (tests and benchmarks; unsupported falls back to the
+    // baseline). Not while processing.
+    void setInstructionSet(kernels::InstructionSet set) noexcept { gainKernels = &kernels::getGainKernels(set); }
+    kernels::InstructionSet getInstructionSet() const noexcept { return gainKernels->instructionSet; }
+
+    // BS.1770 channel weights for the loudness meter (1.41 for surrounds,
+    // 0 for the LFE). Call after prepare() while no analysis consumer runs.
+    void setLoudnessChannelWeights(const float* weights, int numChannels) noexcept
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+            analyser.getLoudnessMeter().setChannelWeight(channel, weights[channel]);
+    }
+
+    // Single-sample compression (detector + gain computer + makeup), at the
+    // processing rate; without oversampling it matches compress()
+    float applyCompression(float inputSample);
+
+    float getCurrentRms() const noexcept { return currentRMS; }
+    // Envelope of a link group (of a channel when unlinked)
+    float getEnvelope(int group = 0) const noexcept { return static_cast<float>(envelopes[static_cast<std::size_t>(group)]); }
+    double getSampleRate() const noexcept { return sampleRate; }
+
+    static float dbToLinear(float db);
+    static float linearToDb(float linear);
+
+private:
+    enum RampIndex { thresholdRamp, slopeRamp, attackRamp, releaseRamp, makeupRamp, mixRamp, numRamps };
+
+    // The lowest crossover (150 Hz) decays below -120 dB well within this
+    static constexpr double crossoverRingOutSeconds = 0.05;
+
+    // The longest analysis window (3 s short-term loudness) and then some
+    static constexpr double analysisSilenceSeconds = 4.0;
+
+    // Everything the per-sample path needs, derived from one CompressorSettings
+    struct Coefficients
+    {
+        float thresholdLog2, slope, attack, release, makeup;
+    };
+
+    // Everything that carries audio, in the audio's precision. Only the
+    // precision chosen in prepare() gets full-size buffers.
+    template <typename SampleType>
+    struct AudioPath
+    {
+        Oversampler<SampleType> oversampler;
+        Oversampler<SampleType> sidechainOversampler;   // external detector input, when oversampled
+        std::vector<SampleType> delayBuffer;            // numPreparedChannels x maxLookaheadSamples
+        std::vector<SampleType> dryBuffer;              // numPreparedChannels x blockCapacity, for the bypass fade
+        std::vector<SampleType> keyBuffer;              // maximumBlockSize, a narrow sidechain's mono sum
+    };
+
+    template <typename SampleType>
+    AudioPath<SampleType>& getAudioPath() noexcept
+    {
+        if constexpr (std::is_same_v<SampleType, double>)
+            return doublePath;
+        else
+            return singlePath;
+    }
+
+    void clearAudioPaths() noexcept;
+    void clearDelayLines() noexcept;
+    void restartDetectors() noexcept;
+    bool countSilence(bool silent, int numSamples) noexcept;
+    bool isSettled() const noexcept;
+    void releaseEnvelopes(int numSamples) noexcept;
+
+    template <typename SampleType>
+    void compressSlice(SampleType* const* channels, int numChannels,
+                       const SampleType* const* detectorChannels, int numDetectorChannels, int numSamples);
+    void updateCompressorCoefficients(bool smooth = false);
+    void updateBandParameters(bool smooth) noexcept;
+    void updateRateDependentState() noexcept;
+    Coefficients deriveCoefficients(const CompressorSettings& source) const noexcept;
+    void applyCoefficients(const Coefficients& coefficients, bool smooth) noexcept;
+    void selectPreset(const CompressorSettings& preset, const Coefficients& coefficients, bool smooth) noexcept;
+    float timeToCoefficient(float milliseconds) const noexcept;
+    bool isSmoothing() const noexcept;
+    float getGainReductionDb() const noexcept;
+    float* getRamp(RampIndex index) noexcept { return rampBuffer.data() + index * blockCapacity; }
+
+    CompressorSettings settings;
+    TripleBuffer<CompressorSettings> pendingSettings;
+    TripleBuffer<CompressorSettings> activeSettings;
+
+    // Level detection, from the latest published analysis
+    float currentRMS = 0.0f;
+
+    // Compressor state, one envelope per link group. The envelopes are kept
+    // in double so very long releases still move by less than a float step.
+    StereoLink stereoLink = StereoLink::linked;
+    LinkGroups linkGroups = LinkGroups::linked();
+    std::array<double, maxChannels> envelopes {};
+
+    // Derived from the settings in updateCompressorCoefficients(), each
+    // gliding per sample towards its target
+    SmoothedParameter thresholdLog2;
+    SmoothedParameter slope;            // 1/ratio - 1, applied to the log2 overshoot
+    SmoothedParameter attackCoeff;
+    SmoothedParameter releaseCoeff;
+    SmoothedParameter makeupLinear;
+
+    // Preset and tier coefficients for the prepared sample rate, so level and
+    // tier switches on the audio thread are a table lookup
+    std::array<Coefficients, numCompressionLevels> levelCoefficients {};
+    std::array<Coefficients, numAutoTiers> tierCoefficients {};
+    int autoTier = -1;
+
+    double sampleRate = 44100.0;
+    int maximumBlockSize = 0;
+    int blockCapacity = 0;              // maximumBlockSize * maxOversamplingFactor
+    int numPreparedChannels = 0;
+    bool doublePrecision = false;
+
+    AudioPath<float> singlePath;
+    AudioPath<double> doublePath;
+    MultibandCompressor multiband;
+    HighPassFilter detectorFilter;
+    float detectorHighPassHz = 0.0f;
+
+    // Stage 1 output: one curve per link group, and unity for excluded channels
+    std::vector<float> gainBuffer;
+    std::vector<float> unityGain;
+
+    // Per-sample parameter values while gliding (numRamps x blockCapacity)
+    std::vector<float> rampBuffer;
+
+    // Lookahead: peak hold over the window, audio delayed by the same amount.
+    // lookaheadSamples is at the processing rate.
+    float lookaheadMs = 0.0f;
+    int lookaheadBaseSamples = 0;
+    int lookaheadSamples = 0;
+    int maxLookaheadSamples = 0;
+    std::vector<SlidingMaximum> lookaheadPeaks;     // per link group
+    int delayPosition = 0;
+
+    // Auto analysis: audio thread -> FIFO -> analyser -> results -> audio thread
+    AudioFifo analysisFifo;
+    AutoAnalyser analyser;                          // owned by the analysis consumer
+    std::vector<float> analysisScratch;             // consumer side, numPreparedChannels x analysisBufferSize
+    TripleBuffer<AutoAnalysis> analysisResults;
+    TripleBuffer<LoudnessReading> loudnessReadings;
+    AutoAnalysis latestAnalysis;
+    std::atomic<bool> backgroundAnalysis { false };
+    std::atomic<float> loudnessTarget { AutoAnalyser::noLoudnessTarget };
+    std::atomic<bool> integratedResetPending { false };
+    std::atomic<int> analysisChannels { 1 };       // channels in the last push
+    bool needsAnalysis = true;
+    int analysisSilentSamples = 0;                  // up to analysisSilenceSeconds
+
+    // Metering: audio thread -> atomics -> editor
+    LevelMeter levelMeter;
+    std::atomic<bool> metering { false };
+
+    // Bypass: 1 compressing, 0 bypassed, ramping at the processing rate
+    SmoothedParameter wetMix;
+    bool bypassed = false;
+
+    // Silence: consecutive silent input frames (counted up to the tail)
+    int silentSamples = 0;
+    bool idle = false;
+
+    // Gain stage variants, chosen per block from this table
+    const kernels::GainKernels* gainKernels = &kernels::getGainKernels();
+};
+
+} // namespace autocomp
@@ -0,0 +1,126 @@
+/*
+  ==============================================================================
+
+    CompressorPresets.h
+
+    Compressor settings and the fixed tables the plugin switches between:
+    the five manual compression levels (also the factory programs), the
+    five auto-mode tiers and the multiband layouts. All are constexpr;
+    CompressorEngine derives the level and tier coefficients for the
+    current sample rate once in prepare().
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <limits>
+
+namespace autocomp
+{
+
+//==============================================================================
+// Compressor settings in user units (dB, ratio, milliseconds)
+struct CompressorSettings
+{
+    float threshold = -20.0f;   // dB
+    float ratio = 4.0f;         // n:1
+    float attack = 10.0f;       // ms
+    float release = 100.0f;     // ms
+    float makeupGain = 0.0f;    // dB
+
+    constexpr bool operator== (const CompressorSettings& other) const noexcept
+    {
+        return threshold == other.threshold && ratio == other.ratio && attack == other.attack
+            && release == other.release && makeupGain == other.makeupGain;
+    }
+
+    constexpr bool operator!= (const CompressorSettings& other) const noexcept { return ! operator== (other); }
+};
+
+namespace presets
+{
+
+//==============================================================================
+// Manual levels 1-5 (index 0-4)
+constexpr std::array<CompressorSettings, 5> compressionLevels {{
+    { -30.0f, 1.5f, 30.0f, 200.0f, 1.0f },  // very gentle
+    { -25.0f, 2.5f, 20.0f, 150.0f, 2.0f },  // gentle
+    { -20.0f, 4.0f, 10.0f, 100.0f, 3.0f },  // medium (default)
+    { -15.0f, 6.0f,  5.0f,  80.0f, 4.0f },  // strong
+    { -10.0f, 8.0f,  2.0f,  50.0f, 5.0f }   // very strong
+}};
+
+// Factory programs: the levels, by name, for the host's program list
+struct FactoryProgram
+{
+    const char* name;
+    CompressorSettings settings;
+};
+
+constexpr std::array<FactoryProgram, 5> factoryPrograms {{
+    { "Very Gentle",    compressionLevels[0] },
+    { "Gentle",         compressionLevels[1] },
+    { "Medium",         compressionLevels[2] },
+    { "Strong",         compressionLevels[3] },
+    { "Very Strong",    compressionLevels[4] }
+}};
+
+static_assert(factoryPrograms.size() == compressionLevels.size());
+
+//==============================================================================
+// Auto-mode tiers, chosen by the short-term loudness (BS.1770)
+struct AutoTier
+{
+    float belowLufs;            // tier applies while the loudness is below this
+    CompressorSettings settings;
+};
+
+constexpr std::array<AutoTier, 5> autoTiers {{
+    { -60.0f,                                   { -40.0f, 2.0f, 20.0f, 200.0f, 6.0f } },  // very quiet
+    { -40.0f,                                   { -30.0f, 3.0f, 15.0f, 150.0f, 4.0f } },  // quiet
+    { -20.0f,                                   { -20.0f, 4.0f, 10.0f, 100.0f, 2.0f } },  // moderate
+    { -10.0f,                                   { -15.0f, 6.0f,  5.0f,  80.0f, 1.0f } },  // loud
+    { std::numeric_limits<float>::infinity(),   { -10.0f, 8.0f,  2.0f,  50.0f, 0.0f } }   // very loud
+}};
+
+constexpr int findAutoTier(float lufs) noexcept
+{
+    for (int tier = 0; tier < static_cast<int>(autoTiers.size()) - 1; ++tier)
+        if (lufs < autoTiers[static_cast<std::size_t>(tier)].belowLufs)
+            return tier;
+
+    return static_cast<int>(autoTiers.size()) - 1;
+}
+
+static_assert(findAutoTier(-80.0f) == 0 && findAutoTier(-30.0f) == 2 && findAutoTier(0.0f) == 4);
+
+//==============================================================================
+// Multiband layouts: crossover frequencies, and how each band scales the
+// attack and release of the broadband settings (manual or auto). The lows
+// are slower so the envelope doesn't follow the waveform.
+struct BandLayout
+{
+    int numBands;
+    std::array<float, 3> crossovers;    // Hz, numBands - 1 used
+    std::array<float, 4> timeScale;     // per band, numBands used
+};
+
+constexpr std::array<BandLayout, 2> bandLayouts {{
+    { 3, { 200.0f, 2500.0f, 0.0f },     { 2.0f, 1.0f, 0.5f, 1.0f } },
+    { 4, { 150.0f, 1000.0f, 6000.0f },  { 2.0f, 1.25f, 0.75f, 0.5f } }
+}};
+
+constexpr const BandLayout* findBandLayout(int numBands) noexcept
+{
+    for (const auto& layout : bandLayouts)
+        if (layout.numBands == numBands)
+            return &layout;
+
+    return nullptr;
+}
+
+} // namespace presets
+} // namespace autocomp
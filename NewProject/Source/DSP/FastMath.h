@@ -0,0 +1,87 @@
+/*
+  ==============================================================================
+
+    FastMath.h
+
+    Branch-free log2/exp2 approximations for the gain computer. Both are
+    written as straight-line float/int arithmetic so that loops calling them
+    auto-vectorise (no table lookups, no libm calls; GCC also needs
+    no-trapping-math for the selects, see GainKernels.cpp).
+
+    Error bounds (exact arithmetic, float rounding adds a few ulp on top):
+
+      fastLog2  x = 2^e * m, m folded into [sqrt(1/2), sqrt(2)),
+                t = (m - 1) / (m + 1), |t| <= 0.1716
+                log2(m) = 2/ln2 * (t + t^3/3 + t^5/5 + ...), truncated after t^5
+                |error| <= 2/ln2 * t^7/7 / (1 - t^2) < 2.0e-6   (1.2e-5 dB)
+
+      fastExp2  x = i + f, |f| <= 0.5
+                2^f = e^(f ln2) as a 6th order Taylor polynomial
+                relative error <= (0.5 ln2)^7 / 7! * sqrt(2) < 1.8e-7   (1.6e-6 dB)
+
+    Inputs to fastLog2 must be positive normal floats; callers clamp to a
+    floor first. fastExp2 clamps its input to [-126, 127].
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+namespace autocomp::fastmath
+{
+
+// dB <-> log2 scale factors: dB = 20 log10(x) = log2(x) * 20 log10(2)
+constexpr float dbPerLog2 = 6.0205999132796239f;
+constexpr float log2PerDb = 1.0f / dbPerLog2;
+
+inline float fastLog2(float x) noexcept
+{
+    std::int32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+
+    auto exponent = static_cast<float>(((bits >> 23) & 0xff) - 127);
+
+    bits = (bits & 0x007fffff) | 0x3f800000;
+    float mantissa;
+    std::memcpy(&mantissa, &bits, sizeof(mantissa));
+
+    // Fold [sqrt(2), 2) down an octave so |t| stays small
+    const bool fold = mantissa > 1.41421356f;
+    mantissa = fold ? mantissa * 0.5f : mantissa;
+    exponent = fold ? exponent + 1.0f : exponent;
+
+    const auto t = (mantissa - 1.0f) / (mantissa + 1.0f);
+    const auto t2 = t * t;
+
+    constexpr float c1 = 2.8853900817779268f;   // 2/ln2
+    constexpr float c3 = c1 / 3.0f;
+    constexpr float c5 = c1 / 5.0f;
+
+    return exponent + t * (c1 + t2 * (c3 + t2 * c5));
+}
+
+inline float fastExp2(float x) noexcept
+{
+    x = x < -126.0f ? -126.0f : (x > 127.0f ? 127.0f : x);
+
+    // Round to nearest via truncation of a positive value
+    const auto i = static_cast<std::int32_t>(x + 127.5f) - 127;
+    const auto f = (x - static_cast<float>(i)) * 0.69314718056f;
+
+    const auto poly = 1.0f + f * (1.0f + f * (1.0f / 2.0f + f * (1.0f / 6.0f + f * (1.0f / 24.0f
+                    + f * (1.0f / 120.0f + f * (1.0f / 720.0f))))));
+
+    const std::int32_t scaleBits = (i + 127) << 23;
+    float scale;
+    std::memcpy(&scale, &scaleBits, sizeof(scale));
+
+    return poly * scale;
+}
+
+inline float fastDbToLinear(float db) noexcept      { return fastExp2(db * log2PerDb); }
+inline float fastLinearToDb(float linear) noexcept  { return fastLog2(linear) * dbPerLog2; }
+
+} // namespace autocomp::fastmath
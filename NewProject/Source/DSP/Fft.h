@@ -0,0 +1,99 @@
+/*
+  ==============================================================================
+
+    Fft.h
+
+    Radix-2 complex FFT for the background analysis. Same shape as
+    juce::dsp::FFT (constructed with an order, frequency-only transform
+    in place on 2 * size floats) so the headless core stays JUCE-free.
+    Twiddles and the bit-reversal table are built in the constructor;
+    perform calls never allocate.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cmath>
+#include <complex>
+#include <utility>
+#include <vector>
+
+namespace autocomp
+{
+
+class Fft
+{
+public:
+    explicit Fft(int order)
+        : size(1 << order),
+          twiddles(static_cast<size_t>(size / 2)),
+          bitReversed(static_cast<size_t>(size)),
+          work(static_cast<size_t>(size))
+    {
+        const auto twoPi = 6.283185307179586;
+
+        for (int i = 0; i < size / 2; ++i)
+            twiddles[static_cast<size_t>(i)] = std::polar(1.0f, static_cast<float>(-twoPi * i / size));
+
+        for (int i = 0; i < size; ++i)
+        {
+            int reversed = 0;
+
+            for (int bit = 0; bit < order; ++bit)
+                reversed |= ((i >> bit) & 1) << (order - 1 - bit);
+
+            bitReversed[static_cast<size_t>(i)] = reversed;
+        }
+    }
+
+    int getSize() const noexcept { return size; }
+
+    // In-place forward transform
+    void perform(std::complex<float>* data) const noexcept
+    {
+        for (int i = 0; i < size; ++i)
+        {
+            const auto j = bitReversed[static_cast<size_t>(i)];
+
+            if (i < j)
+                std::swap(data[i], data[j]);
+        }
+
+        for (int half = 1; half < size; half <<= 1)
+        {
+            const auto stride = size / (2 * half);
+
+            for (int start = 0; start < size; start += 2 * half)
+            {
+                for (int k = 0; k < half; ++k)
+                {
+                    const auto t = twiddles[static_cast<size_t>(k * stride)] * data[start + k + half];
+                    data[start + k + half] = data[start + k] - t;
+                    data[start + k] += t;
+                }
+            }
+        }
+    }
+
+    // data holds 2 * size floats: the real input in the first size, on
+    // return the magnitudes of bins 0..size/2 at the start
+    void performFrequencyOnlyForwardTransform(float* data) noexcept
+    {
+        for (int i = 0; i < size; ++i)
+            work[static_cast<size_t>(i)] = { data[i], 0.0f };
+
+        perform(work.data());
+
+        for (int i = 0; i <= size / 2; ++i)
+            data[i] = std::abs(work[static_cast<size_t>(i)]);
+    }
+
+private:
+    int size;
+    std::vector<std::complex<float>> twiddles;
+    std::vector<int> bitReversed;
+    std::vector<std::complex<float>> work;
+};
+
+} // namespace autocomp
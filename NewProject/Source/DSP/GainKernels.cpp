@@ -0,0 +1,181 @@
+/*
+  ==============================================================================
+
+    GainKernels.cpp
+
+    One template body, instantiated per option combination and wrapped per
+    instruction set with a target attribute. The body is force-inlined into
+    each wrapper, so it (and the FastMath functions it calls) is compiled
+    and vectorised for that wrapper's instruction set.
+
+    GCC only vectorises the FastMath selects (clamps, octave fold) when it
+    may assume floating-point comparisons don't trap, which is Clang's
+    default. The pragma comes before the includes so the inlined FastMath
+    functions get the same options as the kernels.
+
+  ==============================================================================
+*/
+
+#if defined(__GNUC__) && ! defined(__clang__)
+ #pragma GCC optimize ("no-trapping-math")
+#endif
+
+#include "GainKernels.h"
+#include "FastMath.h"
+#include "SimdKernels.h"
+
+#include <algorithm>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+ #define AUTOCOMP_KERNEL_DISPATCH 1
+ #define AUTOCOMP_ALWAYS_INLINE __attribute__((always_inline)) inline
+ #define AUTOCOMP_TARGET(isa) __attribute__((target(isa)))
+#else
+ #define AUTOCOMP_KERNEL_DISPATCH 0
+ #define AUTOCOMP_ALWAYS_INLINE inline
+#endif
+
+namespace autocomp::kernels
+{
+
+namespace
+{
+    template <bool gliding, bool makeup>
+    AUTOCOMP_ALWAYS_INLINE void gainStage(float* gains, int numSamples, double& envelope, const GainStage& stage) noexcept
+    {
+        // Static curve: no loop-carried state, vectorises. The settings are
+        // copied out first: gains is a float* and could alias them.
+        const auto* thresholds = stage.thresholds;
+        const auto* slopes = stage.slopes;
+        const auto steadyThreshold = stage.thresholdLog2;
+        const auto steadySlope = stage.slope;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto threshold = gliding ? thresholds[i] : steadyThreshold;
+            const auto slope = gliding ? slopes[i] : steadySlope;
+            const auto levelLog2 = fastmath::fastLog2(std::max(gains[i], 1e-6f));
+            gains[i] = fastmath::fastExp2(std::max(levelLog2 - threshold, 0.0f) * slope);
+        }
+
+        // The serial part: one-pole attack/release follower, then makeup. The
+        // recursion runs in double (same latency as float on the dependency
+        // chain): with a release of seconds at high rates, a float envelope's
+        // per-sample step falls below its resolution and the gain stops
+        // recovering.
+        auto env = envelope;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const double target = gains[i];
+            const double attack = gliding ? stage.attacks[i] : stage.attack;
+            const double release = gliding ? stage.releases[i] : stage.release;
+            env = target + (env - target) * (target < env ? attack : release);
+
+            if constexpr (makeup)
+                gains[i] = static_cast<float>(env * (gliding ? static_cast<double>(stage.makeups[i]) : stage.makeup));
+            else
+                gains[i] = static_cast<float>(env);
+        }
+
+        envelope = env;
+    }
+
+    template <bool gliding, bool makeup>
+    void baseline(float* gains, int numSamples, double& envelope, const GainStage& stage) noexcept
+    {
+        gainStage<gliding, makeup>(gains, numSamples, envelope, stage);
+    }
+
+    constexpr GainKernels baselineKernels { InstructionSet::baseline,
+                                            { { baseline<false, false>, baseline<false, true> },
+                                              { baseline<true, false>, baseline<true, true> } } };
+
+#if AUTOCOMP_KERNEL_DISPATCH
+    template <bool gliding, bool makeup>
+    AUTOCOMP_TARGET("avx2,fma")
+    void avx2(float* gains, int numSamples, double& envelope, const GainStage& stage) noexcept
+    {
+        gainStage<gliding, makeup>(gains, numSamples, envelope, stage);
+    }
+
+    template <bool gliding, bool makeup>
+    AUTOCOMP_TARGET("avx512f,avx512vl,avx512dq,avx512bw,avx2,fma")
+    void avx512(float* gains, int numSamples, double& envelope, const GainStage& stage) noexcept
+    {
+        gainStage<gliding, makeup>(gains, numSamples, envelope, stage);
+    }
+
+    constexpr GainKernels avx2Kernels { InstructionSet::avx2,
+                                        { { avx2<false, false>, avx2<false, true> },
+                                          { avx2<true, false>, avx2<true, true> } } };
+
+    constexpr GainKernels avx512Kernels { InstructionSet::avx512,
+                                          { { avx512<false, false>, avx512<false, true> },
+                                            { avx512<true, false>, avx512<true, true> } } };
+#endif
+}
+
+//==============================================================================
+bool isSupported(InstructionSet instructionSet) noexcept
+{
+    switch (instructionSet)
+    {
+        case InstructionSet::baseline:
+            return true;
+
+#if AUTOCOMP_KERNEL_DISPATCH
+        case InstructionSet::avx2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+
+        case InstructionSet::avx512:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl")
+                && __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512bw")
+                && isSupported(InstructionSet::avx2);
+#else
+        case InstructionSet::avx2:
+        case InstructionSet::avx512:
+            return false;
+#endif
+    }
+
+    return false;
+}
+
+const char* getName(InstructionSet instructionSet) noexcept
+{
+    switch (instructionSet)
+    {
+        case InstructionSet::baseline:  return simd::instructionSet;
+        case InstructionSet::avx2:      return "AVX2";
+        case InstructionSet::avx512:    return "AVX-512";
+    }
+
+    return "";
+}
+
+const GainKernels& getGainKernels(InstructionSet instructionSet) noexcept
+{
+#if AUTOCOMP_KERNEL_DISPATCH
+    if (instructionSet == InstructionSet::avx512 && isSupported(InstructionSet::avx512))
+        return avx512Kernels;
+
+    if (instructionSet == InstructionSet::avx2 && isSupported(InstructionSet::avx2))
+        return avx2Kernels;
+#else
+    (void) instructionSet;
+#endif
+
+    return baselineKernels;
+}
+
+const GainKernels& getGainKernels() noexcept
+{
+    static const GainKernels& best = isSupported(InstructionSet::avx512) ? getGainKernels(InstructionSet::avx512)
+                                                                          : getGainKernels(InstructionSet::avx2);
+    return best;
+}
+
+} // namespace autocomp::kernels
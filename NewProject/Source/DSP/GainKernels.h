@@ -0,0 +1,71 @@
+/*
+  ==============================================================================
+
+    GainKernels.h
+
+    The gain stage that turns detector levels into gains: static curve in
+    the log2 domain, attack/release follower, makeup. Each variant is a
+    template instantiation for one combination of options (settings gliding
+    or steady, makeup applied or not), so its loops carry no per-sample
+    option checks. The engine picks the variant once per block.
+
+    On x86 with GCC or Clang every variant is also built for AVX2 (+FMA)
+    and AVX-512, next to the baseline the build targets (SSE2 by default),
+    and the widest set the CPU supports is chosen at run time. Elsewhere
+    only the baseline exists.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+namespace autocomp::kernels
+{
+
+enum class InstructionSet
+{
+    baseline,       // whatever the build targets (simd::instructionSet)
+    avx2,
+    avx512
+};
+
+// One block's gain computer settings. The ramps hold per-sample values
+// and are only read by the gliding variants.
+struct GainStage
+{
+    float thresholdLog2 = 0.0f;
+    float slope = 0.0f;             // 1/ratio - 1
+    double attack = 0.0;            // one-pole coefficients
+    double release = 0.0;
+    double makeup = 1.0;            // linear
+
+    const float* thresholds = nullptr;
+    const float* slopes = nullptr;
+    const float* attacks = nullptr;
+    const float* releases = nullptr;
+    const float* makeups = nullptr;
+};
+
+// Detector levels in, gains out (in place); the envelope carries over
+// from block to block
+using GainFunction = void (*)(float* gains, int numSamples, double& envelope, const GainStage& stage) noexcept;
+
+struct GainKernels
+{
+    InstructionSet instructionSet;
+    GainFunction variants[2][2];    // [gliding][makeup]
+
+    GainFunction get(bool gliding, bool makeup) const noexcept { return variants[gliding ? 1 : 0][makeup ? 1 : 0]; }
+};
+
+// The widest set this CPU supports (detected once)
+const GainKernels& getGainKernels() noexcept;
+
+// A specific set, for tests and benchmarks; the baseline if this CPU or
+// build lacks it
+const GainKernels& getGainKernels(InstructionSet instructionSet) noexcept;
+
+bool isSupported(InstructionSet instructionSet) noexcept;
+const char* getName(InstructionSet instructionSet) noexcept;
+
+} // namespace autocomp::kernels
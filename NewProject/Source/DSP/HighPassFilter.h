@@ -0,0 +1,97 @@
+/*
+  ==============================================================================
+
+    HighPassFilter.h
+
+    2nd order Butterworth high-pass for the detector path, as a state
+    variable filter with trapezoidal integrators so the cutoff can move
+    while running. It writes the rectified output straight into the
+    detector's level buffer, folding in the channel maximum as it goes, so
+    the detector never needs a filtered copy of its input. State for up to
+    maxChannels inputs lives in the object; nothing is allocated.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace autocomp
+{
+
+class HighPassFilter
+{
+public:
+    static constexpr int maxChannels = 16;
+
+    // Cutoff in Hz at the given rate; 0 (or below) switches the filter off
+    void setCutoff(float hz, double sampleRate) noexcept
+    {
+        active = hz > 0.0f;
+
+        if (! active)
+            return;
+
+        const auto pi = 3.141592653589793;
+        const auto g = std::tan(pi * std::min(static_cast<double>(hz), 0.45 * sampleRate) / sampleRate);
+        gain = static_cast<float>(g);
+        normalise = static_cast<float>(1.0 / (1.0 + g * (g + damping)));
+    }
+
+    bool isActive() const noexcept { return active; }
+
+    void reset() noexcept { states.fill({}); }
+
+    // levels[i] = max over the listed channels c of |hp(channels[c][i])|,
+    // each channel filtered with its own state. Float or double input; the
+    // filter itself runs in float, the detector's precision.
+    template <typename SampleType>
+    void processLevels(const SampleType* const* channels, const int* indices, int count, float* levels, int numSamples) noexcept
+    {
+        filterChannel<false>(indices[0], channels[indices[0]], levels, numSamples);
+
+        for (int i = 1; i < count; ++i)
+            filterChannel<true>(indices[i], channels[indices[i]], levels, numSamples);
+    }
+
+private:
+    static constexpr float damping = 1.41421356f;   // 1 / Q
+
+    struct State
+    {
+        float s1 = 0.0f, s2 = 0.0f;
+    };
+
+    template <bool keepMaximum, typename SampleType>
+    void filterChannel(int channel, const SampleType* input, float* levels, int numSamples) noexcept
+    {
+        auto& state = states[static_cast<size_t>(channel)];
+        const auto g = gain, h = normalise;
+        auto s1 = state.s1, s2 = state.s2;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto hp = (static_cast<float>(input[i]) - (g + damping) * s1 - s2) * h;
+            const auto bp = g * hp + s1;
+            s1 = g * hp + bp;
+            s2 = g * bp + (g * bp + s2);
+
+            if constexpr (keepMaximum)
+                levels[i] = std::max(levels[i], std::abs(hp));
+            else
+                levels[i] = std::abs(hp);
+        }
+
+        state.s1 = std::abs(s1) < 1e-15f ? 0.0f : s1;
+        state.s2 = std::abs(s2) < 1e-15f ? 0.0f : s2;
+    }
+
+    bool active = false;
+    float gain = 0.0f, normalise = 1.0f;
+    std::array<State, maxChannels> states {};
+};
+
+} // namespace autocomp
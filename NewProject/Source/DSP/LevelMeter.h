@@ -0,0 +1,128 @@
+/*
+  ==============================================================================
+
+    LevelMeter.h
+
+    Input and output level and gain reduction, from the audio thread to one
+    reader (the editor's timer). The audio thread measures each block with
+    BlockLevels and calls publish() once: a handful of relaxed atomic
+    operations, no locks, no queue. Peaks and the deepest gain reduction are
+    held until the reader takes them, so nothing between two reads is
+    missed however slowly the reader polls. RMS covers exactly the audio
+    since the previous read, from running totals the reader differences.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "SimdKernels.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace autocomp
+{
+
+struct LevelReading
+{
+    float inputPeak = 0.0f;         // linear, highest since the last read
+    float inputRms = 0.0f;          // linear, over all channels since the last read
+    float outputPeak = 0.0f;
+    float outputRms = 0.0f;
+    float gainReduction = 0.0f;     // dB (0 or more), deepest since the last read
+    bool hasNewAudio = false;       // any block published since the last read
+};
+
+//==============================================================================
+// One block's measurements, accumulated slice by slice on the audio thread
+struct BlockLevels
+{
+    float inputPeak = 0.0f, outputPeak = 0.0f;
+    double inputSquares = 0.0, outputSquares = 0.0;
+
+    template <typename SampleType>
+    void addInput(const SampleType* const* channels, int numChannels, int numSamples) noexcept
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+            simd::accumulatePeakAndPower(channels[channel], numSamples, inputPeak, inputSquares);
+    }
+
+    template <typename SampleType>
+    void addOutput(const SampleType* const* channels, int numChannels, int numSamples) noexcept
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+            simd::accumulatePeakAndPower(channels[channel], numSamples, outputPeak, outputSquares);
+    }
+};
+
+//==============================================================================
+class LevelMeter
+{
+public:
+    // Audio thread. numSamples counts every channel (channels x frames).
+    void publish(const BlockLevels& block, int numSamples, float gainReductionDb) noexcept
+    {
+        hold(inputPeak, block.inputPeak);
+        hold(outputPeak, block.outputPeak);
+        hold(gainReduction, gainReductionDb);
+
+        // Only this thread writes the totals; the sample count goes last so
+        // a reader never sees it ahead of the energy it counts
+        inputTotal += block.inputSquares;
+        outputTotal += block.outputSquares;
+        sampleTotal += numSamples;
+        publishedInput.store(inputTotal, std::memory_order_relaxed);
+        publishedOutput.store(outputTotal, std::memory_order_relaxed);
+        publishedSamples.store(sampleTotal, std::memory_order_release);
+    }
+
+    // Reader thread (one only): everything since the previous read
+    LevelReading read() noexcept
+    {
+        const auto samples = publishedSamples.load(std::memory_order_acquire);
+        const auto input = publishedInput.load(std::memory_order_relaxed);
+        const auto output = publishedOutput.load(std::memory_order_relaxed);
+
+        LevelReading reading;
+        reading.inputPeak = inputPeak.exchange(0.0f, std::memory_order_relaxed);
+        reading.outputPeak = outputPeak.exchange(0.0f, std::memory_order_relaxed);
+        reading.gainReduction = gainReduction.exchange(0.0f, std::memory_order_relaxed);
+
+        const auto newSamples = samples - lastSamples;
+        reading.hasNewAudio = newSamples > 0.0;
+
+        if (reading.hasNewAudio)
+        {
+            reading.inputRms = static_cast<float>(std::sqrt(std::max(input - lastInput, 0.0) / newSamples));
+            reading.outputRms = static_cast<float>(std::sqrt(std::max(output - lastOutput, 0.0) / newSamples));
+        }
+
+        lastSamples = samples;
+        lastInput = input;
+        lastOutput = output;
+        return reading;
+    }
+
+private:
+    // The writer only ever raises a held value (compare-exchange, so a read
+    // in between is seen) and the reader takes it with an exchange: a value
+    // is never lost or reported twice
+    static void hold(std::atomic<float>& held, float value) noexcept
+    {
+        auto current = held.load(std::memory_order_relaxed);
+
+        while (value > current && ! held.compare_exchange_weak(current, value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    std::atomic<float> inputPeak { 0.0f }, outputPeak { 0.0f }, gainReduction { 0.0f };
+    std::atomic<double> publishedInput { 0.0 }, publishedOutput { 0.0 }, publishedSamples { 0.0 };
+
+    double inputTotal = 0.0, outputTotal = 0.0, sampleTotal = 0.0;     // audio thread
+    double lastInput = 0.0, lastOutput = 0.0, lastSamples = 0.0;       // reader
+};
+
+} // namespace autocomp
@@ -0,0 +1,113 @@
+/*
+  ==============================================================================
+
+    LinkGroups.h
+
+    Which channels share a detector. Every channel either belongs to one
+    link group, whose members all get the same gain from the loudest of
+    them, or is excluded: it is not detected and passes at unity gain (an
+    LFE channel, say). Fully linked is one group, unlinked one group per
+    channel. Fixed-size storage, so changing groups never allocates.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+
+namespace autocomp
+{
+
+class LinkGroups
+{
+public:
+    static constexpr int maxChannels = 16;
+    static constexpr int excluded = -1;
+
+    static LinkGroups linked() noexcept
+    {
+        LinkGroups groups;
+        groups.assign(nullptr, 0);
+        return groups;
+    }
+
+    static LinkGroups unlinked() noexcept
+    {
+        std::array<int, maxChannels> identity {};
+
+        for (int channel = 0; channel < maxChannels; ++channel)
+            identity[static_cast<size_t>(channel)] = channel;
+
+        LinkGroups groups;
+        groups.assign(identity.data(), maxChannels);
+        return groups;
+    }
+
+    LinkGroups() noexcept { assign(nullptr, 0); }
+
+    // One entry per channel: any group id, or excluded. Ids only need to
+    // match between channels; they are renumbered 0.. in order of first use.
+    // Channels past numChannels join group 0.
+    void assign(const int* groupOfChannel, int numChannels) noexcept
+    {
+        std::array<int, maxChannels> ids {};
+        numGroups = 0;
+        groupSizes.fill(0);
+
+        for (int channel = 0; channel < maxChannels; ++channel)
+        {
+            const auto id = channel < numChannels ? groupOfChannel[channel] : 0;
+            auto& group = groupOf[static_cast<size_t>(channel)];
+
+            if (id == excluded)
+            {
+                group = excluded;
+                continue;
+            }
+
+            const auto end = ids.begin() + numGroups;
+            const auto found = std::find(ids.begin(), end, id);
+            group = static_cast<int>(found - ids.begin());
+
+            if (found == end)
+                ids[static_cast<size_t>(numGroups++)] = id;
+
+            members[static_cast<size_t>(group)][static_cast<size_t>(groupSizes[static_cast<size_t>(group)]++)] = channel;
+        }
+    }
+
+    int getNumGroups() const noexcept { return numGroups; }
+
+    // Group of a channel, or excluded
+    int getGroup(int channel) const noexcept { return groupOf[static_cast<size_t>(channel)]; }
+
+    // Members of a group among the first numChannels channels, ascending.
+    // Returns how many were written to channels.
+    int getMembers(int group, int numChannels, int* channels) const noexcept
+    {
+        int count = 0;
+
+        for (int i = 0; i < groupSizes[static_cast<size_t>(group)]; ++i)
+        {
+            const auto channel = members[static_cast<size_t>(group)][static_cast<size_t>(i)];
+
+            if (channel < numChannels)
+                channels[count++] = channel;
+        }
+
+        return count;
+    }
+
+    bool operator== (const LinkGroups& other) const noexcept { return groupOf == other.groupOf; }
+    bool operator!= (const LinkGroups& other) const noexcept { return groupOf != other.groupOf; }
+
+private:
+    std::array<int, maxChannels> groupOf {};
+    std::array<std::array<int, maxChannels>, maxChannels> members {};
+    std::array<int, maxChannels> groupSizes {};
+    int numGroups = 0;
+};
+
+} // namespace autocomp
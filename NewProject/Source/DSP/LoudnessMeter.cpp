@@ -0,0 +1,318 @@
+/*
+  ==============================================================================
+
+    LoudnessMeter.cpp
+
+  ==============================================================================
+*/
+
+#include "LoudnessMeter.h"
+#include "SimdKernels.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace autocomp
+{
+
+void LoudnessMeter::prepare(double sampleRate, int numChannels)
+{
+    const auto pi = 3.141592653589793;
+
+    // Stage 1: high shelf, +4 dB above ~1.7 kHz (head effects)
+    {
+        const auto f0 = 1681.974450955533, gainDb = 3.999843853973347, q = 0.7071752369554196;
+        const auto k = std::tan(pi * f0 / sampleRate);
+        const auto vh = std::pow(10.0, gainDb / 20.0);
+        const auto vb = std::pow(vh, 0.4996667741545416);
+        const auto a0 = 1.0 + k / q + k * k;
+
+        shelf = { static_cast<float>((vh + vb * k / q + k * k) / a0),
+                  static_cast<float>(2.0 * (k * k - vh) / a0),
+                  static_cast<float>((vh - vb * k / q + k * k) / a0),
+                  static_cast<float>(2.0 * (k * k - 1.0) / a0),
+                  static_cast<float>((1.0 - k / q + k * k) / a0) };
+    }
+
+    // Stage 2: RLB high-pass at ~38 Hz
+    {
+        const auto f0 = 38.13547087602444, q = 0.5003270373238773;
+        const auto k = std::tan(pi * f0 / sampleRate);
+        const auto a0 = 1.0 + k / q + k * k;
+
+        highPass = { 1.0f, -2.0f, 1.0f,
+                     static_cast<float>(2.0 * (k * k - 1.0) / a0),
+                     static_cast<float>((1.0 - k / q + k * k) / a0) };
+    }
+
+    hopLength = std::max(static_cast<int>(std::lround(0.1 * sampleRate)), 1);
+    numPreparedChannels = std::max(numChannels, 1);
+    laneGroups.assign(static_cast<size_t>((numPreparedChannels + LaneGroup::numLanes - 1) / LaneGroup::numLanes), {});
+    reset();
+}
+
+void LoudnessMeter::reset()
+{
+    for (auto& group : laneGroups)
+    {
+        group.s1.fill(0.0f);
+        group.s2.fill(0.0f);
+        group.h1.fill(0.0f);
+        group.h2.fill(0.0f);
+    }
+
+    hopFill = 0;
+    hopEnergy = 0.0;
+    hopEnergies.fill(0.0);
+    hopIndex = 0;
+    hopsSeen = 0;
+    momentarySum = shortTermSum = 0.0;
+    momentary = shortTerm = floorLufs;
+
+    resetIntegrated();
+}
+
+void LoudnessMeter::resetIntegrated() noexcept
+{
+    blockCounts.fill(0);
+    blockEnergies.fill(0.0);
+    integrated = floorLufs;
+}
+
+void LoudnessMeter::setChannelWeight(int channel, float weight) noexcept
+{
+    if (channel >= 0 && channel < numPreparedChannels)
+        laneGroups[static_cast<size_t>(channel / LaneGroup::numLanes)].weight[static_cast<size_t>(channel % LaneGroup::numLanes)] = weight;
+}
+
+float LoudnessMeter::energyToLufs(double energy) noexcept
+{
+    return energy > 1e-10 ? static_cast<float>(-0.691 + 10.0 * std::log10(energy)) : floorLufs;
+}
+
+//==============================================================================
+void LoudnessMeter::process(const float* const* channels, int numChannels, int numSamples) noexcept
+{
+    constexpr auto numLanes = LaneGroup::numLanes;
+    numChannels = std::min(numChannels, numPreparedChannels);
+
+    if (numChannels <= 0)
+        return;
+
+    // Groups of four channels as lanes, the last one's spare lanes fed
+    // silence. A padded group costs about what one channel does on its
+    // own, so only a single channel runs unvectorised.
+    const auto numLaneGroups = numChannels == 1 ? 0 : (numChannels + numLanes - 1) / numLanes;
+    const float* sources[numLanes];
+
+    for (int offset = 0; offset < numSamples;)
+    {
+        const auto count = std::min(numSamples - offset, hopLength - hopFill);
+
+        for (int index = 0; index < numLaneGroups; ++index)
+        {
+            const auto first = index * numLanes;
+            const auto numSources = std::min(numChannels - first, numLanes);
+
+            for (int lane = 0; lane < numSources; ++lane)
+                sources[lane] = channels[first + lane] + offset;
+
+            hopEnergy += filterAndSumLanes(laneGroups[static_cast<size_t>(index)], sources, numSources, count);
+        }
+
+        if (numLaneGroups == 0)
+            hopEnergy += laneGroups[0].weight[0] * filterAndSum(laneGroups[0], 0, channels[0] + offset, count);
+
+        offset += count;
+        hopFill += count;
+
+        if (hopFill == hopLength)
+            finishHop();
+    }
+}
+
+namespace
+{
+    // Flush denormals once per call instead of per sample
+    float flushDenormal(float value) noexcept { return std::abs(value) < 1e-15f ? 0.0f : value; }
+}
+
+double LoudnessMeter::filterAndSumLanes(LaneGroup& group, const float* const* sources, int numSources,
+                                        int numSamples) const noexcept
+{
+    // The same fused biquads as filterAndSum(), four channels per
+    // instruction: the recursion is serial along time, not across channels
+    using namespace simd;
+    constexpr auto numLanes = LaneGroup::numLanes;
+    constexpr int chunkSize = 256;
+
+    const auto sb0 = splat4(shelf.b0), sb1 = splat4(shelf.b1), sb2 = splat4(shelf.b2);
+    const auto sa1 = splat4(shelf.a1), sa2 = splat4(shelf.a2);
+    const auto hb0 = splat4(highPass.b0), hb1 = splat4(highPass.b1), hb2 = splat4(highPass.b2);
+    const auto ha1 = splat4(highPass.a1), ha2 = splat4(highPass.a2);
+    const auto weight = load4(group.weight.data());
+
+    auto s1 = load4(group.s1.data()), s2 = load4(group.s2.data());
+    auto h1 = load4(group.h1.data()), h2 = load4(group.h2.data());
+
+    alignas(16) float frames[chunkSize * numLanes];
+    alignas(16) float laneSums[numLanes];
+    double sum = 0.0;
+
+    for (int start = 0; start < numSamples; start += chunkSize)
+    {
+        const auto count = std::min(chunkSize, numSamples - start);
+
+        // Channels to lanes: frame i of every channel side by side
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            if (lane < numSources)
+                for (int i = 0; i < count; ++i)
+                    frames[i * numLanes + lane] = sources[lane][start + i];
+            else
+                for (int i = 0; i < count; ++i)
+                    frames[i * numLanes + lane] = 0.0f;
+        }
+
+        // Squares summed in float per chunk, then in double
+        auto squares = splat4(0.0f);
+
+        for (int i = 0; i < count; ++i)
+        {
+            const auto x = load4(frames + i * numLanes);
+
+            const auto shelved = add4(mul4(sb0, x), s1);
+            s1 = sub4(add4(mul4(sb1, x), s2), mul4(sa1, shelved));
+            s2 = sub4(mul4(sb2, x), mul4(sa2, shelved));
+
+            const auto y = add4(mul4(hb0, shelved), h1);
+            h1 = sub4(add4(mul4(hb1, shelved), h2), mul4(ha1, y));
+            h2 = sub4(mul4(hb2, shelved), mul4(ha2, y));
+
+            squares = add4(squares, mul4(y, y));
+        }
+
+        store4(laneSums, mul4(squares, weight));
+
+        for (auto laneSum : laneSums)
+            sum += static_cast<double>(laneSum);
+    }
+
+    store4(group.s1.data(), s1);
+    store4(group.s2.data(), s2);
+    store4(group.h1.data(), h1);
+    store4(group.h2.data(), h2);
+
+    for (auto* state : { &group.s1, &group.s2, &group.h1, &group.h2 })
+        for (auto& value : *state)
+            value = flushDenormal(value);
+
+    return sum;
+}
+
+double LoudnessMeter::filterAndSum(LaneGroup& group, int lane, const float* source, int numSamples) const noexcept
+{
+    // Both stages fused in one pass with the state in registers; the
+    // recursion is serial, so this is as fast as a scalar IIR gets
+    const auto index = static_cast<size_t>(lane);
+    auto s1 = group.s1[index], s2 = group.s2[index], h1 = group.h1[index], h2 = group.h2[index];
+    double sum = 0.0;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const auto x = source[i];
+
+        const auto shelved = shelf.b0 * x + s1;
+        s1 = shelf.b1 * x + s2 - shelf.a1 * shelved;
+        s2 = shelf.b2 * x - shelf.a2 * shelved;
+
+        const auto y = highPass.b0 * shelved + h1;
+        h1 = highPass.b1 * shelved + h2 - highPass.a1 * y;
+        h2 = highPass.b2 * shelved - highPass.a2 * y;
+
+        sum += static_cast<double>(y * y);
+    }
+
+    group.s1[index] = flushDenormal(s1);
+    group.s2[index] = flushDenormal(s2);
+    group.h1[index] = flushDenormal(h1);
+    group.h2[index] = flushDenormal(h2);
+
+    return sum;
+}
+
+void LoudnessMeter::finishHop() noexcept
+{
+    const auto energy = hopEnergy / hopLength;
+    hopEnergy = 0.0;
+    hopFill = 0;
+
+    // Running sums: add the new hop, drop the one leaving each window
+    const auto leavingMomentary = hopEnergies[static_cast<size_t>((hopIndex + shortTermHops - momentaryHops) % shortTermHops)];
+    momentarySum += energy - leavingMomentary;
+    shortTermSum += energy - hopEnergies[static_cast<size_t>(hopIndex)];
+    hopEnergies[static_cast<size_t>(hopIndex)] = energy;
+
+    // Recompute once per ring wrap so rounding errors cannot build up
+    if (++hopIndex == shortTermHops)
+    {
+        hopIndex = 0;
+        shortTermSum = 0.0;
+
+        for (auto e : hopEnergies)
+            shortTermSum += e;
+
+        momentarySum = 0.0;
+
+        for (int i = 1; i <= momentaryHops; ++i)
+            momentarySum += hopEnergies[static_cast<size_t>(shortTermHops - i)];
+    }
+
+    ++hopsSeen;
+
+    const auto momentaryEnergy = std::max(momentarySum, 0.0) / momentaryHops;
+    momentary = energyToLufs(momentaryEnergy);
+    shortTerm = energyToLufs(std::max(shortTermSum, 0.0) / shortTermHops);
+
+    // Every hop completes a 400 ms gating block once four hops are in
+    if (hopsSeen >= momentaryHops && momentary >= absoluteGate)
+    {
+        const auto bin = std::clamp(static_cast<int>((momentary - absoluteGate) * 10.0f), 0, histogramBins - 1);
+        ++blockCounts[static_cast<size_t>(bin)];
+        blockEnergies[static_cast<size_t>(bin)] += momentaryEnergy;
+        updateIntegrated();
+    }
+}
+
+void LoudnessMeter::updateIntegrated() noexcept
+{
+    // Absolute gate: everything in the histogram is above -70 LUFS already
+    double energy = 0.0;
+    std::uint64_t count = 0;
+
+    for (int bin = 0; bin < histogramBins; ++bin)
+    {
+        energy += blockEnergies[static_cast<size_t>(bin)];
+        count += blockCounts[static_cast<size_t>(bin)];
+    }
+
+    if (count == 0)
+        return;
+
+    // Relative gate, resolved to the 0.1 LU bins
+    const auto gate = energyToLufs(energy / static_cast<double>(count)) + relativeGate;
+    const auto firstBin = std::clamp(static_cast<int>(std::ceil((gate - absoluteGate) * 10.0f)), 0, histogramBins);
+
+    energy = 0.0;
+    count = 0;
+
+    for (int bin = firstBin; bin < histogramBins; ++bin)
+    {
+        energy += blockEnergies[static_cast<size_t>(bin)];
+        count += blockCounts[static_cast<size_t>(bin)];
+    }
+
+    integrated = count > 0 ? energyToLufs(energy / static_cast<double>(count)) : floorLufs;
+}
+
+} // namespace autocomp
@@ -0,0 +1,108 @@
+/*
+  ==============================================================================
+
+    LoudnessMeter.h
+
+    ITU-R BS.1770-4 / EBU R128 loudness: K-weighting (high shelf + RLB
+    high-pass, coefficients derived for any sample rate), momentary (400 ms),
+    short-term (3 s) and gated integrated loudness, in LUFS.
+
+    The weighted energy is summed per 100 ms hop; the 400 ms and 3 s windows
+    are running sums over a ring of hop energies, so the cost per sample is
+    the two biquads and one multiply-add regardless of the window lengths.
+    The biquads run on four channels at once, one per simd::Vec4 lane, so a
+    stereo or 5.1 bed costs about what one channel does.
+    Gating blocks (400 ms, 75% overlap) go into a fixed 0.1 LU histogram, so
+    integrated loudness needs no growing storage. Memory is allocated in
+    prepare() only.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace autocomp
+{
+
+struct LoudnessReading
+{
+    float momentary = -100.0f;          // LUFS
+    float shortTerm = -100.0f;
+    float integrated = -100.0f;
+};
+
+//==============================================================================
+class LoudnessMeter
+{
+public:
+    static constexpr float absoluteGate = -70.0f;       // LUFS
+    static constexpr float relativeGate = -10.0f;       // LU below the ungated mean
+    static constexpr float floorLufs = -100.0f;         // reported for silence
+
+    void prepare(double sampleRate, int numChannels);
+    void reset();
+
+    // Clears the integrated loudness only
+    void resetIntegrated() noexcept;
+
+    // Per-channel weighting: 1 for L/R/C, 1.41 for surrounds, 0 for the LFE
+    void setChannelWeight(int channel, float weight) noexcept;
+
+    void process(const float* const* channels, int numChannels, int numSamples) noexcept;
+
+    float getMomentary() const noexcept  { return momentary; }
+    float getShortTerm() const noexcept  { return shortTerm; }
+    float getIntegrated() const noexcept { return integrated; }
+    LoudnessReading getReading() const noexcept { return { momentary, shortTerm, integrated }; }
+
+    static float energyToLufs(double energy) noexcept;
+
+private:
+    struct Biquad
+    {
+        float b0, b1, b2, a1, a2;
+    };
+
+    // Filter state for four channels, one per lane
+    struct LaneGroup
+    {
+        static constexpr int numLanes = 4;
+
+        alignas(16) std::array<float, numLanes> s1 {}, s2 {};  // shelf, transposed direct form II
+        alignas(16) std::array<float, numLanes> h1 {}, h2 {};  // high-pass
+        alignas(16) std::array<float, numLanes> weight { 1.0f, 1.0f, 1.0f, 1.0f };
+    };
+
+    double filterAndSumLanes(LaneGroup& group, const float* const* sources, int numSources, int numSamples) const noexcept;
+    double filterAndSum(LaneGroup& group, int lane, const float* source, int numSamples) const noexcept;
+    void finishHop() noexcept;
+    void updateIntegrated() noexcept;
+
+    static constexpr int momentaryHops = 4;
+    static constexpr int shortTermHops = 30;
+    static constexpr int histogramBins = 800;           // -70 to +10 LUFS in 0.1 LU
+
+    Biquad shelf {}, highPass {};
+    std::vector<LaneGroup> laneGroups;      // channel c is lane c % 4 of group c / 4
+    int numPreparedChannels = 1;
+
+    int hopLength = 4800;
+    int hopFill = 0;
+    double hopEnergy = 0.0;
+
+    std::array<double, shortTermHops> hopEnergies {};   // mean weighted square per hop
+    int hopIndex = 0;
+    std::int64_t hopsSeen = 0;
+    double momentarySum = 0.0, shortTermSum = 0.0;
+
+    std::array<std::uint32_t, histogramBins> blockCounts {};
+    std::array<double, histogramBins> blockEnergies {};
+
+    float momentary = floorLufs, shortTerm = floorLufs, integrated = floorLufs;
+};
+
+} // namespace autocomp
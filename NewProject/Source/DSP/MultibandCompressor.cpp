@@ -0,0 +1,494 @@
+/*
+  ==============================================================================
+
+    MultibandCompressor.cpp
+
+  ==============================================================================
+*/
+
+#include "MultibandCompressor.h"
+#include "SimdKernels.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace autocomp
+{
+
+namespace
+{
+    constexpr double butterworthDamping = 1.4142135623730951;  // k = 1 / Q
+
+    static_assert(MultibandCompressor::maxBands == 4, "the gain stage keeps one band per simd::Vec4 lane");
+
+    template <typename SampleType>
+    SampleType flushDenormal(SampleType value) noexcept
+    {
+        return std::abs(value) < static_cast<SampleType>(1e-15) ? SampleType {} : value;
+    }
+}
+
+//==============================================================================
+template <typename SampleType>
+void Crossover<SampleType>::prepare(int numChannels)
+{
+    channelStates.assign(static_cast<size_t>(std::max(numChannels, 1)), {});
+}
+
+template <typename SampleType>
+void Crossover<SampleType>::reset() noexcept
+{
+    std::fill(channelStates.begin(), channelStates.end(), ChannelState {});
+}
+
+template <typename SampleType>
+void Crossover<SampleType>::setFrequencies(int newNumBands, const float* frequencies, double sampleRate) noexcept
+{
+    numBands = std::clamp(newNumBands, 1, maxBands);
+
+    const auto pi = 3.141592653589793;
+    auto lowest = 10.0;
+
+    for (int i = 0; i < numBands - 1; ++i)
+    {
+        const auto frequency = std::min(std::max(static_cast<double>(frequencies[i]), lowest), 0.45 * sampleRate);
+        const auto g = std::tan(pi * frequency / sampleRate);
+
+        sections[static_cast<size_t>(i)] = { static_cast<SampleType>(g),
+                                             static_cast<SampleType>(1.0 / (1.0 + g * (g + butterworthDamping))) };
+        lowest = frequency;
+    }
+}
+
+template <typename SampleType>
+void Crossover<SampleType>::process(int channel, const SampleType* input, SampleType* const* bands, int numSamples) noexcept
+{
+    auto& state = channelStates[static_cast<size_t>(channel)];
+
+    if (numBands == 1)
+    {
+        if (input != bands[0])
+            std::copy(input, input + numSamples, bands[0]);
+
+        return;
+    }
+
+    // Peel the bands off from the bottom: each split's high output feeds the next
+    const auto* source = input;
+
+    for (int i = 0; i < numBands - 1; ++i)
+    {
+        split(sections[static_cast<size_t>(i)], state.splits[static_cast<size_t>(i)],
+              source, bands[i], bands[i + 1], numSamples);
+        source = bands[i + 1];
+    }
+
+    // Each lower band picks up the allpass phase of the splits above it, so
+    // all bands sum to the same allpass of the input
+    for (int band = 0; band < numBands - 2; ++band)
+        for (int i = band + 1; i < numBands - 1; ++i)
+            allpass(sections[static_cast<size_t>(i)],
+                    state.allpasses[static_cast<size_t>(band)][static_cast<size_t>(i)],
+                    bands[band], numSamples);
+}
+
+template <typename SampleType>
+void Crossover<SampleType>::split(const Section& section, Split& state, const SampleType* input,
+                                  SampleType* low, SampleType* high, int numSamples) const noexcept
+{
+    // Linkwitz-Riley: a second Butterworth pass on each output of the first.
+    // In place (input == low) is fine: each sample is read before it is written.
+    const auto g = section.g, h = section.h, k = static_cast<SampleType>(butterworthDamping);
+    auto a1 = state.first.s1, a2 = state.first.s2;
+    auto l1 = state.low.s1, l2 = state.low.s2;
+    auto h1 = state.high.s1, h2 = state.high.s2;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const auto x = input[i];
+
+        const auto hp = (x - (g + k) * a1 - a2) * h;
+        const auto bp = g * hp + a1;
+        a1 = g * hp + bp;
+        const auto lp = g * bp + a2;
+        a2 = g * bp + lp;
+
+        const auto lowHp = (lp - (g + k) * l1 - l2) * h;
+        const auto lowBp = g * lowHp + l1;
+        l1 = g * lowHp + lowBp;
+        const auto lowLp = g * lowBp + l2;
+        l2 = g * lowBp + lowLp;
+
+        const auto highHp = (hp - (g + k) * h1 - h2) * h;
+        const auto highBp = g * highHp + h1;
+        h1 = g * highHp + highBp;
+        h2 = g * highBp + (g * highBp + h2);
+
+        low[i] = lowLp;
+        high[i] = highHp;
+    }
+
+    state.first = { flushDenormal(a1), flushDenormal(a2) };
+    state.low = { flushDenormal(l1), flushDenormal(l2) };
+    state.high = { flushDenormal(h1), flushDenormal(h2) };
+}
+
+template <typename SampleType>
+void Crossover<SampleType>::allpass(const Section& section, State& state, SampleType* data, int numSamples) const noexcept
+{
+    // Same poles as the split; x - 2k * band-pass is the matching allpass
+    const auto g = section.g, h = section.h, k = static_cast<SampleType>(butterworthDamping);
+    auto s1 = state.s1, s2 = state.s2;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const auto x = data[i];
+
+        const auto hp = (x - (g + k) * s1 - s2) * h;
+        const auto bp = g * hp + s1;
+        s1 = g * hp + bp;
+        s2 = g * bp + (g * bp + s2);
+
+        data[i] = x - 2 * k * bp;
+    }
+
+    state = { flushDenormal(s1), flushDenormal(s2) };
+}
+
+//==============================================================================
+template class Crossover<float>;
+template class Crossover<double>;
+
+//==============================================================================
+void MultibandCompressor::prepare(int numChannels, int maximumBlockSize, int maximumLookahead, bool doublePrecision)
+{
+    numPreparedChannels = std::clamp(numChannels, 1, maxChannels);
+    maximumBlock = std::max(maximumBlockSize, 1);
+
+    const auto bandSamples = static_cast<size_t>(numPreparedChannels * maxBands * maximumBlock);
+
+    auto prepareSplit = [&](auto& split, bool used)
+    {
+        split.detectorCrossover.prepare(numPreparedChannels);
+        split.audioCrossover.prepare(numPreparedChannels);
+        split.detectorBands.assign(used ? bandSamples : 0, 0);
+        split.audioBands.assign(used ? bandSamples : 0, 0);
+    };
+
+    prepareSplit(singleSplit, ! doublePrecision);
+    prepareSplit(doubleSplit, doublePrecision);
+    gains.assign(bandSamples, 1.0f);
+    levels.assign(static_cast<size_t>(maxBands * maximumBlock), 0.0f);
+
+    peaks.resize(static_cast<size_t>(numPreparedChannels * maxBands));
+
+    for (auto& peak : peaks)
+        peak.prepare(maximumLookahead + 1);
+
+    lookaheadSamples = std::min(lookaheadSamples, maximumLookahead);
+    reset();
+}
+
+void MultibandCompressor::reset() noexcept
+{
+    for (auto* crossover : { &singleSplit.detectorCrossover, &singleSplit.audioCrossover })
+        crossover->reset();
+
+    for (auto* crossover : { &doubleSplit.detectorCrossover, &doubleSplit.audioCrossover })
+        crossover->reset();
+
+    for (auto& peak : peaks)
+        peak.reset();
+
+    for (auto& envelope : envelopes)
+        envelope.fill(1.0f);    // unity gain, as in the broadband path
+
+    current = target;
+    rampRemaining = 0;
+}
+
+void MultibandCompressor::setLayout(int newNumBands, const float* newCrossoverFrequencies) noexcept
+{
+    numBands = std::clamp(newNumBands, 1, maxBands);
+
+    for (int i = 0; i < numBands - 1; ++i)
+        crossoverFrequencies[static_cast<size_t>(i)] = newCrossoverFrequencies[i];
+
+    updateCrossovers();
+    reset();
+}
+
+void MultibandCompressor::setProcessingRate(double newRate, int newRampLength) noexcept
+{
+    processingRate = newRate;
+    rampLength = std::max(newRampLength, 1);
+    updateCrossovers();
+    reset();
+}
+
+void MultibandCompressor::updateCrossovers() noexcept
+{
+    for (auto* crossover : { &singleSplit.detectorCrossover, &singleSplit.audioCrossover })
+        crossover->setFrequencies(numBands, crossoverFrequencies.data(), processingRate);
+
+    for (auto* crossover : { &doubleSplit.detectorCrossover, &doubleSplit.audioCrossover })
+        crossover->setFrequencies(numBands, crossoverFrequencies.data(), processingRate);
+}
+
+void MultibandCompressor::setLookahead(int numSamples) noexcept
+{
+    lookaheadSamples = std::max(numSamples, 0);
+
+    for (auto& peak : peaks)
+        peak.setWindowLength(lookaheadSamples + 1);
+
+    // The engine has just cleared its delay line; start the audio split afresh too
+    singleSplit.audioCrossover.reset();
+    doubleSplit.audioCrossover.reset();
+}
+
+void MultibandCompressor::setParameters(const BandParameters& newParameters, bool smooth) noexcept
+{
+    target = newParameters;
+
+    if (! smooth)
+    {
+        current = target;
+        rampRemaining = 0;
+        return;
+    }
+
+    const auto scale = 1.0f / static_cast<float>(rampLength);
+
+    for (size_t band = 0; band < static_cast<size_t>(maxBands); ++band)
+    {
+        // Unused lanes sit at neverReached on both ends; keep them there
+        step.thresholdLog2[band] = target.thresholdLog2[band] == current.thresholdLog2[band]
+                                     ? 0.0f : (target.thresholdLog2[band] - current.thresholdLog2[band]) * scale;
+        step.slope[band] = (target.slope[band] - current.slope[band]) * scale;
+        step.attack[band] = (target.attack[band] - current.attack[band]) * scale;
+        step.release[band] = (target.release[band] - current.release[band]) * scale;
+        step.makeup[band] = (target.makeup[band] - current.makeup[band]) * scale;
+    }
+
+    rampRemaining = rampLength;
+}
+
+float MultibandCompressor::getEnvelope(int band, int group) const noexcept
+{
+    return envelopes[static_cast<size_t>(std::clamp(group, 0, maxChannels - 1))]
+                    [static_cast<size_t>(std::clamp(band, 0, maxBands - 1))];
+}
+
+void MultibandCompressor::release(int numSamples) noexcept
+{
+    for (size_t band = 0; band < static_cast<size_t>(numBands); ++band)
+    {
+        const auto decay = static_cast<float>(std::pow(static_cast<double>(current.release[band]), numSamples));
+
+        for (auto& envelope : envelopes)
+            envelope[band] = 1.0f - (1.0f - envelope[band]) * decay;
+    }
+}
+
+//==============================================================================
+template <typename SampleType>
+void MultibandCompressor::computeGains(const SampleType* const* channels, int numChannels, int numSamples,
+                                       const LinkGroups& groups) noexcept
+{
+    auto& split = getSplit<SampleType>();
+    assert(! split.detectorBands.empty());
+    numChannels = std::min(numChannels, numPreparedChannels);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        if (groups.getGroup(channel) == LinkGroups::excluded)
+            continue;
+
+        SampleType* bands[maxBands];
+
+        for (int band = 0; band < numBands; ++band)
+            bands[band] = getBand(split.detectorBands, channel, band);
+
+        split.detectorCrossover.process(channel, channels[channel], bands, numSamples);
+    }
+
+    const auto glideSamples = std::min(rampRemaining, numSamples);
+    int members[maxChannels];
+
+    // One detector per link group
+    for (int detector = 0; detector < groups.getNumGroups(); ++detector)
+    {
+        const auto count = groups.getMembers(detector, numChannels, members);
+
+        if (count == 0)
+            continue;
+
+        // Band levels, one contiguous run per band (SIMD across samples)
+        for (int band = 0; band < numBands; ++band)
+        {
+            auto* level = levels.data() + band * maximumBlock;
+            const SampleType* bandChannels[maxChannels];
+
+            for (int i = 0; i < count; ++i)
+                bandChannels[i] = getBand(split.detectorBands, members[i], band);
+
+            simd::absMaxAcrossChannels(bandChannels, count, 0, level, numSamples);
+
+            if (lookaheadSamples > 0)
+                peaks[static_cast<size_t>(detector * maxBands + band)].process(level, level, numSamples);
+        }
+
+        // Interleave into frames of maxBands lanes; unused lanes stay silent
+        auto* frames = gains.data() + detector * maxBands * maximumBlock;
+
+        for (int band = 0; band < maxBands; ++band)
+        {
+            const auto* level = levels.data() + band * maximumBlock;
+
+            for (int i = 0; i < numSamples; ++i)
+                frames[i * maxBands + band] = band < numBands ? level[i] : 0.0f;
+        }
+
+        runGainStage(frames, numSamples, glideSamples, envelopes[static_cast<size_t>(detector)]);
+    }
+
+    // Every detector used the same stretch of the glide; advance it once
+    if (glideSamples > 0)
+    {
+        rampRemaining -= glideSamples;
+
+        if (rampRemaining == 0)
+        {
+            current = target;
+        }
+        else
+        {
+            const auto samples = static_cast<float>(glideSamples);
+
+            for (size_t band = 0; band < static_cast<size_t>(maxBands); ++band)
+            {
+                current.thresholdLog2[band] += step.thresholdLog2[band] * samples;
+                current.slope[band] += step.slope[band] * samples;
+                current.attack[band] += step.attack[band] * samples;
+                current.release[band] += step.release[band] * samples;
+                current.makeup[band] += step.makeup[band] * samples;
+            }
+        }
+    }
+}
+
+void MultibandCompressor::runGainStage(float* frames, int numSamples, int glideSamples, Lanes& envelope) const noexcept
+{
+    // One Vec4 per parameter, one lane per band: every band steps through
+    // the serial envelope recursion in the same instructions
+    using namespace simd;
+
+    auto env = load4(envelope.data());
+    auto threshold = load4(current.thresholdLog2.data());
+    auto ratioSlope = load4(current.slope.data());
+    auto attack = load4(current.attack.data());
+    auto release = load4(current.release.data());
+    auto makeup = load4(current.makeup.data());
+
+    const auto floor = splat4(1e-6f);
+    const auto zero = splat4(0.0f);
+
+    auto tick = [&](float* frame)
+    {
+        const auto levelLog2 = fastLog2x4(max4(load4(frame), floor));
+        const auto overshoot = max4(sub4(levelLog2, threshold), zero);
+        const auto targetGain = fastExp2x4(mul4(overshoot, ratioSlope));
+        const auto coeff = selectLess4(targetGain, env, attack, release);
+        env = add4(targetGain, mul4(sub4(env, targetGain), coeff));
+        store4(frame, mul4(env, makeup));
+    };
+
+    int i = 0;
+
+    if (glideSamples > 0)
+    {
+        const auto thresholdStep = load4(step.thresholdLog2.data());
+        const auto slopeStep = load4(step.slope.data());
+        const auto attackStep = load4(step.attack.data());
+        const auto releaseStep = load4(step.release.data());
+        const auto makeupStep = load4(step.makeup.data());
+
+        for (; i < glideSamples; ++i)
+        {
+            tick(frames + i * maxBands);
+
+            threshold = add4(threshold, thresholdStep);
+            ratioSlope = add4(ratioSlope, slopeStep);
+            attack = add4(attack, attackStep);
+            release = add4(release, releaseStep);
+            makeup = add4(makeup, makeupStep);
+        }
+
+        // The ramp ends inside this block: exactly on the target from here
+        if (glideSamples == rampRemaining)
+        {
+            threshold = load4(target.thresholdLog2.data());
+            ratioSlope = load4(target.slope.data());
+            attack = load4(target.attack.data());
+            release = load4(target.release.data());
+            makeup = load4(target.makeup.data());
+        }
+    }
+
+    for (; i < numSamples; ++i)
+        tick(frames + i * maxBands);
+
+    store4(envelope.data(), env);
+}
+
+template <typename SampleType>
+void MultibandCompressor::applyGains(SampleType* const* channels, int numChannels, int numSamples,
+                                     const LinkGroups& groups, bool detectorWasAudio) noexcept
+{
+    auto& split = getSplit<SampleType>();
+    numChannels = std::min(numChannels, numPreparedChannels);
+
+    // Without lookahead or sidechain the audio is what the detector already split
+    const auto splitAudio = lookaheadSamples > 0 || ! detectorWasAudio;
+    auto& bandBuffer = splitAudio ? split.audioBands : split.detectorBands;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        // Excluded channels are left as they are, unsplit
+        const auto group = groups.getGroup(channel);
+
+        if (group == LinkGroups::excluded)
+            continue;
+
+        SampleType* bands[maxBands];
+
+        for (int band = 0; band < numBands; ++band)
+            bands[band] = getBand(bandBuffer, channel, band);
+
+        if (splitAudio)
+            split.audioCrossover.process(channel, channels[channel], bands, numSamples);
+
+        const auto* frames = gains.data() + group * maxBands * maximumBlock;
+        auto* output = channels[channel];
+
+        for (int i = 0; i < numSamples; ++i)
+            output[i] = bands[0][i] * frames[i * maxBands];
+
+        for (int band = 1; band < numBands; ++band)
+        {
+            const auto* source = bands[band];
+
+            for (int i = 0; i < numSamples; ++i)
+                output[i] += source[i] * frames[i * maxBands + band];
+        }
+    }
+}
+
+template void MultibandCompressor::computeGains(const float* const*, int, int, const LinkGroups&) noexcept;
+template void MultibandCompressor::computeGains(const double* const*, int, int, const LinkGroups&) noexcept;
+template void MultibandCompressor::applyGains(float* const*, int, int, const LinkGroups&, bool) noexcept;
+template void MultibandCompressor::applyGains(double* const*, int, int, const LinkGroups&, bool) noexcept;
+
+} // namespace autocomp
@@ -0,0 +1,194 @@
+/*
+  ==============================================================================
+
+    MultibandCompressor.h
+
+    Band-split compression for CompressorEngine. A tree of 4th order
+    Linkwitz-Riley crossovers splits the signal into up to four bands that
+    sum back to an allpass of the input (flat magnitude, no latency). Each
+    band has its own detector, gain computer and envelope. The gain stage
+    is a structure of arrays with one lane per band, so the four bands step
+    through the serial envelope recursion together in one SIMD register
+    instead of in four scalar loops. All memory is allocated in prepare().
+    The band split follows the audio's precision (float or double); the
+    levels, gains and envelopes are float.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "LinkGroups.h"
+#include "SlidingMaximum.h"
+
+#include <array>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace autocomp
+{
+
+template <typename SampleType>
+class Crossover
+{
+public:
+    static constexpr int maxBands = 4;
+
+    void prepare(int numChannels);
+    void reset() noexcept;
+
+    // numBands - 1 ascending crossover frequencies in Hz. Frequencies too
+    // close to Nyquist are pulled below it.
+    void setFrequencies(int numBands, const float* frequencies, double sampleRate) noexcept;
+    int getNumBands() const noexcept { return numBands; }
+
+    // Splits one channel into numBands outputs; input may alias bands[0]
+    void process(int channel, const SampleType* input, SampleType* const* bands, int numSamples) noexcept;
+
+private:
+    // 2nd order Butterworth state variable filter (trapezoidal integrators);
+    // one pass gives the low-pass and high-pass outputs together
+    struct Section
+    {
+        SampleType g {}, h {};      // tan(pi f / fs), 1 / (1 + g (g + k))
+    };
+
+    struct State
+    {
+        SampleType s1 {}, s2 {};
+    };
+
+    struct Split
+    {
+        State first, low, high;
+    };
+
+    struct ChannelState
+    {
+        std::array<Split, maxBands - 1> splits;
+        std::array<std::array<State, maxBands - 1>, maxBands> allpasses;    // [band][split]
+    };
+
+    void split(const Section& section, Split& state, const SampleType* input,
+               SampleType* low, SampleType* high, int numSamples) const noexcept;
+    void allpass(const Section& section, State& state, SampleType* data, int numSamples) const noexcept;
+
+    int numBands = 1;
+    std::array<Section, maxBands - 1> sections;
+    std::vector<ChannelState> channelStates;
+};
+
+//==============================================================================
+// Gain computer and envelope constants, one lane per band (processing rate).
+// Unused lanes never reduce the gain.
+struct BandParameters
+{
+    static constexpr int maxBands = Crossover<float>::maxBands;
+    static constexpr float neverReached = std::numeric_limits<float>::max();
+
+    alignas(16) std::array<float, maxBands> thresholdLog2 { neverReached, neverReached, neverReached, neverReached };
+    alignas(16) std::array<float, maxBands> slope {};
+    alignas(16) std::array<float, maxBands> attack {};
+    alignas(16) std::array<float, maxBands> release {};
+    alignas(16) std::array<float, maxBands> makeup { 1.0f, 1.0f, 1.0f, 1.0f };
+};
+
+//==============================================================================
+class MultibandCompressor
+{
+public:
+    static constexpr int maxBands = BandParameters::maxBands;
+    static constexpr int maxChannels = 16;
+
+    // maximumBlockSize and maximumLookahead are at the processing rate.
+    // Band buffers are sized for one precision: process in that one.
+    void prepare(int numChannels, int maximumBlockSize, int maximumLookahead, bool doublePrecision = false);
+    void reset() noexcept;
+
+    // 1 to maxBands, with numBands - 1 ascending crossover frequencies.
+    // Clears the filter and envelope state; never allocates.
+    void setLayout(int newNumBands, const float* crossoverFrequencies) noexcept;
+    int getNumBands() const noexcept { return numBands; }
+
+    // New crossover coefficients and glide length for a new processing rate
+    void setProcessingRate(double newRate, int newRampLength) noexcept;
+
+    // Peak hold for the detectors, matching the engine's audio delay
+    void setLookahead(int numSamples) noexcept;
+
+    // Jumps to the new parameters, or glides there over the ramp length
+    void setParameters(const BandParameters& newParameters, bool smooth) noexcept;
+    bool isSmoothing() const noexcept { return rampRemaining > 0; }
+
+    // Moves every envelope on by numSamples of silence (a unity target) in
+    // closed form, the same as the gain stage would. Not while gliding.
+    void release(int numSamples) noexcept;
+
+    // Stage 1: splits the undelayed input and computes the per-band gains,
+    // one detector per link group; excluded channels are not split
+    template <typename SampleType>
+    void computeGains(const SampleType* const* channels, int numChannels, int numSamples, const LinkGroups& groups) noexcept;
+
+    // Stage 2: splits the (delayed) audio, applies the band gains and sums
+    // the bands back in place. detectorWasAudio: computeGains() read these
+    // same channels (no external sidechain), so without lookahead its band
+    // split is reused. Excluded channels pass unchanged.
+    template <typename SampleType>
+    void applyGains(SampleType* const* channels, int numChannels, int numSamples, const LinkGroups& groups,
+                    bool detectorWasAudio = true) noexcept;
+
+    float getEnvelope(int band, int group = 0) const noexcept;
+
+private:
+    using Lanes = std::array<float, maxBands>;
+
+    // The detector splits its input; with lookahead or a sidechain the audio
+    // is split again, otherwise the detector's bands are reused
+    template <typename SampleType>
+    struct BandSplit
+    {
+        Crossover<SampleType> detectorCrossover, audioCrossover;
+        std::vector<SampleType> detectorBands;  // numChannels x maxBands x maximumBlock
+        std::vector<SampleType> audioBands;     // same layout
+    };
+
+    template <typename SampleType>
+    BandSplit<SampleType>& getSplit() noexcept
+    {
+        if constexpr (std::is_same_v<SampleType, double>)
+            return doubleSplit;
+        else
+            return singleSplit;
+    }
+
+    template <typename SampleType>
+    SampleType* getBand(std::vector<SampleType>& buffer, int channel, int band) noexcept
+    {
+        return buffer.data() + (channel * maxBands + band) * maximumBlock;
+    }
+
+    void updateCrossovers() noexcept;
+    void runGainStage(float* frames, int numSamples, int glideSamples, Lanes& envelope) const noexcept;
+
+    int numBands = 1;
+    int numPreparedChannels = 0;
+    int maximumBlock = 0;
+    int lookaheadSamples = 0;
+    double processingRate = 44100.0;
+    std::array<float, maxBands - 1> crossoverFrequencies {};
+
+    BandSplit<float> singleSplit;
+    BandSplit<double> doubleSplit;              // only sized when prepared for double
+    std::vector<float> levels;                  // maxBands x maximumBlock, one detector at a time
+    std::vector<float> gains;                   // groups x maximumBlock x maxBands, band-interleaved
+    std::vector<SlidingMaximum> peaks;          // [group * maxBands + band]
+
+    alignas(16) std::array<Lanes, maxChannels> envelopes {};
+
+    BandParameters current, target, step;
+    int rampLength = 1;
+    int rampRemaining = 0;
+};
+
+} // namespace autocomp
@@ -0,0 +1,254 @@
+/*
+  ==============================================================================
+
+    Oversampler.cpp
+
+  ==============================================================================
+*/
+
+#include "Oversampler.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace autocomp
+{
+
+namespace
+{
+    // Zeroth-order modified Bessel function, for the Kaiser window
+    double besselI0(double x)
+    {
+        double sum = 1.0, term = 1.0;
+
+        for (int k = 1; k < 50 && term > 1e-12 * sum; ++k)
+        {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+        }
+
+        return sum;
+    }
+}
+
+//==============================================================================
+template <typename SampleType>
+void HalfBandStage<SampleType>::prepare(int newHalfLength, double kaiserBeta, int numChannels, int maximumInputSamples)
+{
+    halfLength = std::max(newHalfLength, 1);
+    historyLength = 2 * halfLength - 1;
+
+    // Windowed-sinc half-band: centre tap 0.5, odd offsets d from the centre
+    // 0.5 * sinc(d / 2), even offsets zero. The even phase is the odd offsets
+    // +-1, +-3, ... laid out over the last 2P inputs.
+    const auto pi = 3.141592653589793;
+    const auto centre = static_cast<double>(historyLength);
+    std::vector<double> sideTaps(static_cast<size_t>(halfLength));
+    double sum = 0.0;
+
+    for (int j = 0; j < halfLength; ++j)
+    {
+        const auto d = 2.0 * j + 1.0;
+        const auto ratio = d / (centre + 1.0);
+        const auto window = besselI0(kaiserBeta * std::sqrt(1.0 - ratio * ratio)) / besselI0(kaiserBeta);
+        sideTaps[static_cast<size_t>(j)] = 0.5 * std::sin(pi * d / 2.0) / (pi * d / 2.0) * window;
+        sum += 2.0 * sideTaps[static_cast<size_t>(j)];
+    }
+
+    coefficients.resize(static_cast<size_t>(2 * halfLength));
+
+    for (int i = 0; i < 2 * halfLength; ++i)
+    {
+        const auto j = i < halfLength ? halfLength - 1 - i : i - halfLength;
+        coefficients[static_cast<size_t>(i)] = static_cast<SampleType>(sideTaps[static_cast<size_t>(j)] / sum);
+    }
+
+    stride = historyLength + std::max(maximumInputSamples, 1);
+    upLines.assign(static_cast<size_t>(numChannels * stride), SampleType {});
+    evenLines.assign(static_cast<size_t>(numChannels * stride), SampleType {});
+    oddLines.assign(static_cast<size_t>(numChannels * stride), SampleType {});
+    accumulator.assign(static_cast<size_t>(std::max(maximumInputSamples, 1)), SampleType {});
+}
+
+template <typename SampleType>
+void HalfBandStage<SampleType>::reset() noexcept
+{
+    std::fill(upLines.begin(), upLines.end(), SampleType {});
+    std::fill(evenLines.begin(), evenLines.end(), SampleType {});
+    std::fill(oddLines.begin(), oddLines.end(), SampleType {});
+}
+
+template <typename SampleType>
+void HalfBandStage<SampleType>::upsample(int channel, const SampleType* input, SampleType* output, int numSamples) noexcept
+{
+    auto* line = upLines.data() + channel * stride;
+    auto* current = line + historyLength;
+    auto* acc = accumulator.data();
+    std::copy(input, input + numSamples, current);
+
+    // Even outputs: the symmetric filter, one tap at a time across the block
+    std::fill(acc, acc + numSamples, SampleType {});
+
+    for (int tap = 0; tap < 2 * halfLength; ++tap)
+    {
+        const auto c = coefficients[static_cast<size_t>(tap)];
+        const auto* x = current - tap;
+
+        for (int i = 0; i < numSamples; ++i)
+            acc[i] += c * x[i];
+    }
+
+    // Odd outputs: the centre tap, i.e. the input delayed by P - 1
+    const auto* delayed = current - (halfLength - 1);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        output[2 * i] = acc[i];
+        output[2 * i + 1] = delayed[i];
+    }
+
+    std::copy(line + numSamples, line + numSamples + historyLength, line);
+}
+
+template <typename SampleType>
+void HalfBandStage<SampleType>::downsample(int channel, const SampleType* input, SampleType* output, int numSamples) noexcept
+{
+    auto* even = evenLines.data() + channel * stride;
+    auto* odd = oddLines.data() + channel * stride;
+    auto* evenCurrent = even + historyLength;
+    auto* oddCurrent = odd + historyLength;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        evenCurrent[i] = input[2 * i];
+        oddCurrent[i] = input[2 * i + 1];
+    }
+
+    // Centre tap on the odd phase (delayed by P), then the even phase taps
+    const auto* centre = oddCurrent - halfLength;
+
+    for (int i = 0; i < numSamples; ++i)
+        output[i] = static_cast<SampleType>(0.5) * centre[i];
+
+    for (int tap = 0; tap < 2 * halfLength; ++tap)
+    {
+        const auto c = static_cast<SampleType>(0.5) * coefficients[static_cast<size_t>(tap)];
+        const auto* x = evenCurrent - tap;
+
+        for (int i = 0; i < numSamples; ++i)
+            output[i] += c * x[i];
+    }
+
+    std::copy(even + numSamples, even + numSamples + historyLength, even);
+    std::copy(odd + numSamples, odd + numSamples + historyLength, odd);
+}
+
+//==============================================================================
+template <typename SampleType>
+void Oversampler<SampleType>::prepare(int numChannels, int maximumBlockSize)
+{
+    numPreparedChannels = std::clamp(numChannels, 1, maxChannels);
+    maximumBlock = std::max(maximumBlockSize, 1);
+
+    // First stage carries the audio band and needs the steep transition;
+    // the second only has to reject images far above it
+    stages[0].prepare(12, 8.0, numPreparedChannels, maximumBlock);
+    stages[1].prepare(6, 8.0, numPreparedChannels, 2 * maximumBlock);
+
+    twiceBuffer.assign(static_cast<size_t>(numPreparedChannels * 2 * maximumBlock), SampleType {});
+    fourTimesBuffer.assign(static_cast<size_t>(numPreparedChannels * 4 * maximumBlock), SampleType {});
+    reset();
+}
+
+template <typename SampleType>
+void Oversampler<SampleType>::reset() noexcept
+{
+    for (auto& stage : stages)
+        stage.reset();
+}
+
+template <typename SampleType>
+bool Oversampler<SampleType>::setFactor(int newFactor) noexcept
+{
+    if ((newFactor != 1 && newFactor != 2 && newFactor != 4) || newFactor == factor)
+        return false;
+
+    factor = newFactor;
+    reset();
+    return true;
+}
+
+template <typename SampleType>
+double Oversampler<SampleType>::getLatencyInSamples() const noexcept
+{
+    // Each stage delays by getDelay() at its higher rate, once on the way
+    // up and once on the way down
+    switch (factor)
+    {
+        case 2:  return stages[0].getDelay();
+        case 4:  return stages[0].getDelay() + stages[1].getDelay() / 2.0;
+        default: return 0.0;
+    }
+}
+
+template <typename SampleType>
+SampleType* const* Oversampler<SampleType>::upsample(const SampleType* const* input, int numChannels, int numSamples) noexcept
+{
+    numChannels = std::min(numChannels, numPreparedChannels);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        auto* twice = twiceBuffer.data() + ch * 2 * maximumBlock;
+        auto* fourTimes = fourTimesBuffer.data() + ch * 4 * maximumBlock;
+
+        if (factor == 1)
+        {
+            std::copy(input[ch], input[ch] + numSamples, twice);
+            outputs[static_cast<size_t>(ch)] = twice;
+            continue;
+        }
+
+        stages[0].upsample(ch, input[ch], twice, numSamples);
+
+        if (factor == 2)
+        {
+            outputs[static_cast<size_t>(ch)] = twice;
+            continue;
+        }
+
+        stages[1].upsample(ch, twice, fourTimes, 2 * numSamples);
+        outputs[static_cast<size_t>(ch)] = fourTimes;
+    }
+
+    return outputs.data();
+}
+
+template <typename SampleType>
+void Oversampler<SampleType>::downsample(SampleType* const* output, int numChannels, int numSamples) noexcept
+{
+    numChannels = std::min(numChannels, numPreparedChannels);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        auto* twice = twiceBuffer.data() + ch * 2 * maximumBlock;
+        auto* fourTimes = fourTimesBuffer.data() + ch * 4 * maximumBlock;
+
+        if (factor == 1)
+        {
+            std::copy(twice, twice + numSamples, output[ch]);
+            continue;
+        }
+
+        if (factor == 4)
+            stages[1].downsample(ch, fourTimes, twice, 2 * numSamples);
+
+        stages[0].downsample(ch, twice, output[ch], numSamples);
+    }
+}
+
+template class HalfBandStage<float>;
+template class HalfBandStage<double>;
+template class Oversampler<float>;
+template class Oversampler<double>;
+
+} // namespace autocomp
@@ -0,0 +1,93 @@
+/*
+  ==============================================================================
+
+    Oversampler.h
+
+    1x/2x/4x oversampling with cascaded linear-phase half-band FIR stages in
+    polyphase form: the upsampler's odd phase is a plain delay and the
+    decimator's odd phase a single tap, so only the symmetric even phase is
+    filtered, at the lower rate. Each phase is computed tap by tap across
+    the whole block (an axpy over contiguous memory), which the compiler
+    vectorises. Buffers for 4x are allocated in prepare(); switching the
+    factor only clears the filter state. Templated on the sample type, so
+    double-precision audio is filtered in double throughout.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <vector>
+
+namespace autocomp
+{
+
+// One 2x stage: upsampling and decimation filters, per channel
+template <typename SampleType>
+class HalfBandStage
+{
+public:
+    // halfLength P gives 4P - 1 taps and a delay of 2P - 1 samples at the
+    // higher rate in each direction
+    void prepare(int halfLength, double kaiserBeta, int numChannels, int maximumInputSamples);
+    void reset() noexcept;
+
+    // numSamples frames in, 2 * numSamples out
+    void upsample(int channel, const SampleType* input, SampleType* output, int numSamples) noexcept;
+
+    // 2 * numSamples frames in, numSamples out
+    void downsample(int channel, const SampleType* input, SampleType* output, int numSamples) noexcept;
+
+    int getDelay() const noexcept { return 2 * halfLength - 1; }
+
+private:
+    int halfLength = 1;
+    int historyLength = 1;              // 2P - 1
+    int stride = 0;                         // per-channel line length
+    std::vector<SampleType> coefficients;   // 2P even-phase taps, summing to 1
+    std::vector<SampleType> upLines;        // history + input, per channel
+    std::vector<SampleType> evenLines;      // decimator even phase, per channel
+    std::vector<SampleType> oddLines;       // decimator odd phase, per channel
+    std::vector<SampleType> accumulator;
+};
+
+//==============================================================================
+template <typename SampleType>
+class Oversampler
+{
+public:
+    static constexpr int maxFactor = 4;
+
+    void prepare(int numChannels, int maximumBlockSize);
+    void reset() noexcept;
+
+    // 1, 2 or 4; anything else is ignored. Clears the filter state, never
+    // allocates. Returns true if the factor changed.
+    bool setFactor(int newFactor) noexcept;
+    int getFactor() const noexcept { return factor; }
+
+    // Round-trip (up + down) delay in base-rate samples
+    double getLatencyInSamples() const noexcept;
+
+    // Upsamples numSamples frames into the internal buffers and returns
+    // one pointer per channel to numSamples * factor frames
+    SampleType* const* upsample(const SampleType* const* input, int numChannels, int numSamples) noexcept;
+
+    // Decimates the buffers returned by upsample() into output
+    void downsample(SampleType* const* output, int numChannels, int numSamples) noexcept;
+
+private:
+    static constexpr int maxChannels = 16;
+
+    std::array<HalfBandStage<SampleType>, 2> stages;
+    int factor = 1;
+    int numPreparedChannels = 0;
+    int maximumBlock = 0;
+
+    std::vector<SampleType> twiceBuffer;        // numChannels x 2 * maximumBlockSize
+    std::vector<SampleType> fourTimesBuffer;    // numChannels x 4 * maximumBlockSize
+    std::array<SampleType*, maxChannels> outputs {};
+};
+
+} // namespace autocomp
@@ -0,0 +1,218 @@
+/*
+  ==============================================================================
+
+    ProgramBank.h
+
+    The programs the host lists: the factory programs (the five compression
+    levels, constexpr, read-only) followed by a few user programs that can
+    be stored from the current settings and renamed. Everything is fixed
+    size and nothing is synchronised: reading, selecting, storing and
+    renaming all belong to one thread (the message thread, in the plugin).
+
+    The user programs are saved with the session, after the parameter
+    chunk, in the same style (all little-endian):
+
+        magic     4 bytes   "CUMP"
+        version   2 bytes   (currently 1)
+        count     2 bytes   number of user programs
+        current   2 bytes   selected program
+        programs  52 bytes each: name (32 bytes, zero padded), threshold,
+                  ratio, attack, release and makeup (float)
+        checksum  4 bytes   FNV-1a over everything before it
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "CompressorPresets.h"
+#include "StateChunk.h"
+
+#include <cstdio>
+
+namespace autocomp
+{
+
+class ProgramBank
+{
+public:
+    static constexpr int numFactoryPrograms = static_cast<int>(presets::factoryPrograms.size());
+    static constexpr int numUserPrograms = 8;
+    static constexpr int numPrograms = numFactoryPrograms + numUserPrograms;
+    static constexpr int maxNameLength = 31;    // bytes of UTF-8
+
+    static constexpr std::uint8_t magic[4] = { 'C', 'U', 'M', 'P' };
+    static constexpr std::uint16_t version = 1;
+    static constexpr std::size_t programSize = maxNameLength + 1 + 5 * 4;
+    static constexpr std::size_t serialisedSize = 10 + programSize * numUserPrograms + state::checksumSize;
+
+    ProgramBank() noexcept
+    {
+        for (int i = 0; i < numUserPrograms; ++i)
+            std::snprintf(userPrograms[i].name, sizeof(userPrograms[i].name), "User %d", i + 1);
+    }
+
+    static constexpr bool isFactory(int index) noexcept { return index >= 0 && index < numFactoryPrograms; }
+    static constexpr bool isUser(int index) noexcept { return index >= numFactoryPrograms && index < numPrograms; }
+
+    // "" for an index out of range
+    const char* getName(int index) const noexcept
+    {
+        if (isFactory(index))
+            return presets::factoryPrograms[static_cast<std::size_t>(index)].name;
+
+        return isUser(index) ? userPrograms[index - numFactoryPrograms].name : "";
+    }
+
+    bool getSettings(int index, CompressorSettings& result) const noexcept
+    {
+        if (isFactory(index))
+            result = presets::factoryPrograms[static_cast<std::size_t>(index)].settings;
+        else if (isUser(index))
+            result = userPrograms[index - numFactoryPrograms].settings;
+        else
+            return false;
+
+        return true;
+    }
+
+    int getCurrent() const noexcept { return current; }
+
+    // Goes up whenever a user program is stored or renamed, or the bank is
+    // read, so a program list can tell it is out of date (selecting a
+    // program doesn't count)
+    std::uint32_t getChangeCount() const noexcept { return changeCount; }
+
+    bool setCurrent(int index) noexcept
+    {
+        if (index < 0 || index >= numPrograms)
+            return false;
+
+        current = index;
+        return true;
+    }
+
+    // User programs only; factory programs are read-only
+    bool store(int index, const CompressorSettings& settings) noexcept
+    {
+        if (! isUser(index))
+            return false;
+
+        userPrograms[index - numFactoryPrograms].settings = settings;
+        ++changeCount;
+        return true;
+    }
+
+    // Truncated to maxNameLength bytes, never inside a UTF-8 character
+    bool rename(int index, const char* name) noexcept
+    {
+        if (! isUser(index) || name == nullptr)
+            return false;
+
+        auto& target = userPrograms[index - numFactoryPrograms].name;
+        auto length = std::strlen(name);
+
+        if (length > maxNameLength)
+        {
+            length = maxNameLength;
+
+            while (length > 0 && (static_cast<std::uint8_t>(name[length]) & 0xc0) == 0x80)
+                --length;
+        }
+
+        std::memcpy(target, name, length);
+        std::memset(target + length, 0, sizeof(target) - length);
+        ++changeCount;
+        return true;
+    }
+
+    //==============================================================================
+    // Returns the bytes written (serialisedSize), or 0 if dest is too small
+    std::size_t write(void* dest, std::size_t capacity) const noexcept
+    {
+        if (capacity < serialisedSize)
+            return 0;
+
+        auto* out = static_cast<std::uint8_t*>(dest);
+        std::memcpy(out, magic, sizeof(magic));
+        state::detail::put16(out + 4, version);
+        state::detail::put16(out + 6, numUserPrograms);
+        state::detail::put16(out + 8, static_cast<std::uint16_t>(current));
+
+        auto* entry = out + 10;
+
+        for (const auto& program : userPrograms)
+        {
+            std::memcpy(entry, program.name, sizeof(program.name));
+            entry += sizeof(program.name);
+
+            for (auto value : { program.settings.threshold, program.settings.ratio, program.settings.attack,
+                                program.settings.release, program.settings.makeupGain })
+            {
+                std::uint32_t bits;
+                std::memcpy(&bits, &value, sizeof(bits));
+                state::detail::put32(entry, bits);
+                entry += 4;
+            }
+        }
+
+        state::detail::put32(entry, state::detail::fnv(out, static_cast<std::size_t>(entry - out)));
+        return serialisedSize;
+    }
+
+    // All or nothing: false (and the bank unchanged) if the data is not a
+    // bank, or is truncated, corrupt or from a newer version. Extra user
+    // programs in the data are ignored, missing ones keep their contents.
+    bool read(const void* data, std::size_t size) noexcept
+    {
+        const auto* in = static_cast<const std::uint8_t*>(data);
+
+        if (in == nullptr || size < 10 + state::checksumSize || std::memcmp(in, magic, sizeof(magic)) != 0
+             || state::detail::get16(in + 4) > version)
+            return false;
+
+        const int count = state::detail::get16(in + 6);
+        const auto checked = 10 + programSize * static_cast<std::size_t>(count);
+
+        if (size < checked + state::checksumSize || state::detail::get32(in + checked) != state::detail::fnv(in, checked))
+            return false;
+
+        const int selected = state::detail::get16(in + 8);
+        current = selected < numPrograms ? selected : 0;
+
+        const auto* entry = in + 10;
+
+        for (int i = 0; i < count && i < numUserPrograms; ++i, entry += programSize)
+        {
+            auto& program = userPrograms[i];
+            std::memcpy(program.name, entry, maxNameLength);
+            program.name[maxNameLength] = 0;
+
+            float values[5];
+
+            for (int v = 0; v < 5; ++v)
+            {
+                const auto bits = state::detail::get32(entry + sizeof(program.name) + 4 * static_cast<std::size_t>(v));
+                std::memcpy(&values[v], &bits, sizeof(bits));
+            }
+
+            program.settings = { values[0], values[1], values[2], values[3], values[4] };
+        }
+
+        ++changeCount;
+        return true;
+    }
+
+private:
+    struct UserProgram
+    {
+        char name[maxNameLength + 1] = {};
+        CompressorSettings settings = presets::compressionLevels[2];
+    };
+
+    UserProgram userPrograms[numUserPrograms];
+    int current = 0;
+    std::uint32_t changeCount = 0;
+};
+
+} // namespace autocomp
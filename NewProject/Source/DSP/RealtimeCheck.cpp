@@ -0,0 +1,335 @@
+/*
+  ==============================================================================
+
+    RealtimeCheck.cpp
+
+    The replacement allocation and lock functions. Only compiled in with
+    CUMPRESSOR_REALTIME_CHECKS=1, into executables (tests, Standalone):
+    inside a plugin loaded by a host the host's own allocator and libc
+    usually win the symbol lookup.
+
+    operator new/delete are replaced everywhere. The nothrow and array
+    new forms forward to these in the standard library; the sized and
+    array deletes are defined here as well (GCC's -Wsized-deallocation
+    asks for them) and forward to the two below. The malloc
+    family and pthread_mutex_lock are glibc only. pthread_mutex_trylock
+    is deliberately not hooked: a try-lock never blocks.
+
+  ==============================================================================
+*/
+
+#include "RealtimeCheck.h"
+
+#if CUMPRESSOR_REALTIME_CHECKS
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#if defined(__GLIBC__)
+ #include <cxxabi.h>
+ #include <dlfcn.h>
+ #include <execinfo.h>
+ #include <pthread.h>
+#endif
+
+#if defined(_WIN32)
+ #include <malloc.h>
+#endif
+
+#if defined(__GNUC__)
+ #define CUMPRESSOR_INITIAL_EXEC __attribute__((tls_model("initial-exec")))
+#else
+ #define CUMPRESSOR_INITIAL_EXEC
+#endif
+
+namespace autocomp::realtime
+{
+
+namespace
+{
+    constexpr int maxRecords = 32;
+    constexpr int maxFrames = 24;
+
+    struct Record
+    {
+        Violation kind;
+        const char* function;
+        std::size_t size;
+        int numFrames;
+        void* frames[maxFrames];
+    };
+
+    // Written only by the hooks (no allocation possible there)
+    Record records[maxRecords];
+    std::atomic<int> numViolations { 0 };
+
+    // Trivial, so reading it never runs a TLS initialiser (which could allocate)
+    struct ThreadState
+    {
+        int depth;          // ScopedCheck nesting
+        int unchecked;      // inside a hook or the report: let allocations through
+    };
+
+    thread_local ThreadState threadState CUMPRESSOR_INITIAL_EXEC {};
+
+    struct Unchecked
+    {
+        Unchecked() noexcept { ++threadState.unchecked; }
+        ~Unchecked() { --threadState.unchecked; }
+    };
+
+    void record(Violation kind, const char* function, std::size_t size) noexcept
+    {
+        if (threadState.depth == 0 || threadState.unchecked > 0)
+            return;
+
+        const Unchecked unchecked;  // the unwinder may allocate on first use
+        const auto index = numViolations.fetch_add(1);
+
+        if (index >= maxRecords)
+            return;
+
+        auto& entry = records[index];
+        entry.kind = kind;
+        entry.function = function;
+        entry.size = size;
+#if defined(__GLIBC__)
+        entry.numFrames = backtrace(entry.frames, maxFrames);
+#else
+        entry.numFrames = 0;
+#endif
+    }
+
+#if defined(__GLIBC__)
+    using MutexLock = int (*)(pthread_mutex_t*);
+    std::atomic<MutexLock> nextMutexLock { nullptr };
+
+    MutexLock getNextMutexLock() noexcept
+    {
+        auto function = nextMutexLock.load(std::memory_order_acquire);
+
+        if (function == nullptr)
+        {
+            function = reinterpret_cast<MutexLock>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+            nextMutexLock.store(function, std::memory_order_release);
+        }
+
+        return function;
+    }
+
+    // Loads the unwinder and resolves the real lock before anything is checked
+    const bool warmedUp = []
+    {
+        void* frames[1];
+        backtrace(frames, 1);
+        return getNextMutexLock() != nullptr;
+    }();
+
+    // "binary(_ZN...+0x1c) [0x...]" -> "binary(autocomp::...+0x1c) [0x...]"
+    std::string demangle(const char* symbol)
+    {
+        std::string text(symbol);
+        const auto open = text.find('(');
+        const auto plus = text.find('+', open);
+
+        if (open == std::string::npos || plus == std::string::npos || plus == open + 1)
+            return text;
+
+        int status = 0;
+        auto* name = abi::__cxa_demangle(text.substr(open + 1, plus - open - 1).c_str(), nullptr, nullptr, &status);
+
+        if (status == 0 && name != nullptr)
+            text = text.substr(0, open + 1) + name + text.substr(plus);
+
+        std::free(name);
+        return text;
+    }
+#endif
+
+    const char* describe(Violation kind) noexcept
+    {
+        switch (kind)
+        {
+            case Violation::allocation:   return "allocation";
+            case Violation::deallocation: return "deallocation";
+            case Violation::lock:         return "lock";
+        }
+
+        return "";
+    }
+}
+
+//==============================================================================
+void enterScope() noexcept { ++threadState.depth; }
+void leaveScope() noexcept { --threadState.depth; }
+
+int getNumViolations() noexcept { return numViolations.load(); }
+void clearViolations() noexcept { numViolations.store(0); }
+
+std::string describeViolations()
+{
+    const Unchecked unchecked;
+    const auto total = numViolations.load();
+    std::string report = std::to_string(total) + " real-time violation(s)\n";
+
+    for (int i = 0; i < std::min(total, maxRecords); ++i)
+    {
+        const auto& entry = records[i];
+        report += "#" + std::to_string(i + 1) + " " + describe(entry.kind) + " in " + entry.function;
+
+        if (entry.size > 0)
+            report += " (" + std::to_string(entry.size) + " bytes)";
+
+        report += "\n";
+
+#if defined(__GLIBC__)
+        if (auto** symbols = backtrace_symbols(entry.frames, entry.numFrames))
+        {
+            for (int frame = 0; frame < entry.numFrames; ++frame)
+                report += "    " + demangle(symbols[frame]) + "\n";
+
+            std::free(symbols);
+        }
+#endif
+    }
+
+    if (total > maxRecords)
+        report += "... and " + std::to_string(total - maxRecords) + " more without call stacks\n";
+
+    return report;
+}
+
+} // namespace autocomp::realtime
+
+//==============================================================================
+using autocomp::realtime::Violation;
+
+void* operator new(std::size_t size)
+{
+    autocomp::realtime::record(Violation::allocation, "operator new", size);
+    const autocomp::realtime::Unchecked unchecked;
+
+    if (auto* memory = std::malloc(size > 0 ? size : 1))
+        return memory;
+
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    autocomp::realtime::record(Violation::allocation, "operator new", size);
+    const autocomp::realtime::Unchecked unchecked;
+    const auto bytes = size > 0 ? size : 1;
+
+#if defined(_WIN32)
+    if (auto* memory = _aligned_malloc(bytes, static_cast<std::size_t>(alignment)))
+        return memory;
+#else
+    void* memory = nullptr;
+
+    if (posix_memalign(&memory, std::max(static_cast<std::size_t>(alignment), sizeof(void*)), bytes) == 0)
+        return memory;
+#endif
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+    if (memory != nullptr)
+        autocomp::realtime::record(Violation::deallocation, "operator delete", 0);
+
+    const autocomp::realtime::Unchecked unchecked;
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+    if (memory != nullptr)
+        autocomp::realtime::record(Violation::deallocation, "operator delete", 0);
+
+    const autocomp::realtime::Unchecked unchecked;
+#if defined(_WIN32)
+    _aligned_free(memory);
+#else
+    std::free(memory);
+#endif
+}
+
+// Sized and array forms: the same two hooks
+void operator delete(void* memory, std::size_t) noexcept
+{
+    operator delete(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t alignment) noexcept
+{
+    operator delete(memory, alignment);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    operator delete(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+    operator delete(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t alignment) noexcept
+{
+    operator delete(memory, alignment);
+}
+
+void operator delete[](void* memory, std::size_t, std::align_val_t alignment) noexcept
+{
+    operator delete(memory, alignment);
+}
+
+#if defined(__GLIBC__)
+extern "C"
+{
+    void* __libc_malloc(std::size_t);
+    void* __libc_calloc(std::size_t, std::size_t);
+    void* __libc_realloc(void*, std::size_t);
+    void __libc_free(void*);
+
+    void* malloc(std::size_t size) noexcept
+    {
+        autocomp::realtime::record(Violation::allocation, "malloc", size);
+        return __libc_malloc(size);
+    }
+
+    void* calloc(std::size_t count, std::size_t size) noexcept
+    {
+        autocomp::realtime::record(Violation::allocation, "calloc", count * size);
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* memory, std::size_t size) noexcept
+    {
+        autocomp::realtime::record(Violation::allocation, "realloc", size);
+        return __libc_realloc(memory, size);
+    }
+
+    void free(void* memory) noexcept
+    {
+        if (memory != nullptr)
+            autocomp::realtime::record(Violation::deallocation, "free", 0);
+
+        __libc_free(memory);
+    }
+
+    int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept
+    {
+        autocomp::realtime::record(Violation::lock, "pthread_mutex_lock", 0);
+        return autocomp::realtime::getNextMutexLock()(mutex);
+    }
+}
+#endif
+
+#endif // CUMPRESSOR_REALTIME_CHECKS
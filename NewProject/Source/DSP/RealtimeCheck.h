@@ -0,0 +1,76 @@
+/*
+  ==============================================================================
+
+    RealtimeCheck.h
+
+    Audio-thread safety checks for debug and test builds. Built with
+    CUMPRESSOR_REALTIME_CHECKS=1, RealtimeCheck.cpp replaces operator
+    new/delete (and, on glibc, malloc/calloc/realloc/free and
+    pthread_mutex_lock, which std::mutex uses) with versions that record
+    a violation, with its call stack, whenever the calling thread is
+    inside a ScopedCheck. Other threads are never affected. Without the
+    flag ScopedCheck is empty, getNumViolations() is 0 and
+    RealtimeCheck.cpp compiles to nothing.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <string>
+
+#ifndef CUMPRESSOR_REALTIME_CHECKS
+ #define CUMPRESSOR_REALTIME_CHECKS 0
+#endif
+
+namespace autocomp::realtime
+{
+
+enum class Violation
+{
+    allocation,
+    deallocation,
+    lock
+};
+
+#if CUMPRESSOR_REALTIME_CHECKS
+
+constexpr bool enabled = true;
+
+// Scopes nest; only the outermost enter/leave pair matters
+void enterScope() noexcept;
+void leaveScope() noexcept;
+
+// Violations since the last clearViolations(), from any thread. Only the
+// first few keep their call stacks; the count covers all of them.
+int getNumViolations() noexcept;
+void clearViolations() noexcept;
+
+// Symbolised report of the recorded violations (allocates: call it
+// outside any scope, after processing has stopped)
+std::string describeViolations();
+
+#else
+
+constexpr bool enabled = false;
+
+inline void enterScope() noexcept {}
+inline void leaveScope() noexcept {}
+inline int getNumViolations() noexcept { return 0; }
+inline void clearViolations() noexcept {}
+inline std::string describeViolations() { return {}; }
+
+#endif
+
+// Marks the calling thread as real-time for its lifetime (processBlock)
+class ScopedCheck
+{
+public:
+    ScopedCheck() noexcept { enterScope(); }
+    ~ScopedCheck() { leaveScope(); }
+
+    ScopedCheck(const ScopedCheck&) = delete;
+    ScopedCheck& operator= (const ScopedCheck&) = delete;
+};
+
+} // namespace autocomp::realtime
@@ -0,0 +1,504 @@
+/*
+  ==============================================================================
+
+    SimdKernels.h
+
+    Small SIMD building blocks for the detector and gain stage. One
+    implementation is picked at compile time: AVX2, SSE2 or NEON, with a
+    scalar fallback. All loads/stores are unaligned, so callers can pass
+    any offset into a channel. The level and gain kernels also take double
+    audio; levels and gains themselves are always float.
+
+    Vec4 is a four-lane value for structure-of-arrays code where each lane
+    carries its own state (the multiband gain stage: one band per lane).
+    It is always 128 bits wide, SSE on x86 (AVX2 included) and NEON on ARM.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "FastMath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__AVX2__)
+ #include <immintrin.h>
+ #define AUTOCOMP_SIMD_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+ #include <emmintrin.h>
+ #define AUTOCOMP_SIMD_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+ #include <arm_neon.h>
+ #define AUTOCOMP_SIMD_NEON 1
+#endif
+
+namespace autocomp::simd
+{
+
+#if AUTOCOMP_SIMD_AVX2
+constexpr int width = 8;
+constexpr const char* instructionSet = "AVX2";
+#elif AUTOCOMP_SIMD_SSE2
+constexpr int width = 4;
+constexpr const char* instructionSet = "SSE2";
+#elif AUTOCOMP_SIMD_NEON
+constexpr int width = 4;
+constexpr const char* instructionSet = "NEON";
+#else
+constexpr int width = 1;
+constexpr const char* instructionSet = "scalar";
+#endif
+
+//==============================================================================
+// dest[i] = max over channels of |channels[c][offset + i]|
+// Every channel is read exactly once per frame.
+inline void absMaxAcrossChannels(const float* const* channels, int numChannels, int offset,
+                                 float* dest, int numSamples) noexcept
+{
+    int i = 0;
+
+#if AUTOCOMP_SIMD_AVX2
+    const auto signMask = _mm256_set1_ps(-0.0f);
+
+    for (; i + 8 <= numSamples; i += 8)
+    {
+        auto peak = _mm256_andnot_ps(signMask, _mm256_loadu_ps(channels[0] + offset + i));
+
+        for (int ch = 1; ch < numChannels; ++ch)
+            peak = _mm256_max_ps(peak, _mm256_andnot_ps(signMask, _mm256_loadu_ps(channels[ch] + offset + i)));
+
+        _mm256_storeu_ps(dest + i, peak);
+    }
+#elif AUTOCOMP_SIMD_SSE2
+    const auto signMask = _mm_set1_ps(-0.0f);
+
+    for (; i + 4 <= numSamples; i += 4)
+    {
+        auto peak = _mm_andnot_ps(signMask, _mm_loadu_ps(channels[0] + offset + i));
+
+        for (int ch = 1; ch < numChannels; ++ch)
+            peak = _mm_max_ps(peak, _mm_andnot_ps(signMask, _mm_loadu_ps(channels[ch] + offset + i)));
+
+        _mm_storeu_ps(dest + i, peak);
+    }
+#elif AUTOCOMP_SIMD_NEON
+    for (; i + 4 <= numSamples; i += 4)
+    {
+        auto peak = vabsq_f32(vld1q_f32(channels[0] + offset + i));
+
+        for (int ch = 1; ch < numChannels; ++ch)
+            peak = vmaxq_f32(peak, vabsq_f32(vld1q_f32(channels[ch] + offset + i)));
+
+        vst1q_f32(dest + i, peak);
+    }
+#endif
+
+    for (; i < numSamples; ++i)
+    {
+        auto peak = std::abs(channels[0][offset + i]);
+
+        for (int ch = 1; ch < numChannels; ++ch)
+            peak = std::max(peak, std::abs(channels[ch][offset + i]));
+
+        dest[i] = peak;
+    }
+}
+
+// dest[i] = |src[i]|
+inline void absolute(const float* src, float* dest, int numSamples) noexcept
+{
+    absMaxAcrossChannels(&src, 1, 0, dest, numSamples);
+}
+
+// dest[i] *= gain[i]
+inline void multiply(float* dest, const float* gain, int numSamples) noexcept
+{
+    int i = 0;
+
+#if AUTOCOMP_SIMD_AVX2
+    for (; i + 8 <= numSamples; i += 8)
+        _mm256_storeu_ps(dest + i, _mm256_mul_ps(_mm256_loadu_ps(dest + i), _mm256_loadu_ps(gain + i)));
+#elif AUTOCOMP_SIMD_SSE2
+    for (; i + 4 <= numSamples; i += 4)
+        _mm_storeu_ps(dest + i, _mm_mul_ps(_mm_loadu_ps(dest + i), _mm_loadu_ps(gain + i)));
+#elif AUTOCOMP_SIMD_NEON
+    for (; i + 4 <= numSamples; i += 4)
+        vst1q_f32(dest + i, vmulq_f32(vld1q_f32(dest + i), vld1q_f32(gain + i)));
+#endif
+
+    for (; i < numSamples; ++i)
+        dest[i] *= gain[i];
+}
+
+//==============================================================================
+// Double-precision audio against the float detector and gain stage
+
+// dest[i] = max over channels of |channels[c][offset + i]|, narrowed to float
+inline void absMaxAcrossChannels(const double* const* channels, int numChannels, int offset,
+                                 float* dest, int numSamples) noexcept
+{
+    int i = 0;
+
+#if AUTOCOMP_SIMD_AVX2
+    const auto signMask = _mm256_set1_pd(-0.0);
+
+    for (; i + 4 <= numSamples; i += 4)
+    {
+        auto peak = _mm256_andnot_pd(signMask, _mm256_loadu_pd(channels[0] + offset + i));
+
+        for (int ch = 1; ch < numChannels; ++ch)
+            peak = _mm256_max_pd(peak, _mm256_andnot_pd(signMask, _mm256_loadu_pd(channels[ch] + offset + i)));
+
+        _mm_storeu_ps(dest + i, _mm256_cvtpd_ps(peak));
+    }
+#elif AUTOCOMP_SIMD_SSE2
+    const auto signMask = _mm_set1_pd(-0.0);
+
+    for (; i + 4 <= numSamples; i += 4)
+    {
+        auto low = _mm_andnot_pd(signMask, _mm_loadu_pd(channels[0] + offset + i));
+        auto high = _mm_andnot_pd(signMask, _mm_loadu_pd(channels[0] + offset + i + 2));
+
+        for (int ch = 1; ch < numChannels; ++ch)
+        {
+            low = _mm_max_pd(low, _mm_andnot_pd(signMask, _mm_loadu_pd(channels[ch] + offset + i)));
+            high = _mm_max_pd(high, _mm_andnot_pd(signMask, _mm_loadu_pd(channels[ch] + offset + i + 2)));
+        }
+
+        _mm_storeu_ps(dest + i, _mm_movelh_ps(_mm_cvtpd_ps(low), _mm_cvtpd_ps(high)));
+    }
+#endif
+
+    for (; i < numSamples; ++i)
+    {
+        auto peak = std::abs(channels[0][offset + i]);
+
+        for (int ch = 1; ch < numChannels; ++ch)
+            peak = std::max(peak, std::abs(channels[ch][offset + i]));
+
+        dest[i] = static_cast<float>(peak);
+    }
+}
+
+inline void absolute(const double* src, float* dest, int numSamples) noexcept
+{
+    absMaxAcrossChannels(&src, 1, 0, dest, numSamples);
+}
+
+// dest[i] *= gain[i], the gain widened to double
+inline void multiply(double* dest, const float* gain, int numSamples) noexcept
+{
+    int i = 0;
+
+#if AUTOCOMP_SIMD_AVX2
+    for (; i + 4 <= numSamples; i += 4)
+        _mm256_storeu_pd(dest + i, _mm256_mul_pd(_mm256_loadu_pd(dest + i), _mm256_cvtps_pd(_mm_loadu_ps(gain + i))));
+#elif AUTOCOMP_SIMD_SSE2
+    for (; i + 4 <= numSamples; i += 4)
+    {
+        const auto g = _mm_loadu_ps(gain + i);
+        _mm_storeu_pd(dest + i, _mm_mul_pd(_mm_loadu_pd(dest + i), _mm_cvtps_pd(g)));
+        _mm_storeu_pd(dest + i + 2, _mm_mul_pd(_mm_loadu_pd(dest + i + 2), _mm_cvtps_pd(_mm_movehl_ps(g, g))));
+    }
+#endif
+
+    for (; i < numSamples; ++i)
+        dest[i] *= static_cast<double>(gain[i]);
+}
+
+//==============================================================================
+// Metering: peak = max(peak, |src[i]|), sumSquares += src[i]^2. Squares
+// are summed in float within one call (one block) and added to the total
+// in double.
+inline void accumulatePeakAndPower(const float* src, int numSamples, float& peak, double& sumSquares) noexcept
+{
+    int i = 0;
+    auto blockPeak = peak;
+    auto squares = 0.0f;
+
+#if AUTOCOMP_SIMD_AVX2
+    const auto signMask = _mm256_set1_ps(-0.0f);
+    auto peaks = _mm256_setzero_ps(), sums = _mm256_setzero_ps();
+
+    for (; i + 8 <= numSamples; i += 8)
+    {
+        const auto x = _mm256_loadu_ps(src + i);
+        peaks = _mm256_max_ps(peaks, _mm256_andnot_ps(signMask, x));
+        sums = _mm256_add_ps(sums, _mm256_mul_ps(x, x));
+    }
+
+    alignas(32) float peakLanes[8], sumLanes[8];
+    _mm256_store_ps(peakLanes, peaks);
+    _mm256_store_ps(sumLanes, sums);
+#elif AUTOCOMP_SIMD_SSE2
+    const auto signMask = _mm_set1_ps(-0.0f);
+    auto peaks = _mm_setzero_ps(), sums = _mm_setzero_ps();
+
+    for (; i + 4 <= numSamples; i += 4)
+    {
+        const auto x = _mm_loadu_ps(src + i);
+        peaks = _mm_max_ps(peaks, _mm_andnot_ps(signMask, x));
+        sums = _mm_add_ps(sums, _mm_mul_ps(x, x));
+    }
+
+    alignas(16) float peakLanes[4], sumLanes[4];
+    _mm_store_ps(peakLanes, peaks);
+    _mm_store_ps(sumLanes, sums);
+#elif AUTOCOMP_SIMD_NEON
+    auto peaks = vdupq_n_f32(0.0f), sums = vdupq_n_f32(0.0f);
+
+    for (; i + 4 <= numSamples; i += 4)
+    {
+        const auto x = vld1q_f32(src + i);
+        peaks = vmaxq_f32(peaks, vabsq_f32(x));
+        sums = vmlaq_f32(sums, x, x);
+    }
+
+    float peakLanes[4], sumLanes[4];
+    vst1q_f32(peakLanes, peaks);
+    vst1q_f32(sumLanes, sums);
+#endif
+
+#if AUTOCOMP_SIMD_AVX2 || AUTOCOMP_SIMD_SSE2 || AUTOCOMP_SIMD_NEON
+    for (int lane = 0; lane < width; ++lane)
+    {
+        blockPeak = std::max(blockPeak, peakLanes[lane]);
+        squares += sumLanes[lane];
+    }
+#endif
+
+    for (; i < numSamples; ++i)
+    {
+        blockPeak = std::max(blockPeak, std::abs(src[i]));
+        squares += src[i] * src[i];
+    }
+
+    peak = blockPeak;
+    sumSquares += static_cast<double>(squares);
+}
+
+// Double audio is only metered, so this one stays scalar
+inline void accumulatePeakAndPower(const double* src, int numSamples, float& peak, double& sumSquares) noexcept
+{
+    auto blockPeak = static_cast<double>(peak);
+    auto squares = 0.0;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        blockPeak = std::max(blockPeak, std::abs(src[i]));
+        squares += src[i] * src[i];
+    }
+
+    peak = static_cast<float>(blockPeak);
+    sumSquares += squares;
+}
+
+// Digital silence: every sample of every channel exactly zero (either
+// sign). The sample bits are ORed together a chunk at a time, which
+// vectorises; audio usually returns on the first chunk, silence costs one
+// pass at memory speed.
+template <typename SampleType>
+inline bool isSilent(const SampleType* const* channels, int numChannels, int numSamples) noexcept
+{
+    using Bits = std::conditional_t<sizeof(SampleType) == 4, std::uint32_t, std::uint64_t>;
+    constexpr auto magnitude = static_cast<Bits>(~(Bits(1) << (8 * sizeof(Bits) - 1)));
+    constexpr int chunk = 64;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const auto* src = channels[channel];
+
+        for (int i = 0; i < numSamples; i += chunk)
+        {
+            const auto end = std::min(i + chunk, numSamples);
+            Bits any = 0;
+
+            for (int j = i; j < end; ++j)
+            {
+                Bits bits;
+                std::memcpy(&bits, src + j, sizeof(bits));
+                any |= bits;
+            }
+
+            if ((any & magnitude) != 0)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+//==============================================================================
+#if AUTOCOMP_SIMD_AVX2 || AUTOCOMP_SIMD_SSE2
+using Vec4 = __m128;
+
+inline Vec4 load4(const float* source) noexcept         { return _mm_loadu_ps(source); }
+inline void store4(float* dest, Vec4 value) noexcept    { _mm_storeu_ps(dest, value); }
+inline Vec4 splat4(float value) noexcept                { return _mm_set1_ps(value); }
+inline Vec4 add4(Vec4 a, Vec4 b) noexcept               { return _mm_add_ps(a, b); }
+inline Vec4 sub4(Vec4 a, Vec4 b) noexcept               { return _mm_sub_ps(a, b); }
+inline Vec4 mul4(Vec4 a, Vec4 b) noexcept               { return _mm_mul_ps(a, b); }
+inline Vec4 max4(Vec4 a, Vec4 b) noexcept               { return _mm_max_ps(a, b); }
+
+// a < b ? ifLess : otherwise, per lane
+inline Vec4 selectLess4(Vec4 a, Vec4 b, Vec4 ifLess, Vec4 otherwise) noexcept
+{
+    const auto mask = _mm_cmplt_ps(a, b);
+    return _mm_or_ps(_mm_and_ps(mask, ifLess), _mm_andnot_ps(mask, otherwise));
+}
+
+// fastmath::fastLog2 on four lanes, same arithmetic
+inline Vec4 fastLog2x4(Vec4 x) noexcept
+{
+    const auto bits = _mm_castps_si128(x);
+    auto exponent = _mm_sub_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(bits, 23), _mm_set1_epi32(0xff))),
+                               _mm_set1_ps(127.0f));
+    auto mantissa = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007fffff)),
+                                                  _mm_set1_epi32(0x3f800000)));
+
+    const auto fold = _mm_cmpgt_ps(mantissa, _mm_set1_ps(1.41421356f));
+    mantissa = _mm_or_ps(_mm_and_ps(fold, _mm_mul_ps(mantissa, _mm_set1_ps(0.5f))), _mm_andnot_ps(fold, mantissa));
+    exponent = _mm_add_ps(exponent, _mm_and_ps(fold, _mm_set1_ps(1.0f)));
+
+    const auto one = _mm_set1_ps(1.0f);
+    const auto t = _mm_div_ps(_mm_sub_ps(mantissa, one), _mm_add_ps(mantissa, one));
+    const auto t2 = _mm_mul_ps(t, t);
+
+    constexpr float c1 = 2.8853900817779268f;
+    auto poly = _mm_add_ps(_mm_set1_ps(c1 / 3.0f), _mm_mul_ps(t2, _mm_set1_ps(c1 / 5.0f)));
+    poly = _mm_add_ps(_mm_set1_ps(c1), _mm_mul_ps(t2, poly));
+
+    return _mm_add_ps(exponent, _mm_mul_ps(t, poly));
+}
+
+// fastmath::fastExp2 on four lanes, same arithmetic
+inline Vec4 fastExp2x4(Vec4 x) noexcept
+{
+    x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-126.0f)), _mm_set1_ps(127.0f));
+
+    const auto biased = _mm_cvttps_epi32(_mm_add_ps(x, _mm_set1_ps(127.5f)));
+    const auto i = _mm_sub_epi32(biased, _mm_set1_epi32(127));
+    const auto f = _mm_mul_ps(_mm_sub_ps(x, _mm_cvtepi32_ps(i)), _mm_set1_ps(0.69314718056f));
+
+    auto poly = _mm_set1_ps(1.0f / 720.0f);
+
+    for (auto c : { 1.0f / 120.0f, 1.0f / 24.0f, 1.0f / 6.0f, 1.0f / 2.0f, 1.0f, 1.0f })
+        poly = _mm_add_ps(_mm_set1_ps(c), _mm_mul_ps(f, poly));
+
+    return _mm_mul_ps(poly, _mm_castsi128_ps(_mm_slli_epi32(biased, 23)));
+}
+
+#elif AUTOCOMP_SIMD_NEON
+using Vec4 = float32x4_t;
+
+inline Vec4 load4(const float* source) noexcept         { return vld1q_f32(source); }
+inline void store4(float* dest, Vec4 value) noexcept    { vst1q_f32(dest, value); }
+inline Vec4 splat4(float value) noexcept                { return vdupq_n_f32(value); }
+inline Vec4 add4(Vec4 a, Vec4 b) noexcept               { return vaddq_f32(a, b); }
+inline Vec4 sub4(Vec4 a, Vec4 b) noexcept               { return vsubq_f32(a, b); }
+inline Vec4 mul4(Vec4 a, Vec4 b) noexcept               { return vmulq_f32(a, b); }
+inline Vec4 max4(Vec4 a, Vec4 b) noexcept               { return vmaxq_f32(a, b); }
+
+inline Vec4 selectLess4(Vec4 a, Vec4 b, Vec4 ifLess, Vec4 otherwise) noexcept
+{
+    return vbslq_f32(vcltq_f32(a, b), ifLess, otherwise);
+}
+
+inline Vec4 div4(Vec4 a, Vec4 b) noexcept
+{
+   #if defined(__aarch64__) || defined(_M_ARM64)
+    return vdivq_f32(a, b);
+   #else
+    // Reciprocal estimate plus two Newton steps: close to float precision
+    auto reciprocal = vrecpeq_f32(b);
+    reciprocal = vmulq_f32(vrecpsq_f32(b, reciprocal), reciprocal);
+    reciprocal = vmulq_f32(vrecpsq_f32(b, reciprocal), reciprocal);
+    return vmulq_f32(a, reciprocal);
+   #endif
+}
+
+inline Vec4 fastLog2x4(Vec4 x) noexcept
+{
+    const auto bits = vreinterpretq_s32_f32(x);
+    auto exponent = vsubq_f32(vcvtq_f32_s32(vandq_s32(vshrq_n_s32(bits, 23), vdupq_n_s32(0xff))), vdupq_n_f32(127.0f));
+    auto mantissa = vreinterpretq_f32_s32(vorrq_s32(vandq_s32(bits, vdupq_n_s32(0x007fffff)), vdupq_n_s32(0x3f800000)));
+
+    const auto fold = vcgtq_f32(mantissa, vdupq_n_f32(1.41421356f));
+    mantissa = vbslq_f32(fold, vmulq_f32(mantissa, vdupq_n_f32(0.5f)), mantissa);
+    exponent = vbslq_f32(fold, vaddq_f32(exponent, vdupq_n_f32(1.0f)), exponent);
+
+    const auto one = vdupq_n_f32(1.0f);
+    const auto t = div4(vsubq_f32(mantissa, one), vaddq_f32(mantissa, one));
+    const auto t2 = vmulq_f32(t, t);
+
+    constexpr float c1 = 2.8853900817779268f;
+    auto poly = vaddq_f32(vdupq_n_f32(c1 / 3.0f), vmulq_f32(t2, vdupq_n_f32(c1 / 5.0f)));
+    poly = vaddq_f32(vdupq_n_f32(c1), vmulq_f32(t2, poly));
+
+    return vaddq_f32(exponent, vmulq_f32(t, poly));
+}
+
+inline Vec4 fastExp2x4(Vec4 x) noexcept
+{
+    x = vminq_f32(vmaxq_f32(x, vdupq_n_f32(-126.0f)), vdupq_n_f32(127.0f));
+
+    const auto biased = vcvtq_s32_f32(vaddq_f32(x, vdupq_n_f32(127.5f)));   // truncates
+    const auto i = vsubq_s32(biased, vdupq_n_s32(127));
+    const auto f = vmulq_f32(vsubq_f32(x, vcvtq_f32_s32(i)), vdupq_n_f32(0.69314718056f));
+
+    auto poly = vdupq_n_f32(1.0f / 720.0f);
+
+    for (auto c : { 1.0f / 120.0f, 1.0f / 24.0f, 1.0f / 6.0f, 1.0f / 2.0f, 1.0f, 1.0f })
+        poly = vaddq_f32(vdupq_n_f32(c), vmulq_f32(f, poly));
+
+    return vmulq_f32(poly, vreinterpretq_f32_s32(vshlq_n_s32(biased, 23)));
+}
+
+#else
+struct Vec4
+{
+    float lanes[4];
+};
+
+namespace detail
+{
+    template <typename Function>
+    inline Vec4 perLane(Vec4 a, Vec4 b, Function&& function) noexcept
+    {
+        Vec4 result;
+
+        for (int i = 0; i < 4; ++i)
+            result.lanes[i] = function(a.lanes[i], b.lanes[i]);
+
+        return result;
+    }
+}
+
+inline Vec4 load4(const float* source) noexcept         { return { { source[0], source[1], source[2], source[3] } }; }
+inline void store4(float* dest, Vec4 value) noexcept    { std::copy(value.lanes, value.lanes + 4, dest); }
+inline Vec4 splat4(float value) noexcept                { return { { value, value, value, value } }; }
+inline Vec4 add4(Vec4 a, Vec4 b) noexcept               { return detail::perLane(a, b, [](float x, float y) { return x + y; }); }
+inline Vec4 sub4(Vec4 a, Vec4 b) noexcept               { return detail::perLane(a, b, [](float x, float y) { return x - y; }); }
+inline Vec4 mul4(Vec4 a, Vec4 b) noexcept               { return detail::perLane(a, b, [](float x, float y) { return x * y; }); }
+inline Vec4 max4(Vec4 a, Vec4 b) noexcept               { return detail::perLane(a, b, [](float x, float y) { return std::max(x, y); }); }
+
+inline Vec4 selectLess4(Vec4 a, Vec4 b, Vec4 ifLess, Vec4 otherwise) noexcept
+{
+    Vec4 result;
+
+    for (int i = 0; i < 4; ++i)
+        result.lanes[i] = a.lanes[i] < b.lanes[i] ? ifLess.lanes[i] : otherwise.lanes[i];
+
+    return result;
+}
+
+inline Vec4 fastLog2x4(Vec4 x) noexcept { return detail::perLane(x, x, [](float v, float) { return fastmath::fastLog2(v); }); }
+inline Vec4 fastExp2x4(Vec4 x) noexcept { return detail::perLane(x, x, [](float v, float) { return fastmath::fastExp2(v); }); }
+#endif
+
+} // namespace autocomp::simd
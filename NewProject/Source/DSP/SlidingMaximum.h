@@ -0,0 +1,93 @@
+/*
+  ==============================================================================
+
+    SlidingMaximum.h
+
+    Running maximum over the last N values using a monotonic deque kept in a
+    fixed ring buffer. Each value is pushed and popped at most once, so the
+    cost per sample is O(1) amortised regardless of the window length.
+    Memory is allocated in prepare() only.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace autocomp
+{
+
+class SlidingMaximum
+{
+public:
+    // Allocates room for windows of up to maximumWindowLength values
+    void prepare(int maximumWindowLength)
+    {
+        // The deque briefly holds windowLength + 1 entries inside push()
+        std::uint32_t capacity = 1;
+
+        while (capacity < static_cast<std::uint32_t>(std::max(maximumWindowLength, 1)) + 1)
+            capacity <<= 1;
+
+        values.assign(capacity, 0.0f);
+        stamps.assign(capacity, 0);
+        mask = capacity - 1;
+        maximumWindow = std::max(maximumWindowLength, 1);
+        setWindowLength(std::min(static_cast<int>(window), maximumWindow));
+    }
+
+    // Changes the window and forgets the history
+    void setWindowLength(int newLength) noexcept
+    {
+        window = static_cast<std::uint32_t>(std::clamp(newLength, 1, maximumWindow));
+        reset();
+    }
+
+    int getWindowLength() const noexcept { return static_cast<int>(window); }
+
+    void reset() noexcept
+    {
+        head = tail = 0;
+        counter = 0;
+    }
+
+    // Adds a value, returns the maximum of the last windowLength values
+    float push(float value) noexcept
+    {
+        // Anything not larger than the new value can never be the maximum again
+        while (tail != head && values[(tail - 1) & mask] <= value)
+            --tail;
+
+        values[tail & mask] = value;
+        stamps[tail & mask] = counter;
+        ++tail;
+
+        // Drop the front once it has left the window
+        if (counter - stamps[head & mask] >= window)
+            ++head;
+
+        ++counter;
+        return values[head & mask];
+    }
+
+    // In-place safe: dest may equal source
+    void process(const float* source, float* dest, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] = push(source[i]);
+    }
+
+private:
+    std::vector<float> values;
+    std::vector<std::uint32_t> stamps;
+    std::uint32_t mask = 0;
+    std::uint32_t head = 0, tail = 0;   // deque bounds, wrap via mask
+    std::uint32_t counter = 0;          // sample index, wraps harmlessly
+    std::uint32_t window = 1;
+    int maximumWindow = 1;
+};
+
+} // namespace autocomp
@@ -0,0 +1,124 @@
+/*
+  ==============================================================================
+
+    SlidingRms.h
+
+    RMS over a fixed window of the most recent frames (mean square across
+    channels), so the reading depends on time only, not on how the host
+    splits the audio into blocks. The per-frame squares live in a ring;
+    each block is written as at most two contiguous segments and the
+    running sum is updated by the segment totals, so there is no per-sample
+    modulo and the cost per sample is O(1) regardless of the window length.
+    Memory is allocated in prepare() only.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+namespace autocomp
+{
+
+class SlidingRms
+{
+public:
+    void prepare(int newWindowLength)
+    {
+        windowLength = std::max(newWindowLength, 1);
+        squares.assign(static_cast<size_t>(windowLength), 0.0f);
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        std::fill(squares.begin(), squares.end(), 0.0f);
+        writePosition = 0;
+        sum = 0.0;
+    }
+
+    int getWindowLength() const noexcept { return windowLength; }
+
+    // Pushes numSamples frames of numChannels channels
+    void process(const float* const* channels, int numChannels, int numSamples) noexcept
+    {
+        if (numChannels <= 0 || squares.empty())
+            return;
+
+        // Only the newest windowLength frames can still be in the window
+        auto offset = std::max(0, numSamples - windowLength);
+        const auto scale = 1.0f / static_cast<float>(numChannels);
+
+        while (offset < numSamples)
+        {
+            const auto count = std::min(numSamples - offset, windowLength - writePosition);
+            writeSegment(channels, numChannels, offset, count, scale);
+
+            offset += count;
+            writePosition += count;
+
+            if (writePosition == windowLength)
+            {
+                writePosition = 0;
+                resync();
+            }
+        }
+    }
+
+    float getMeanSquare() const noexcept
+    {
+        return static_cast<float>(std::max(sum, 0.0) / static_cast<double>(windowLength));
+    }
+
+    float getRms() const noexcept { return std::sqrt(getMeanSquare()); }
+
+private:
+    void writeSegment(const float* const* channels, int numChannels, int offset, int count, float scale) noexcept
+    {
+        auto* dest = squares.data() + writePosition;
+        auto removed = 0.0f;
+        auto added = 0.0f;
+
+        for (int i = 0; i < count; ++i)
+            removed += dest[i];
+
+        const auto* first = channels[0] + offset;
+
+        for (int i = 0; i < count; ++i)
+            dest[i] = first[i] * first[i];
+
+        for (int ch = 1; ch < numChannels; ++ch)
+        {
+            const auto* source = channels[ch] + offset;
+
+            for (int i = 0; i < count; ++i)
+                dest[i] += source[i] * source[i];
+        }
+
+        for (int i = 0; i < count; ++i)
+        {
+            dest[i] *= scale;
+            added += dest[i];
+        }
+
+        sum += static_cast<double>(added) - static_cast<double>(removed);
+    }
+
+    // Recomputes the sum once per wrap so rounding errors cannot build up;
+    // O(windowLength) once every windowLength frames
+    void resync() noexcept
+    {
+        sum = std::accumulate(squares.begin(), squares.end(), 0.0);
+    }
+
+    std::vector<float> squares;     // per-frame mean square, ring
+    int windowLength = 1;
+    int writePosition = 0;
+    double sum = 0.0;               // running sum of squares
+};
+
+} // namespace autocomp
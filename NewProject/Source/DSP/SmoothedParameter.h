@@ -0,0 +1,78 @@
+/*
+  ==============================================================================
+
+    SmoothedParameter.h
+
+    Linear per-sample ramp towards a target value, in the spirit of
+    juce::LinearSmoothedValue but without the JUCE dependency. Each target
+    change costs one division; every sample after that is a single add.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+
+namespace autocomp
+{
+
+class SmoothedParameter
+{
+public:
+    // Ramp length in samples for subsequent setTargetValue() calls
+    void reset(int newRampLengthInSamples) noexcept
+    {
+        rampLength = std::max(newRampLengthInSamples, 1);
+        setCurrentAndTargetValue(target);
+    }
+
+    void setCurrentAndTargetValue(float newValue) noexcept
+    {
+        current = target = newValue;
+        remaining = 0;
+    }
+
+    void setTargetValue(float newTarget) noexcept
+    {
+        if (newTarget == target)
+            return;
+
+        target = newTarget;
+        remaining = rampLength;
+        step = (target - current) / static_cast<float>(rampLength);
+    }
+
+    bool isSmoothing() const noexcept       { return remaining > 0; }
+    float getCurrentValue() const noexcept  { return current; }
+    float getTargetValue() const noexcept   { return target; }
+
+    float getNextValue() noexcept
+    {
+        if (remaining <= 0)
+            return target;
+
+        current = --remaining == 0 ? target : current + step;
+        return current;
+    }
+
+    // Writes the next numSamples values and advances the ramp
+    void fill(float* dest, int numSamples) noexcept
+    {
+        int i = 0;
+
+        for (; i < numSamples && remaining > 0; ++i)
+            dest[i] = getNextValue();
+
+        std::fill(dest + i, dest + numSamples, target);
+    }
+
+private:
+    float current = 0.0f;
+    float target = 0.0f;
+    float step = 0.0f;
+    int remaining = 0;
+    int rampLength = 1;
+};
+
+} // namespace autocomp
@@ -0,0 +1,186 @@
+/*
+  ==============================================================================
+
+    StateChunk.h
+
+    The plugin's saved state: a small fixed-layout binary chunk instead of
+    XML, so a session with hundreds of instances restores without parsing
+    text or building trees. Reading fills a caller's array and never
+    allocates.
+
+    Layout, all little-endian:
+
+        magic     4 bytes   "CUMS"
+        version   2 bytes   chunk format (currently 1)
+        count     2 bytes   number of entries
+        entries   8 bytes each: parameter id hash (32 bit), plain value (float)
+        checksum  4 bytes   FNV-1a over everything before it
+
+    Parameters are keyed by a hash of their ID, not their position, so
+    parameters can be added, removed or reordered between versions: the
+    reader skips ids it does not know and leaves missing ones alone.
+    Values are stored unnormalised so a changed range still restores the
+    same setting.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace autocomp::state
+{
+
+constexpr std::uint8_t magic[4] = { 'C', 'U', 'M', 'S' };
+constexpr std::uint16_t version = 1;
+
+constexpr int maxParameters = 64;
+constexpr std::size_t headerSize = 8;
+constexpr std::size_t entrySize = 8;
+constexpr std::size_t checksumSize = 4;
+
+struct ParameterValue
+{
+    std::uint32_t id = 0;       // hashId() of the parameter ID
+    float value = 0.0f;         // plain (unnormalised) value
+};
+
+//==============================================================================
+namespace detail
+{
+    constexpr std::uint32_t fnvOffset = 2166136261u;
+    constexpr std::uint32_t fnvPrime = 16777619u;
+
+    inline std::uint32_t fnv(const std::uint8_t* bytes, std::size_t size) noexcept
+    {
+        auto hash = fnvOffset;
+
+        for (std::size_t i = 0; i < size; ++i)
+            hash = (hash ^ bytes[i]) * fnvPrime;
+
+        return hash;
+    }
+
+    inline void put16(std::uint8_t* out, std::uint16_t value) noexcept
+    {
+        out[0] = static_cast<std::uint8_t>(value);
+        out[1] = static_cast<std::uint8_t>(value >> 8);
+    }
+
+    inline void put32(std::uint8_t* out, std::uint32_t value) noexcept
+    {
+        for (int i = 0; i < 4; ++i)
+            out[i] = static_cast<std::uint8_t>(value >> (8 * i));
+    }
+
+    inline std::uint16_t get16(const std::uint8_t* in) noexcept
+    {
+        return static_cast<std::uint16_t>(in[0] | (in[1] << 8));
+    }
+
+    inline std::uint32_t get32(const std::uint8_t* in) noexcept
+    {
+        return static_cast<std::uint32_t>(in[0]) | (static_cast<std::uint32_t>(in[1]) << 8)
+             | (static_cast<std::uint32_t>(in[2]) << 16) | (static_cast<std::uint32_t>(in[3]) << 24);
+    }
+}
+
+// Stable key for a parameter ID ("threshold", "ratio", ...)
+constexpr std::uint32_t hashId(const char* id) noexcept
+{
+    auto hash = detail::fnvOffset;
+
+    for (; *id != 0; ++id)
+        hash = (hash ^ static_cast<std::uint8_t>(*id)) * detail::fnvPrime;
+
+    return hash;
+}
+
+// Bytes a chunk of numValues entries takes
+constexpr std::size_t getSize(int numValues) noexcept
+{
+    return headerSize + entrySize * static_cast<std::size_t>(numValues) + checksumSize;
+}
+
+//==============================================================================
+// Returns the bytes written, or 0 if dest is smaller than getSize(numValues)
+inline std::size_t write(const ParameterValue* values, int numValues, void* dest, std::size_t capacity) noexcept
+{
+    if (numValues < 0 || numValues > maxParameters || capacity < getSize(numValues))
+        return 0;
+
+    auto* out = static_cast<std::uint8_t*>(dest);
+    std::memcpy(out, magic, sizeof(magic));
+    detail::put16(out + 4, version);
+    detail::put16(out + 6, static_cast<std::uint16_t>(numValues));
+
+    auto* entry = out + headerSize;
+
+    for (int i = 0; i < numValues; ++i, entry += entrySize)
+    {
+        std::uint32_t bits;
+        std::memcpy(&bits, &values[i].value, sizeof(bits));
+        detail::put32(entry, values[i].id);
+        detail::put32(entry + 4, bits);
+    }
+
+    detail::put32(entry, detail::fnv(out, static_cast<std::size_t>(entry - out)));
+    return getSize(numValues);
+}
+
+// Whether the data is one of these chunks at all (any version), as opposed
+// to an older XML state
+inline bool isChunk(const void* data, std::size_t size) noexcept
+{
+    return data != nullptr && size >= sizeof(magic) && std::memcmp(data, magic, sizeof(magic)) == 0;
+}
+
+// Bytes the chunk at data takes (the caller may append its own data after
+// it), or 0 if data does not start with a chunk
+inline std::size_t getChunkSize(const void* data, std::size_t size) noexcept
+{
+    if (! isChunk(data, size) || size < headerSize)
+        return 0;
+
+    return getSize(detail::get16(static_cast<const std::uint8_t*>(data) + 6));
+}
+
+// Reads up to capacity entries into values. Returns the number read, or -1
+// if the chunk is truncated, corrupt or from a newer format version.
+inline int read(const void* data, std::size_t size, ParameterValue* values, int capacity) noexcept
+{
+    if (! isChunk(data, size) || size < getSize(0))
+        return -1;
+
+    const auto* in = static_cast<const std::uint8_t*>(data);
+
+    if (detail::get16(in + 4) > version)
+        return -1;
+
+    const int count = detail::get16(in + 6);
+
+    if (size < getSize(count))
+        return -1;
+
+    const auto checked = getSize(count) - checksumSize;
+
+    if (detail::get32(in + checked) != detail::fnv(in, checked))
+        return -1;
+
+    const auto numRead = count < capacity ? count : capacity;
+    const auto* entry = in + headerSize;
+
+    for (int i = 0; i < numRead; ++i, entry += entrySize)
+    {
+        const auto bits = detail::get32(entry + 4);
+        values[i].id = detail::get32(entry);
+        std::memcpy(&values[i].value, &bits, sizeof(bits));
+    }
+
+    return numRead;
+}
+
+} // namespace autocomp::state
@@ -0,0 +1,91 @@
+/*
+  ==============================================================================
+
+    TripleBuffer.h
+
+    Wait-free single-producer/single-consumer handoff of the latest value of
+    a trivially copyable type. The writer never blocks the reader and vice
+    versa; the reader always sees a complete value (no torn reads), and
+    intermediate values may be skipped.
+
+    One thread may call write(), one (other) thread may call read()/latest().
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+namespace autocomp
+{
+
+template <typename T>
+class TripleBuffer
+{
+public:
+    static_assert(std::is_trivially_copyable_v<T>, "TripleBuffer values are copied with plain assignment");
+
+    TripleBuffer() = default;
+
+    explicit TripleBuffer(const T& initialValue)
+    {
+        for (auto& slot : slots)
+            slot.value = initialValue;
+    }
+
+    // Producer: publishes a new value
+    void write(const T& value) noexcept
+    {
+        slots[static_cast<std::size_t>(backIndex)].value = value;
+        const auto previous = middle.exchange(backIndex | freshBit, std::memory_order_acq_rel);
+        backIndex = previous & indexMask;
+    }
+
+    // Consumer: copies the newest value into dest; false if nothing new
+    bool read(T& dest) noexcept
+    {
+        if (! pull())
+            return false;
+
+        dest = slots[static_cast<std::size_t>(frontIndex)].value;
+        return true;
+    }
+
+    // Consumer: the newest value published so far
+    const T& latest() noexcept
+    {
+        pull();
+        return slots[static_cast<std::size_t>(frontIndex)].value;
+    }
+
+private:
+    bool pull() noexcept
+    {
+        if ((middle.load(std::memory_order_relaxed) & freshBit) == 0)
+            return false;
+
+        const auto previous = middle.exchange(frontIndex, std::memory_order_acq_rel);
+        frontIndex = previous & indexMask;
+        return true;
+    }
+
+    static constexpr int indexMask = 3;
+    static constexpr int freshBit = 4;
+
+    // Each slot on its own cache line so producer and consumer don't share one
+    struct alignas(64) Slot
+    {
+        T value {};
+    };
+
+    std::array<Slot, 3> slots;
+    std::atomic<int> middle { 1 };
+    int backIndex = 0;   // producer-owned
+    int frontIndex = 2;  // consumer-owned
+};
+
+} // namespace autocomp
@@ -86,8 +86,10 @@ void CircularButton::setToggleState(bool shouldBeToggled)
 //==============================================================================
 // VerticalKnob Implementation
 VerticalKnob::VerticalKnob()
+    : heartShape(createHeart(knobRadius))
 {
     setSize(50, 180); // Wider and taller
+    juce::PathStrokeType(1.5f).createStrokedPath(heartOutline, heartShape);
 }
 
 void VerticalKnob::paint(juce::Graphics& g)
@@ -122,15 +124,8 @@ void VerticalKnob::paint(juce::Graphics& g)
         {
             juce::Colour stepColour;
 
-            // θ Ϳ ư  Ȯ
-            bool isCompressorActive = true;
-            if (auto* editor = dynamic_cast<NewProjectAudioProcessorEditor*>(getParentComponent()))
-            {
-                isCompressorActive = editor->isCompressorActive();
-            }
-
-            // Ȱȭ ¿ ĥ! (else κ  )
-            if (isCompressorActive)
+            // 활성화 상태에서만 색칠 (상태는 에디터가 setActive로 알려줌)
+            if (isActive)
             {
                 switch (i)
                 {
@@ -172,8 +167,12 @@ void VerticalKnob::paint(juce::Graphics& g)
     auto knobY = trackArea.getY() + (trackHeight / (numSteps - 1)) * (numSteps - 1 - currentStep);
     auto knobCenter = juce::Point<float>(center.x, knobY);
 
+    // Heart: the cached path moved into place
+    auto toKnob = juce::AffineTransform::translation(knobCenter.x, knobCenter.y);
+
     // Heart shadow
-    drawHeart(g, knobCenter.translated(1, 1), knobRadius, juce::Colours::black.withAlpha(0.3f));
+    g.setColour(juce::Colours::black.withAlpha(0.3f));
+    g.fillPath(heartShape, toKnob.translated(1.0f, 1.0f));
 
     // Heart main color
     juce::Colour heartColour;
@@ -182,10 +181,12 @@ void VerticalKnob::paint(juce::Graphics& g)
     else
         heartColour = juce::Colours::pink;
 
-    drawHeart(g, knobCenter, knobRadius, heartColour);
+    g.setColour(heartColour);
+    g.fillPath(heartShape, toKnob);
 
     // Heart outline
-    drawHeart(g, knobCenter, knobRadius, juce::Colours::darkred);
+    g.setColour(juce::Colours::darkred);
+    g.fillPath(heartOutline, toKnob);
 
     // Draw label
     g.setColour(juce::Colours::white);
@@ -196,14 +197,14 @@ void VerticalKnob::paint(juce::Graphics& g)
         juce::Justification::centred);
 }
 
-void VerticalKnob::drawHeart(juce::Graphics& g, juce::Point<float> center, float size, juce::Colour colour)
+juce::Path VerticalKnob::createHeart(float size)
 {
     juce::Path heartPath;
 
-    // Heart shape parameters
+    // Heart shape parameters (centred on the origin)
     float heartSize = size * 0.8f;
-    float cx = center.x;
-    float cy = center.y;
+    float cx = 0.0f;
+    float cy = 0.0f;
 
     // Create heart shape using bezier curves
     heartPath.startNewSubPath(cx, cy + heartSize * 0.3f);
@@ -224,17 +225,7 @@ void VerticalKnob::drawHeart(juce::Graphics& g, juce::Point<float> center, float
         cx, cy + heartSize * 0.3f);
 
     heartPath.closeSubPath();
-
-    if (colour == juce::Colours::darkred) // Outline
-    {
-        g.setColour(colour);
-        g.strokePath(heartPath, juce::PathStrokeType(1.5f));
-    }
-    else // Fill
-    {
-        g.setColour(colour);
-        g.fillPath(heartPath);
-    }
+    return heartPath;
 }
 
 void VerticalKnob::mouseDown(const juce::MouseEvent& e)
@@ -289,6 +280,120 @@ void VerticalKnob::setValue(int newStep)
     repaint();
 }
 
+void VerticalKnob::setActive(bool shouldBeActive)
+{
+    if (isActive != shouldBeActive)
+    {
+        isActive = shouldBeActive;
+        repaint();
+    }
+}
+
+//==============================================================================
+// LevelMeterDisplay Implementation
+LevelMeterDisplay::LevelMeterDisplay()
+{
+    setSize(90, 220);
+}
+
+bool LevelMeterDisplay::update(const autocomp::LevelReading& reading, float seconds)
+{
+    // Rises at once, falls at fallDbPerSecond. Each column repaints only
+    // its own strip, and only when it moved.
+    const auto fall = fallDbPerSecond * seconds;
+    bool moved[] = { false, false, false };
+
+    auto follow = [fall, &moved](int column, float& shown, float target)
+    {
+        const auto previous = shown;
+        shown = juce::jmax(target, shown - fall);
+        moved[column] = moved[column] || std::abs(shown - previous) > 0.05f;
+    };
+
+    auto toDb = [](float linear) { return juce::Decibels::gainToDecibels(linear, minDb); };
+
+    follow(0, inputPeakDb, toDb(reading.inputPeak));
+    follow(0, inputRmsDb, toDb(reading.inputRms));
+    follow(1, reductionDb, juce::jmin(reading.gainReduction, maxReductionDb));
+    follow(2, outputPeakDb, toDb(reading.outputPeak));
+    follow(2, outputRmsDb, toDb(reading.outputRms));
+
+    for (int column = 0; column < 3; ++column)
+        if (moved[column])
+            repaint(getColumnBounds(column));
+
+    return reading.hasNewAudio || moved[0] || moved[1] || moved[2];
+}
+
+juce::Rectangle<int> LevelMeterDisplay::getColumnBounds(int column) const
+{
+    const auto columnWidth = getWidth() / 3;
+    return { columnWidth * column, 0, column == 2 ? getWidth() - 2 * columnWidth : columnWidth, getHeight() };
+}
+
+void LevelMeterDisplay::paint(juce::Graphics& g)
+{
+    const juce::String labels[] = { "IN", "GR", "OUT" };
+    const auto columnWidth = static_cast<float>(getWidth()) / 3.0f;
+
+    for (int column = 0; column < 3; ++column)
+    {
+        auto track = juce::Rectangle<float>(columnWidth * (static_cast<float>(column) + 0.5f) - trackWidth * 0.5f,
+                                            25.0f, trackWidth, trackHeight);
+
+        // Track background and border, as on the knob
+        g.setColour(juce::Colours::darkgrey.darker());
+        g.fillRoundedRectangle(track, 2.0f);
+
+        if (column == 0)
+            drawLevelBar(g, track, inputRmsDb, inputPeakDb);
+        else if (column == 2)
+            drawLevelBar(g, track, outputRmsDb, outputPeakDb);
+        else if (reductionDb > 0.0f)
+        {
+            // Gain reduction hangs down from the top
+            g.setColour(juce::Colours::hotpink.withAlpha(0.8f));
+            g.fillRoundedRectangle(track.withHeight(trackHeight * reductionDb / maxReductionDb), 2.0f);
+        }
+
+        g.setColour(juce::Colours::black.withAlpha(0.8f));
+        g.drawRoundedRectangle(track, 2.0f, 1.0f);
+
+        // Label and value below
+        const auto value = column == 1 ? reductionDb : (column == 0 ? inputPeakDb : outputPeakDb);
+
+        g.setColour(juce::Colours::white);
+        g.setFont(juce::Font(12.0f, juce::Font::bold));
+        g.drawText(labels[column],
+            static_cast<int>(columnWidth * static_cast<float>(column)), static_cast<int>(track.getBottom() + 10),
+            static_cast<int>(columnWidth), 15,
+            juce::Justification::centred);
+
+        g.setFont(juce::Font(10.0f));
+        g.drawText(value <= minDb ? juce::String("-inf") : juce::String(column == 1 ? 0.0f - value : value, 1),
+            static_cast<int>(columnWidth * static_cast<float>(column)), static_cast<int>(track.getBottom() + 25),
+            static_cast<int>(columnWidth), 12,
+            juce::Justification::centred);
+    }
+}
+
+void LevelMeterDisplay::drawLevelBar(juce::Graphics& g, juce::Rectangle<float> track, float rmsDb, float peakDb)
+{
+    auto heightOf = [](float db) { return trackHeight * juce::jlimit(0.0f, 1.0f, (db - minDb) / -minDb); };
+
+    // RMS as the bar, peak as a line above it; red once the peak reaches 0 dBFS
+    const auto rmsHeight = heightOf(rmsDb);
+    g.setColour(juce::Colours::deepskyblue.withAlpha(0.8f));
+    g.fillRoundedRectangle(track.withTop(track.getBottom() - rmsHeight), 2.0f);
+
+    if (peakDb > minDb)
+    {
+        const auto peakY = track.getBottom() - heightOf(peakDb);
+        g.setColour(peakDb >= 0.0f ? juce::Colours::red : juce::Colours::white);
+        g.drawLine(track.getX(), peakY, track.getRight(), peakY, 2.0f);
+    }
+}
+
 //==============================================================================
 // NewProjectAudioProcessorEditor Implementation
 NewProjectAudioProcessorEditor::NewProjectAudioProcessorEditor(NewProjectAudioProcessor& p)
@@ -313,24 +418,88 @@ NewProjectAudioProcessorEditor::NewProjectAudioProcessorEditor(NewProjectAudioPr
     statusLabel.setFont(juce::Font(14.0f, juce::Font::bold));
     addAndMakeVisible(statusLabel);
 
+    // Setup program selector: factory levels, then the user programs
+    programBox.setBounds(215, 10, 115, 25);
+    programBox.setColour(juce::ComboBox::backgroundColourId, juce::Colours::black.withAlpha(0.7f));
+    programBox.setColour(juce::ComboBox::textColourId, juce::Colours::lightblue);
+    programBox.setColour(juce::ComboBox::outlineColourId, juce::Colours::transparentBlack);
+    programBox.onChange = [this]() { onProgramSelected(); };
+    addAndMakeVisible(programBox);
+
+    storeButton.setBounds(335, 10, 55, 25);
+    storeButton.setColour(juce::TextButton::buttonColourId, juce::Colours::black.withAlpha(0.7f));
+    storeButton.setColour(juce::TextButton::textColourOffId, juce::Colours::lightblue);
+    storeButton.onClick = [this]() { onStoreClicked(); };
+    addAndMakeVisible(storeButton);
+    updateProgramBox();
+
     // Setup compression knob
     compressionKnob.setBounds(33, 72, 80, 220); // More to the right, bigger size
     compressionKnob.setLabel("COMP");
-    compressionKnob.setValue(2); // Start at step 3 (middle)
     compressionKnob.onValueChange = [this](int step) { onCompressionValueChanged(step); };
     addAndMakeVisible(compressionKnob);
 
+    // The knob starts from the parameter and follows the host from then on
+    if (auto* levelParameter = audioProcessor.parameters.getParameter("level"))
+    {
+        levelAttachment = std::make_unique<juce::ParameterAttachment>(*levelParameter,
+            [this](float level) { onLevelParameterChanged(level); });
+        levelAttachment->sendInitialUpdate();
+    }
+
+    // Setup level meters, opposite the knob
+    levelMeter.setBounds(287, 72, 90, 220);
+    addAndMakeVisible(levelMeter);
+
+    // The knob and button repaint rarely: keep them as images, so repaints
+    // around them (meters, label) just blit
+    compressionKnob.setActive(bypassButton.getToggleState());
+    compressionKnob.setBufferedToImage(true);
+    bypassButton.setBufferedToImage(true);
+
+    // The background covers everything
+    setOpaque(true);
+
     // Set editor size
     setSize(400, 600);
+
+    // Start metering: the audio thread publishes, the timer reads
+    audioProcessor.setMeteringEnabled(true);
+    lastMeterTime = juce::Time::getMillisecondCounterHiRes();
+    startTimerHz(meterRateHz);
 }
 
 NewProjectAudioProcessorEditor::~NewProjectAudioProcessorEditor()
 {
+    stopTimer();
+    audioProcessor.setMeteringEnabled(false);
 }
 
 //==============================================================================
 void NewProjectAudioProcessorEditor::paint(juce::Graphics& g)
 {
+    // Draw the cached background at device resolution (a plain copy of the
+    // dirty region); rebuilt only when the size or display scale changes
+    const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+    if (! cachedBackground.isValid() || scale != cachedBackgroundScale)
+        renderBackground(scale);
+
+    g.drawImageTransformed(cachedBackground, juce::AffineTransform::scale(1.0f / scale));
+}
+
+void NewProjectAudioProcessorEditor::renderBackground(float scale)
+{
+    cachedBackgroundScale = scale;
+    cachedBackground = juce::Image(juce::Image::RGB,
+        juce::jmax(1, juce::roundToInt(static_cast<float>(getWidth()) * scale)),
+        juce::jmax(1, juce::roundToInt(static_cast<float>(getHeight()) * scale)),
+        false);
+
+    juce::Graphics g(cachedBackground);
+    g.addTransform(juce::AffineTransform::scale(scale));
+    g.setImageResamplingQuality(juce::Graphics::highResamplingQuality);
+
     // Draw background image
     if (backgroundImage.isValid())
     {
@@ -354,7 +523,30 @@ void NewProjectAudioProcessorEditor::paint(juce::Graphics& g)
 
 void NewProjectAudioProcessorEditor::resized()
 {
-    // Components have fixed positions for now
+    // Components have fixed positions for now; the background follows the size
+    cachedBackground = {};
+}
+
+void NewProjectAudioProcessorEditor::timerCallback()
+{
+    const auto now = juce::Time::getMillisecondCounterHiRes();
+    const auto seconds = static_cast<float>((now - lastMeterTime) * 0.001);
+    lastMeterTime = now;
+
+    // Hidden (minimised, another tab): the audio thread stops measuring and
+    // the timer only checks back now and then
+    const auto showing = isShowing();
+    audioProcessor.setMeteringEnabled(showing);
+
+    if (programBox.getSelectedId() != audioProcessor.getCurrentProgram() + 1
+         || audioProcessor.getProgramChangeCount() != shownProgramChanges)
+        updateProgramBox();
+
+    const auto active = showing && levelMeter.update(audioProcessor.getLevels(), seconds);
+    const auto rateHz = active ? meterRateHz : idleRateHz;
+
+    if (getTimerInterval() != 1000 / rateHz)
+        startTimerHz(rateHz);
 }
 
 void NewProjectAudioProcessorEditor::onBypassButtonClicked()
@@ -371,18 +563,66 @@ void NewProjectAudioProcessorEditor::onBypassButtonClicked()
         statusLabel.setText("BYPASSED", juce::dontSendNotification);
         statusLabel.setColour(juce::Label::textColourId, juce::Colours::orange);
     }
-    compressionKnob.repaint();
+    compressionKnob.setActive(isActive);
     audioProcessor.setAutoCompressionEnabled(isActive);
 }
 
 void NewProjectAudioProcessorEditor::onCompressionValueChanged(int step)
 {
+    // Drives the host-automatable "level" parameter (used in Level mode);
+    // the attachment calls back with the new value, which updates the label
+    if (levelAttachment != nullptr)
+        levelAttachment->setValueAsCompleteGesture(static_cast<float>(step + 1));
+}
+
+void NewProjectAudioProcessorEditor::onLevelParameterChanged(float level)
+{
+    // Message thread: the knob's own changes, the host's and the initial value
+    const auto step = juce::roundToInt(level) - 1;
+    compressionKnob.setValue(step);
+
     // Update status to show compression level
     if (bypassButton.getToggleState()) // If active
     {
         statusLabel.setText("LEVEL " + juce::String(step + 1), juce::dontSendNotification);
     }
+}
+
+void NewProjectAudioProcessorEditor::onProgramSelected()
+{
+    const auto index = programBox.getSelectedId() - 1;
+
+    if (index < 0 || index == audioProcessor.getCurrentProgram())
+        return;
+
+    // Glides to the new settings on the audio thread: safe to switch mid-show
+    audioProcessor.setCurrentProgram(index);
+    audioProcessor.updateHostDisplay(juce::AudioProcessor::ChangeDetails().withProgramChanged(true));
+    storeButton.setEnabled(autocomp::ProgramBank::isUser(index));
+}
+
+void NewProjectAudioProcessorEditor::onStoreClicked()
+{
+    const auto index = audioProcessor.getCurrentProgram();
+
+    if (audioProcessor.storeUserProgram(index))
+        statusLabel.setText("STORED " + audioProcessor.getProgramName(index).toUpperCase(), juce::dontSendNotification);
+}
+
+void NewProjectAudioProcessorEditor::updateProgramBox()
+{
+    shownProgramChanges = audioProcessor.getProgramChangeCount();
+    programBox.clear(juce::dontSendNotification);
+
+    for (int i = 0; i < audioProcessor.getNumPrograms(); ++i)
+    {
+        if (i == autocomp::ProgramBank::numFactoryPrograms)
+            programBox.addSeparator();
+
+        programBox.addItem(audioProcessor.getProgramName(i), i + 1);
+    }
 
-    // Here you would connect to the processor to set compression amount
-    // audioProcessor.setCompressionLevel(step);
+    const auto current = audioProcessor.getCurrentProgram();
+    programBox.setSelectedId(current + 1, juce::dontSendNotification);
+    storeButton.setEnabled(autocomp::ProgramBank::isUser(current));
 }
\ No newline at end of file
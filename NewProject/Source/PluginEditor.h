@@ -57,6 +57,9 @@ public:
     // Label
     void setLabel(const juce::String& labelText) { label = labelText; }
 
+    // Steps are only coloured while the compressor is active (set by the editor)
+    void setActive(bool shouldBeActive);
+
     // Callback for value changes
     std::function<void(int)> onValueChange;
 
@@ -64,6 +67,7 @@ private:
     int currentStep = 2; // Default to middle position (step 3)
     bool isMouseOver = false;
     bool isDragging = false;
+    bool isActive = false;
     juce::Point<int> lastMousePos;
     juce::String label = "KNOB";
 
@@ -73,14 +77,53 @@ private:
     static constexpr float trackHeight = 110.0f;
     static constexpr int numSteps = 5;
 
+    // Heart handle around the origin, built once (knobRadius never changes);
+    // the outline is pre-stroked so painting is three path fills
+    juce::Path heartShape;
+    juce::Path heartOutline;
+
+    // Helper functions
+    static juce::Path createHeart(float size);
+};
+
+//==============================================================================
+// Input, gain reduction and output meters. The editor's timer feeds it
+// readings; peaks and reduction fall back at a fixed rate between them.
+class LevelMeterDisplay : public juce::Component
+{
+public:
+    LevelMeterDisplay();
+    ~LevelMeterDisplay() override = default;
+
+    void paint(juce::Graphics& g) override;
+
+    // Takes a reading covering the last `seconds`; repaints if anything
+    // visible changed. Returns false once there is no audio and every
+    // meter has come to rest, so the caller can stop polling fast.
+    bool update(const autocomp::LevelReading& reading, float seconds);
+
+private:
+    float inputPeakDb = minDb, inputRmsDb = minDb;
+    float outputPeakDb = minDb, outputRmsDb = minDb;
+    float reductionDb = 0.0f;
+
+    // Visual parameters
+    static constexpr float minDb = -60.0f;
+    static constexpr float maxReductionDb = 24.0f;
+    static constexpr float fallDbPerSecond = 24.0f;
+    static constexpr float trackWidth = 10.0f;
+    static constexpr float trackHeight = 150.0f;
+
     // Helper functions
-    void drawHeart(juce::Graphics& g, juce::Point<float> center, float size, juce::Colour colour);
+    void drawLevelBar(juce::Graphics& g, juce::Rectangle<float> track, float rmsDb, float peakDb);
+    juce::Rectangle<int> getColumnBounds(int column) const;
 };
 
 //==============================================================================
 /**
 */
-class NewProjectAudioProcessorEditor : public juce::AudioProcessorEditor
+class NewProjectAudioProcessorEditor : public juce::AudioProcessorEditor,
+                                       private juce::Timer
 {
 public:
     NewProjectAudioProcessorEditor(NewProjectAudioProcessor&);
@@ -99,10 +142,37 @@ private:
     CircularButton bypassButton;
     juce::Label statusLabel;
     VerticalKnob compressionKnob;
+    juce::ComboBox programBox;
+
+    // Keeps the knob and the "level" parameter in step both ways (session
+    // restore, automation, reopening the editor)
+    std::unique_ptr<juce::ParameterAttachment> levelAttachment;
+    juce::TextButton storeButton { "STORE" };
+
+    // Background image and marker, rendered once per size and display scale
+    juce::Image cachedBackground;
+    float cachedBackgroundScale = 0.0f;
+    void renderBackground(float scale);
 
     // Callbacks
     void onBypassButtonClicked();
     void onCompressionValueChanged(int step);
+    void onLevelParameterChanged(float level);
+    void onProgramSelected();
+    void onStoreClicked();
+
+    // Program list, refilled when the host switches programs or the bank's
+    // contents change (a program stored or renamed, a session loaded)
+    std::uint32_t shownProgramChanges = 0;
+    void updateProgramBox();
+
+    // Metering: fast while there is audio or a meter is still falling,
+    // slow otherwise; the audio thread only measures while the editor shows
+    static constexpr int meterRateHz = 30;
+    static constexpr int idleRateHz = 4;
+    LevelMeterDisplay levelMeter;
+    double lastMeterTime = 0.0;
+    void timerCallback() override;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NewProjectAudioProcessorEditor)
 };
\ No newline at end of file
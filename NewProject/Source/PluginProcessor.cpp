@@ -1,43 +1,140 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "DSP/RealtimeCheck.h"
 
-//  - ÷ ʱȭ  Ķ 
+// 생성자 - 플러그인 초기화 및 파라미터 설정
 AutoCompressorAudioProcessor::AutoCompressorAudioProcessor()
 #ifndef JucePlugin_PreferredChannelConfigurations
     : AudioProcessor(BusesProperties()
 #if ! JucePlugin_IsMidiEffect
 #if ! JucePlugin_IsSynth
-        .withInput("Input", juce::AudioChannelSet::stereo(), true)   // ׷ Է 
+        .withInput("Input", juce::AudioChannelSet::stereo(), true)   // 스테레오 입력 설정
+        .withInput("Sidechain", juce::AudioChannelSet::stereo(), false) // 외부 사이드체인 (선택)
 #endif
-        .withOutput("Output", juce::AudioChannelSet::stereo(), true) // ׷  
+        .withOutput("Output", juce::AudioChannelSet::stereo(), true) // 스테레오 출력 설정
 #endif
     ),
 #endif
-    parameters(*this, nullptr, juce::Identifier("AutoCompressor"),
-        {
-            // Auto Compress Ȱȭ/Ȱȭ Ķ  (⺻: true)
-            std::make_unique<juce::AudioParameterBool>("autoCompress", "Auto Compress", true)
-        })
+    parameters(*this, nullptr, juce::Identifier("AutoCompressor"), createParameterLayout())
 {
-    // Ķ  
+    // 파라미터 포인터 연결
     autoCompressEnabled = parameters.getRawParameterValue("autoCompress");
+    modeParameter = parameters.getRawParameterValue("mode");
+    lookaheadParameter = parameters.getRawParameterValue("lookahead");
+    oversamplingParameter = parameters.getRawParameterValue("oversampling");
+    bandsParameter = parameters.getRawParameterValue("bands");
+    sidechainParameter = parameters.getRawParameterValue("sidechain");
+    detectorHighPassParameter = parameters.getRawParameterValue("detectorHighPass");
+    linkModeParameter = parameters.getRawParameterValue("linkMode");
+    targetLoudnessParameter = parameters.getRawParameterValue("targetLoudness");
+    levelParameter = parameters.getRawParameterValue("level");
+    thresholdParameter = parameters.getRawParameterValue("threshold");
+    ratioParameter = parameters.getRawParameterValue("ratio");
+    attackParameter = parameters.getRawParameterValue("attack");
+    releaseParameter = parameters.getRawParameterValue("release");
+    makeupParameter = parameters.getRawParameterValue("makeup");
+
+    // 프로그램 선택 시 쓸 파라미터 (선택 경로에서 ID 조회 없음)
+    programParameters = { parameters.getParameter("threshold"), parameters.getParameter("ratio"),
+                          parameters.getParameter("attack"), parameters.getParameter("release"),
+                          parameters.getParameter("makeup") };
+    modeChoice = parameters.getParameter("mode");
+
+    // 바이너리 상태의 키: 파라미터 ID 해시 (순서가 바뀌거나 추가돼도 유지)
+    for (auto* param : getParameters())
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(param))
+        {
+            const auto id = autocomp::state::hashId(ranged->getParameterID().toRawUTF8());
+
+            for (const auto& existing : stateParameters)
+                jassert(existing.first != id);  // 해시 충돌: ID를 바꿀 것
+
+            stateParameters.emplace_back(id, ranged);
+        }
+
+    jassert(static_cast<int>(stateParameters.size()) <= autocomp::state::maxParameters);
+}
 
-    // м  ʱȭ (׷,  ũ)
-    analysisBuffer.setSize(2, analysisBufferSize);
+// 호스트에 노출되는 파라미터 목록 (모두 오토메이션 가능)
+juce::AudioProcessorValueTreeState::ParameterLayout AutoCompressorAudioProcessor::createParameterLayout()
+{
+    auto msRange = [](float start, float end, float centre)
+    {
+        juce::NormalisableRange<float> range(start, end, 0.01f);
+        range.setSkewForCentre(centre);
+        return range;
+    };
+
+    juce::NormalisableRange<float> ratioRange(1.0f, 20.0f, 0.01f);
+    ratioRange.setSkewForCentre(4.0f);
+
+    juce::AudioProcessorValueTreeState::ParameterLayout layout;
+
+    // Auto Compress 활성화/비활성화 파라미터 생성 (기본값: true)
+    layout.add(std::make_unique<juce::AudioParameterBool>("autoCompress", "Auto Compress", true));
+
+    // 동작 모드: 자동 분석 / 레벨 프리셋 / 개별 파라미터
+    layout.add(std::make_unique<juce::AudioParameterChoice>("mode", "Mode",
+        juce::StringArray { "Auto", "Level", "Custom" }, autoMode));
+
+    // 레벨 노브 (1-5단계)
+    layout.add(std::make_unique<juce::AudioParameterInt>("level", "Level", 1, 5, 3));
+
+    // 개별 컴프레서 파라미터 (Custom 모드)
+    layout.add(std::make_unique<juce::AudioParameterFloat>("threshold", "Threshold",
+        juce::NormalisableRange<float>(-60.0f, 0.0f, 0.1f), -20.0f, "dB"));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("ratio", "Ratio", ratioRange, 4.0f, ":1"));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("attack", "Attack", msRange(0.1f, 200.0f, 10.0f), 10.0f, "ms"));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("release", "Release", msRange(5.0f, 2000.0f, 100.0f), 100.0f, "ms"));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("makeup", "Makeup",
+        juce::NormalisableRange<float>(0.0f, 24.0f, 0.1f), 0.0f, "dB"));
+
+    // 오토 모드 목표 라우드니스 (BS.1770, 메이크업 게인으로 맞춤)
+    layout.add(std::make_unique<juce::AudioParameterFloat>("targetLoudness", "Target Loudness",
+        juce::NormalisableRange<float>(-36.0f, -6.0f, 0.5f), -14.0f, "LUFS"));
+
+    // 룩어헤드 (0-10ms, 레이턴시가 바뀌므로 오토메이션 불가)
+    layout.add(std::make_unique<juce::AudioParameterFloat>("lookahead", "Lookahead",
+        juce::NormalisableRange<float>(0.0f, autocomp::CompressorEngine::maxLookaheadMs, 0.1f), 0.0f,
+        juce::AudioParameterFloatAttributes().withLabel("ms").withAutomatable(false)));
+
+    // 오버샘플링 (디텍터/게인 단계 에일리어싱 및 인터샘플 피크 대응, 레이턴시 변경)
+    layout.add(std::make_unique<juce::AudioParameterChoice>("oversampling", "Oversampling",
+        juce::StringArray { "1x", "2x", "4x" }, 0,
+        juce::AudioParameterChoiceAttributes().withAutomatable(false)));
+
+    // 멀티밴드 (1 = 전대역, 3/4밴드는 Linkwitz-Riley 크로스오버로 분할, 레이턴시 없음)
+    layout.add(std::make_unique<juce::AudioParameterChoice>("bands", "Bands",
+        juce::StringArray { "1", "3", "4" }, 0,
+        juce::AudioParameterChoiceAttributes().withAutomatable(false)));
+
+    // 외부 사이드체인으로 디텍터 구동 (연결되지 않았으면 메인 입력 사용)
+    layout.add(std::make_unique<juce::AudioParameterBool>("sidechain", "External Sidechain", false));
+
+    // 디텍터 하이패스 (0 = 끔), 저역이 게인을 끌어내리지 않도록
+    layout.add(std::make_unique<juce::AudioParameterFloat>("detectorHighPass", "Detector High-Pass",
+        juce::NormalisableRange<float>(0.0f, 500.0f, 1.0f, 0.5f), 0.0f,
+        juce::AudioParameterFloatAttributes().withLabel("Hz")));
+
+    // 채널 링크: 전체 / 채널별 / 서라운드 그룹 (LCR, 서라운드, 하이트 각각 링크, LFE 제외)
+    layout.add(std::make_unique<juce::AudioParameterChoice>("linkMode", "Channel Link",
+        juce::StringArray { "Linked", "Unlinked", "Surround Groups" }, linkedMode));
+
+    return layout;
 }
 
-// Ҹ
+// 소멸자
 AutoCompressorAudioProcessor::~AutoCompressorAudioProcessor()
 {
 }
 
-// ÷ ̸ ȯ
+// 플러그인 이름 반환
 const juce::String AutoCompressorAudioProcessor::getName() const
 {
     return JucePlugin_Name;
 }
 
-// MIDI Է   Ȯ
+// MIDI 입력 허용 여부 확인
 bool AutoCompressorAudioProcessor::acceptsMidi() const
 {
 #if JucePlugin_WantsMidiInput
@@ -47,7 +144,7 @@ bool AutoCompressorAudioProcessor::acceptsMidi() const
 #endif
 }
 
-// MIDI    Ȯ
+// MIDI 출력 생성 여부 확인
 bool AutoCompressorAudioProcessor::producesMidi() const
 {
 #if JucePlugin_ProducesMidiOutput
@@ -57,7 +154,7 @@ bool AutoCompressorAudioProcessor::producesMidi() const
 #endif
 }
 
-// MIDI Ʈ  Ȯ
+// MIDI 이펙트 여부 확인
 bool AutoCompressorAudioProcessor::isMidiEffect() const
 {
 #if JucePlugin_IsMidiEffect
@@ -67,78 +164,196 @@ bool AutoCompressorAudioProcessor::isMidiEffect() const
 #endif
 }
 
-//   ȯ (Ʈ  ϴ ð)
+// 테일 길이 반환 (이펙트가 오디오를 지속하는 시간)
 double AutoCompressorAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0; //   
+    // 룩어헤드 + 오버샘플링 필터 전체 길이 (+ 멀티밴드 크로스오버 잔향)
+    return engine.getTailSamples() / engine.getSampleRate();
 }
 
-// α׷  ȯ
+// 프로그램 개수 반환 (팩토리 + 사용자)
 int AutoCompressorAudioProcessor::getNumPrograms()
 {
-    return 1; //  α׷ 
+    return autocomp::ProgramBank::numPrograms;
 }
 
-//  α׷ ε ȯ
+// 현재 프로그램 인덱스 반환
 int AutoCompressorAudioProcessor::getCurrentProgram()
 {
-    return 0;
+    return programs.getCurrent();
 }
 
-// α׷  ( )
+// 프로그램 변경: 설정을 Custom 파라미터에 쓰고 Custom 모드로 전환 (엔진이 20ms 동안 글라이드해서 클릭 없음)
+// 메시지 스레드 전용: setValueNotifyingHost가 호스트와 에디터 리스너를 그 자리에서 호출하고,
+// 사용자 프로그램은 저장/이름 변경/불러오기 (메시지 스레드) 와 동기화 없이 공유됨
 void AutoCompressorAudioProcessor::setCurrentProgram(int index)
 {
+    autocomp::CompressorSettings settings;
+
+    if (! programs.getSettings(index, settings))
+        return;
+
+    programs.setCurrent(index);
+
+    const float values[] = { settings.threshold, settings.ratio, settings.attack, settings.release, settings.makeupGain };
+
+    for (size_t i = 0; i < programParameters.size(); ++i)
+        programParameters[i]->setValueNotifyingHost(programParameters[i]->convertTo0to1(values[i]));
+
+    // 모드는 마지막에: 오디오 스레드가 Custom으로 바뀔 때는 이미 새 값
+    modeChoice->setValueNotifyingHost(modeChoice->convertTo0to1(static_cast<float>(customMode)));
 }
 
-// α׷ ̸ ȯ
+// 프로그램 이름 반환
 const juce::String AutoCompressorAudioProcessor::getProgramName(int index)
 {
-    return {};
+    return juce::String::fromUTF8(programs.getName(index));
 }
 
-// α׷ ̸  ( )
+// 프로그램 이름 변경 (사용자 프로그램만, 팩토리 프로그램은 읽기 전용)
 void AutoCompressorAudioProcessor::changeProgramName(int index, const juce::String& newName)
 {
+    programs.rename(index, newName.toRawUTF8());
+}
+
+// 프로그램 목록 내용이 바뀐 횟수 (선택 변경은 제외)
+std::uint32_t AutoCompressorAudioProcessor::getProgramChangeCount() const
+{
+    return programs.getChangeCount();
+}
+
+// 지금 들리는 설정 (오토/레벨/커스텀 어느 모드든) 을 사용자 프로그램에 저장
+bool AutoCompressorAudioProcessor::storeUserProgram(int index)
+{
+    if (! programs.store(index, engine.getActiveSettings()))
+        return false;
+
+    updateHostDisplay(ChangeDetails().withProgramChanged(true));
+    return true;
 }
 
-//  ó غ - ÷Ʈ  ũ 
+// 오디오 처리 준비 - 샘플레이트와 버퍼 크기 설정
 void AutoCompressorAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
-    this->sampleRate = sampleRate;
-    updateCompressorCoefficients(); //   Ʈ
+    // 분석 스레드를 멈춘 상태에서 엔진 준비 (FIFO/분석기 재할당)
+    analysisWorker.stop();
+
+    // 엔진 메모리 할당 (게인 커브 스크래치 버퍼, 룩어헤드 딜레이 포함) 및 상태 초기화
+    // 64비트 호스트는 double 버퍼를 그대로 넘김 (변환 없음)
+    // 채널 수는 메인 버스만 (사이드체인은 디텍터가 버스 버퍼를 직접 읽음, 분석에는 들어가지 않음)
+    engine.prepare(sampleRate, samplesPerBlock, getMainBusNumInputChannels(), isUsingDoublePrecision());
+    prepareSurroundLink();
+    updateLatencyParameters();
+    setLatencySamples(engine.getLatencySamples());
+
+    // 오디오 스레드는 FIFO에 샘플만 넣고, 분석은 백그라운드에서
+    // (오프라인 렌더링은 결과가 재현되도록 오디오 스레드에서 직접 분석)
+    if (! isNonRealtime())
+        analysisWorker.start();
+}
+
+// 메인 버스 채널 종류로 서라운드 링크 그룹과 BS.1770 채널 가중치 설정 (분석 스레드 정지 상태)
+void AutoCompressorAudioProcessor::prepareSurroundLink()
+{
+    enum { frontGroup = 0, surroundGroup, heightGroup };
 
-    // м  ʱȭ
-    analysisBuffer.clear();
-    analysisBufferIndex = 0;
-    needsAnalysis = true;
+    const auto layout = getChannelLayoutOfBus(true, 0);
+    const auto numChannels = juce::jmin(layout.size(), autocomp::LinkGroups::maxChannels);
+    int groupOfChannel[autocomp::LinkGroups::maxChannels] {};
+    float weights[autocomp::LinkGroups::maxChannels] {};
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        switch (layout.getTypeOfChannel(channel))
+        {
+            case juce::AudioChannelSet::LFE:
+            case juce::AudioChannelSet::LFE2:
+                groupOfChannel[channel] = autocomp::LinkGroups::excluded;
+                weights[channel] = 0.0f;
+                break;
+
+            case juce::AudioChannelSet::left:
+            case juce::AudioChannelSet::right:
+            case juce::AudioChannelSet::centre:
+            case juce::AudioChannelSet::leftCentre:
+            case juce::AudioChannelSet::rightCentre:
+            case juce::AudioChannelSet::wideLeft:
+            case juce::AudioChannelSet::wideRight:
+                groupOfChannel[channel] = frontGroup;
+                weights[channel] = 1.0f;
+                break;
+
+            case juce::AudioChannelSet::topFrontLeft:
+            case juce::AudioChannelSet::topFrontCentre:
+            case juce::AudioChannelSet::topFrontRight:
+            case juce::AudioChannelSet::topMiddle:
+            case juce::AudioChannelSet::topSideLeft:
+            case juce::AudioChannelSet::topSideRight:
+            case juce::AudioChannelSet::topRearLeft:
+            case juce::AudioChannelSet::topRearCentre:
+            case juce::AudioChannelSet::topRearRight:
+                groupOfChannel[channel] = heightGroup;
+                weights[channel] = 1.0f;
+                break;
+
+            default:    // 사이드/리어 서라운드
+                groupOfChannel[channel] = surroundGroup;
+                weights[channel] = 1.41f;
+                break;
+        }
+    }
 
-    //   ʱȭ
-    envelope = 0.0f;        //  ȷο ʱȭ
-    currentRMS = 0.0f;      //  RMS  ʱȭ
+    surroundGroups.assign(groupOfChannel, numChannels);
+    engine.setLoudnessChannelWeights(weights, numChannels);
 }
 
-// ҽ 
+// 리소스 해제 - 분석 스레드 정지
 void AutoCompressorAudioProcessor::releaseResources()
 {
+    analysisWorker.stop();
+
+    // 실시간 검사 빌드에서 processBlock 중 할당/락이 있었다면 호출 스택과 함께 보고
+    if (autocomp::realtime::getNumViolations() > 0)
+    {
+        DBG(autocomp::realtime::describeViolations());
+        autocomp::realtime::clearViolations();
+        jassertfalse;
+    }
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
-//  ̾ƿ   Ȯ
+// 버스 레이아웃 지원 여부 확인
 bool AutoCompressorAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
 {
 #if JucePlugin_IsMidiEffect
     juce::ignoreUnused(layouts);
     return true;
 #else
-    //  Ǵ ׷ 
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-        && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // 모노, 스테레오, 5.1, 7.1, 7.1.4 지원
+    const auto output = layouts.getMainOutputChannelSet();
+
+    if (output != juce::AudioChannelSet::mono()
+        && output != juce::AudioChannelSet::stereo()
+        && output != juce::AudioChannelSet::create5point1()
+        && output != juce::AudioChannelSet::create7point1()
+        && output != juce::AudioChannelSet::create7point1point4())
         return false;
 
 #if ! JucePlugin_IsSynth
-    // Է°  ä  ؾ 
+    // 입력과 출력 채널 수가 동일해야 함
     if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
         return false;
+
+    // 사이드체인은 비활성, 모노 또는 스테레오
+    if (layouts.inputBuses.size() > 1)
+    {
+        const auto sidechain = layouts.getChannelSet(true, 1);
+
+        if (! sidechain.isDisabled()
+            && sidechain != juce::AudioChannelSet::mono()
+            && sidechain != juce::AudioChannelSet::stereo())
+            return false;
+    }
 #endif
 
     return true;
@@ -146,49 +361,150 @@ bool AutoCompressorAudioProcessor::isBusesLayoutSupported(const BusesLayout& lay
 }
 #endif
 
-//   ó Լ
+// 메인 오디오 처리 함수 (32비트)
 void AutoCompressorAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
-    juce::ScopedNoDenormals noDenormals; // ȭ  
-    auto totalNumInputChannels = getTotalNumInputChannels();
+    juce::ignoreUnused(midiMessages);
+    process(buffer, false);
+}
+
+// 64비트 처리 - 호스트가 double 믹스 엔진이면 변환 없이 직접 처리
+void AutoCompressorAudioProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused(midiMessages);
+    process(buffer, false);
+}
+
+// 호스트 바이패스 - 그냥 두면 레이턴시 없는 원음이 나와 보상이 어긋나고 전환 시 클릭
+// 같은 지연 경로로 크로스페이드 후 지연된 원음 출력
+void AutoCompressorAudioProcessor::processBlockBypassed(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused(midiMessages);
+    process(buffer, true);
+}
+
+void AutoCompressorAudioProcessor::processBlockBypassed(juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused(midiMessages);
+    process(buffer, true);
+}
+
+bool AutoCompressorAudioProcessor::supportsDoublePrecisionProcessing() const
+{
+    return true;
+}
+
+template <typename SampleType>
+void AutoCompressorAudioProcessor::process(juce::AudioBuffer<SampleType>& buffer, bool hostBypassed)
+{
+    juce::ScopedNoDenormals noDenormals; // 비정규화된 수 방지
+    autocomp::realtime::ScopedCheck realtimeCheck; // CUMPRESSOR_REALTIME_CHECKS 빌드: 블록 안의 할당/락 기록
+    auto totalNumInputChannels = getMainBusNumInputChannels(); // 사이드체인 제외
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
-    //  ʴ  ä Ŭ
+    // 사용하지 않는 출력 채널 클리어
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
 
-    // Auto Compress Ȱȭ  Ȯ
-    bool autoCompressOn = *autoCompressEnabled > 0.5f;
-
-    if (autoCompressOn)
+    // 메시지 스레드에서 요청된 설정을 블록당 한 번만 반영 (락 없음)
+    engine.beginBlock();
+
+    // 룩어헤드/오버샘플링 변경은 할당 없이 엔진에 반영, 레이턴시 보고는 메시지 스레드에서
+    if (updateLatencyParameters())
+        triggerAsyncUpdate();
+
+    // 밴드 수 변경도 할당 없음 (밴드별 설정은 아래에서 고른 설정으로부터 유도)
+    static constexpr int bandCounts[] = { 1, 3, 4 };
+    engine.setNumBands(bandCounts[juce::jlimit(0, 2, static_cast<int>(bandsParameter->load()))]);
+
+    // 메인 버스만 오디오로 처리 (버스 버퍼는 같은 메모리를 가리킴, 복사 없음)
+    auto mainBuffer = getBusBuffer(buffer, true, 0);
+    auto* const* channels = mainBuffer.getArrayOfWritePointers();
+    const auto numChannels = juce::jmin(mainBuffer.getNumChannels(), autocomp::CompressorEngine::maxChannels);
+    const auto numSamples = buffer.getNumSamples();
+
+    // 라우드니스 측정은 모드/활성화와 무관하게 항상 (FIFO에 넣기만 함, 긴 무음은 건너뜀)
+    engine.setLoudnessTarget(targetLoudnessParameter->load());
+    engine.analyzeAudioLevel(channels, numChannels, numSamples);
+
+    // Auto Compress 끄기/호스트 바이패스: 엔진이 10ms 크로스페이드 후 게인 없는 같은 지연 경로로 전환
+    // (보고한 레이턴시 유지, 클릭 없음). 페이드 중에도 압축은 계속되므로 아래 설정은 그대로 반영
+    const bool autoCompressOn = *autoCompressEnabled > 0.5f;
+    engine.setBypassed(hostBypassed || ! autoCompressOn);
+
+    // 1. 파라미터 결정: 자동 분석 또는 호스트 파라미터 (엔진에서 샘플 단위로 스무딩)
+    const auto mode = static_cast<int>(modeParameter->load());
+
+    if (mode == autoMode)
+        engine.applyAutoParameters(); // 최신 분석 결과로 티어/메이크업 선택
+    else if (mode == levelMode)
+        engine.setTargetCompressionLevel(static_cast<int>(levelParameter->load()) - 1); // 미리 계산된 테이블 조회
+    else
+        engine.setTargetSettings(getCustomSettings());
+
+    // 2. 게인 커브 계산 (디텍터 + 게인 컴퓨터 + 엔벨로프 + 메이크업) -> 스크래치 버퍼
+    //    룩어헤드: 디텍터는 지연 전 신호를 보고, 게인은 지연된 오디오에 적용
+    // 3. 모든 채널에 게인 적용 (벡터 연산)
+    // 엔진이 준비된 블록 크기로 나누고, 오버샘플링 시 업샘플 -> 2, 3 -> 다운샘플
+    // 멀티밴드: 밴드별 디텍터/게인 컴퓨터를 SIMD 레인 하나씩으로 함께 처리 후 합산
+    engine.setDetectorHighPass(detectorHighPassParameter->load());
+
+    // 링크 그룹별 디텍터 하나 (그룹 내 최대값은 채널 수와 무관하게 SIMD 한 번에)
+    const auto linkMode = static_cast<int>(linkModeParameter->load());
+
+    if (linkMode == surroundMode)
+        engine.setLinkGroups(surroundGroups);
+    else
+        engine.setStereoLink(linkMode == unlinkedMode ? autocomp::StereoLink::unlinked : autocomp::StereoLink::linked);
+
+    // 사이드체인: 디텍터가 버스 버퍼 포인터를 직접 읽음 (같은 커널, 샘플당 분기 없음)
+    if (sidechainParameter->load() > 0.5f && getBusCount(true) > 1)
     {
-        // 1.   м
-        analyzeAudioLevel(buffer);
+        const auto sidechain = getBusBuffer(buffer, true, 1);
 
-        // 2. м ʿϸ ڵ Ķ 
-        if (needsAnalysis)
+        if (sidechain.getNumChannels() > 0)
         {
-            calculateAutoParameters();      // ڵ Ķ 
-            updateCompressorCoefficients(); //   Ʈ
-            needsAnalysis = false;
+            engine.compress(channels, numChannels, numSamples,
+                            sidechain.getArrayOfReadPointers(), sidechain.getNumChannels());
+            return;
         }
+    }
 
-        // 3.  äο  
-        for (int channel = 0; channel < totalNumInputChannels; ++channel)
-        {
-            auto* channelData = buffer.getWritePointer(channel);
+    // 디지털 무음이 테일 길이 이상 이어지면 엔진이 블록을 건너뜀 (쉬는 트랙은 CPU 거의 0)
+    engine.compress(channels, numChannels, numSamples);
+}
 
-            for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
-            {
-                channelData[sample] = applyCompression(channelData[sample]);
-            }
-        }
-    }
+// 레이턴시에 영향을 주는 파라미터 반영, 레이턴시가 바뀌면 true
+bool AutoCompressorAudioProcessor::updateLatencyParameters()
+{
+    const auto factor = 1 << static_cast<int>(oversamplingParameter->load()); // 1x, 2x, 4x
+    const auto oversamplingChanged = engine.setOversamplingFactor(factor);
+    const auto lookaheadChanged = engine.setLookahead(lookaheadParameter->load());
+
+    return oversamplingChanged || lookaheadChanged;
 }
 
-// UI ϱ  public Լ
+// 룩어헤드 변경 시 호스트에 새 레이턴시 보고 (메시지 스레드)
+void AutoCompressorAudioProcessor::handleAsyncUpdate()
+{
+    setLatencySamples(engine.getLatencySamples());
+}
+
+// Custom 모드에서 사용할 설정 (오디오 스레드, 원자적 파라미터 값만 읽음)
+autocomp::CompressorSettings AutoCompressorAudioProcessor::getCustomSettings() const
+{
+    autocomp::CompressorSettings custom;
+    custom.threshold = thresholdParameter->load();
+    custom.ratio = ratioParameter->load();
+    custom.attack = attackParameter->load();
+    custom.release = releaseParameter->load();
+    custom.makeupGain = makeupParameter->load();
+    return custom;
+}
 
-// ڵ  Ȱȭ/Ȱȭ 
+// UI와 연결하기 위한 public 함수들
+
+// 자동 컴프레션 활성화/비활성화 설정
 void AutoCompressorAudioProcessor::setAutoCompressionEnabled(bool enabled)
 {
     if (auto* param = parameters.getParameter("autoCompress"))
@@ -197,223 +513,120 @@ void AutoCompressorAudioProcessor::setAutoCompressionEnabled(bool enabled)
     }
 }
 
-// ڵ  Ȱȭ  ȯ
+// 자동 컴프레션 활성화 상태 반환
 bool AutoCompressorAudioProcessor::isAutoCompressionEnabled() const
 {
     return *autoCompressEnabled > 0.5f;
 }
 
-//   м Լ
-void AutoCompressorAudioProcessor::analyzeAudioLevel(const juce::AudioBuffer<float>& buffer)
+// 에디터 존재 여부 반환
+bool AutoCompressorAudioProcessor::hasEditor() const
 {
-    // RMS (Root Mean Square)  
-    float sumSquares = 0.0f;
-    int totalSamples = 0;
-
-    //  ä   ȸϿ  
-    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
-    {
-        const auto* channelData = buffer.getReadPointer(channel);
-
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
-        {
-            sumSquares += channelData[sample] * channelData[sample];
-            totalSamples++;
-        }
-    }
+    return true;
+}
 
-    // RMS    
-    float rms = std::sqrt(sumSquares / totalSamples);
-    currentRMS = rmsSmoothing * currentRMS + (1.0f - rmsSmoothing) * rms;
+// 에디터 생성
+juce::AudioProcessorEditor* AutoCompressorAudioProcessor::createEditor()
+{
+    return new NewProjectAudioProcessorEditor(*this);
+}
 
-    // м ۿ   (ȯ  )
-    for (int channel = 0; channel < std::min(buffer.getNumChannels(), analysisBuffer.getNumChannels()); ++channel)
-    {
-        const auto* sourceData = buffer.getReadPointer(channel);
-        auto* destData = analysisBuffer.getWritePointer(channel);
+// 플러그인 상태 저장 (바이너리 청크: XML보다 작고 파싱 없이 로드)
+void AutoCompressorAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
+{
+    autocomp::state::ParameterValue values[autocomp::state::maxParameters];
+    int numValues = 0;
 
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
-        {
-            destData[analysisBufferIndex] = sourceData[sample];
-            analysisBufferIndex = (analysisBufferIndex + 1) % analysisBufferSize;
+    for (const auto& [id, param] : stateParameters)
+        values[numValues++] = { id, param->convertFrom0to1(param->getValue()) };
 
-            // ۰  á  м ÷ 
-            if (analysisBufferIndex == 0)
-                needsAnalysis = true;
-        }
-    }
+    // 파라미터 청크 뒤에 사용자 프로그램 뱅크
+    const auto chunkSize = autocomp::state::getSize(numValues);
+    destData.setSize(chunkSize + autocomp::ProgramBank::serialisedSize);
+    autocomp::state::write(values, numValues, destData.getData(), chunkSize);
+    programs.write(static_cast<char*>(destData.getData()) + chunkSize, autocomp::ProgramBank::serialisedSize);
 }
 
-//  RMS   ڵ Ķ 
-void AutoCompressorAudioProcessor::calculateAutoParameters()
+// 플러그인 상태 복원
+void AutoCompressorAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
-    //  RMS  dB ȯ
-    float rmsDb = linearToDb(currentRMS);
+    if (restoreStateChunk(data, sizeInBytes))
+        return;
 
-    // RMS    Ķ ڵ 
-    if (rmsDb < -60.0f)         // ſ  ȣ (-60dB )
-    {
-        threshold = -40.0f;     // Ӱ谪
-        ratio = 2.0f;           // 
-        attack = 20.0f;         //  ð (ms)
-        release = 200.0f;       //  ð (ms)
-        makeupGain = 6.0f;      // ũ  (dB)
-    }
-    else if (rmsDb < -40.0f)    //  ȣ (-40dB ~ -60dB)
-    {
-        threshold = -30.0f;
-        ratio = 3.0f;
-        attack = 15.0f;
-        release = 150.0f;
-        makeupGain = 4.0f;
-    }
-    else if (rmsDb < -20.0f)    //  ȣ (-20dB ~ -40dB)
-    {
-        threshold = -20.0f;
-        ratio = 4.0f;
-        attack = 10.0f;
-        release = 100.0f;
-        makeupGain = 2.0f;
-    }
-    else if (rmsDb < -10.0f)    // ū ȣ (-10dB ~ -20dB)
-    {
-        threshold = -15.0f;
-        ratio = 6.0f;
-        attack = 5.0f;
-        release = 80.0f;
-        makeupGain = 1.0f;
-    }
-    else                        // ſ ū ȣ (-10dB ̻)
-    {
-        threshold = -10.0f;
-        ratio = 8.0f;
-        attack = 2.0f;
-        release = 50.0f;
-        makeupGain = 0.0f;
-    }
-}
+    // 이전 버전 세션 (XML 상태)
+    std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
 
-//   Ʈ (/ ð  )
-void AutoCompressorAudioProcessor::updateCompressorCoefficients()
-{
-    // / ð 1   ȯ
-    attackCoeff = std::exp(-1.0f / (attack * 0.001f * sampleRate));
-    releaseCoeff = std::exp(-1.0f / (release * 0.001f * sampleRate));
+    if (xmlState.get() != nullptr)
+        if (xmlState->hasTagName(parameters.state.getType()))
+            parameters.replaceState(juce::ValueTree::fromXml(*xmlState));
 }
 
-//  ÿ  
-float AutoCompressorAudioProcessor::applyCompression(float inputSample)
+// 바이너리 상태 복원 (할당 없음). XML 상태면 false
+bool AutoCompressorAudioProcessor::restoreStateChunk(const void* data, int sizeInBytes)
 {
-    // Է   ()
-    float inputLevel = std::abs(inputSample);
-    float inputDb = linearToDb(inputLevel);
+    const auto size = static_cast<size_t>(juce::jmax(sizeInBytes, 0));
 
-    //  
-    float compressedDb = inputDb;
-    if (inputDb > threshold)    // Ӱ谪 ʰϴ 츸 
-    {
-        float excess = inputDb - threshold;         // ʰ 
-        compressedDb = threshold + excess / ratio;  //  
-    }
+    if (! autocomp::state::isChunk(data, size))
+        return false;
 
-    //   
-    float gainReductionDb = compressedDb - inputDb;
-    float targetGain = dbToLinear(gainReductionDb);
+    autocomp::state::ParameterValue values[autocomp::state::maxParameters];
+    const auto numValues = autocomp::state::read(data, size, values, autocomp::state::maxParameters);
 
-    //  ȷο (ε巯  ȭ  1 )
-    if (targetGain < envelope)      //  ( )
-        envelope = targetGain + (envelope - targetGain) * attackCoeff;
-    else                            //  ( )
-        envelope = targetGain + (envelope - targetGain) * releaseCoeff;
+    // 손상됐거나 더 새 버전의 청크: 현재 상태 유지
+    if (numValues < 0)
+        return true;
 
-    // ũ  
-    float makeupLinear = dbToLinear(makeupGain);
+    // 모르는 ID는 건너뛰고, 청크에 없는 파라미터는 그대로 둠
+    for (const auto& [id, param] : stateParameters)
+        for (int i = 0; i < numValues; ++i)
+            if (values[i].id == id)
+                param->setValueNotifyingHost(param->convertTo0to1(values[i].value));
 
-    //   = Է *  * ũ 
-    return inputSample * envelope * makeupLinear;
+    // 사용자 프로그램 뱅크 (없으면 기본 뱅크 유지)
+    const auto chunkSize = autocomp::state::getChunkSize(data, size);
+    programs.read(static_cast<const char*>(data) + chunkSize, size - chunkSize);
+    return true;
 }
 
-//    ȯ
-bool AutoCompressorAudioProcessor::hasEditor() const
+// 수동 컴프레션 레벨 설정 (0-4단계)
+void AutoCompressorAudioProcessor::setCompressionLevel(int level)
 {
-    return true;
+    // 레벨 파라미터 변경 (호스트에 알림, 오디오 스레드는 블록마다 읽음)
+    if (auto* param = parameters.getParameter("level"))
+        param->setValueNotifyingHost(param->convertTo0to1(static_cast<float>(level + 1)));
 }
 
-//  
-juce::AudioProcessorEditor* AutoCompressorAudioProcessor::createEditor()
+// 오디오 스레드에서 사용 중인 설정 반환 (수동/자동 모두, 메시지 스레드용)
+autocomp::CompressorSettings AutoCompressorAudioProcessor::getActiveSettings()
 {
-    return new NewProjectAudioProcessorEditor(*this);
+    return engine.getActiveSettings();
 }
 
-// ÷  
-void AutoCompressorAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
+// 입력 라우드니스 (모멘터리/숏텀/인티그레이티드, 에디터 스레드 전용)
+autocomp::LoudnessReading AutoCompressorAudioProcessor::getLoudness()
 {
-    auto state = parameters.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    return engine.getLoudness();
 }
 
-// ÷  
-void AutoCompressorAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
+// 인티그레이티드 라우드니스 측정 재시작
+void AutoCompressorAudioProcessor::resetIntegratedLoudness()
 {
-    std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
-
-    if (xmlState.get() != nullptr)
-        if (xmlState->hasTagName(parameters.state.getType()))
-            parameters.replaceState(juce::ValueTree::fromXml(*xmlState));
+    engine.resetIntegratedLoudness();
 }
 
-//     (0-4ܰ)
-void AutoCompressorAudioProcessor::setCompressionLevel(int level)
+// 입출력 피크/RMS와 게인 리덕션 (지난 읽기 이후, 에디터 타이머 전용)
+autocomp::LevelReading AutoCompressorAudioProcessor::getLevels()
 {
-    switch (level)
-    {
-    case 0: // 1ܰ - ſ ε巯 
-        threshold = -30.0f;
-        ratio = 1.5f;
-        attack = 30.0f;
-        release = 200.0f;
-        makeupGain = 1.0f;
-        break;
-
-    case 1: // 2ܰ - ε巯 
-        threshold = -25.0f;
-        ratio = 2.5f;
-        attack = 20.0f;
-        release = 150.0f;
-        makeupGain = 2.0f;
-        break;
-
-    case 2: // 3ܰ -   (⺻)
-        threshold = -20.0f;
-        ratio = 4.0f;
-        attack = 10.0f;
-        release = 100.0f;
-        makeupGain = 3.0f;
-        break;
-
-    case 3: // 4ܰ -  
-        threshold = -15.0f;
-        ratio = 6.0f;
-        attack = 5.0f;
-        release = 80.0f;
-        makeupGain = 4.0f;
-        break;
-
-    case 4: // 5ܰ - ſ  
-        threshold = -10.0f;
-        ratio = 8.0f;
-        attack = 2.0f;
-        release = 50.0f;
-        makeupGain = 5.0f;
-        break;
-    }
+    return engine.readLevels();
+}
 
-    // ο   Ʈ
-    updateCompressorCoefficients();
+// 에디터가 보일 때만 오디오 스레드에서 레벨 측정 (꺼져 있으면 추가 작업 없음)
+void AutoCompressorAudioProcessor::setMeteringEnabled(bool enabled)
+{
+    engine.setMetering(enabled);
 }
 
-// ÷ νϽ  Լ
+// 플러그인 인스턴스 생성 함수
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 {
     return new AutoCompressorAudioProcessor();
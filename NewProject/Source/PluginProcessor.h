@@ -1,7 +1,12 @@
 #pragma once
 #include <JuceHeader.h>
+#include "DSP/AnalysisWorker.h"
+#include "DSP/CompressorEngine.h"
+#include "DSP/ProgramBank.h"
+#include "DSP/StateChunk.h"
 
-class AutoCompressorAudioProcessor : public juce::AudioProcessor
+class AutoCompressorAudioProcessor : public juce::AudioProcessor,
+                                     private juce::AsyncUpdater
 {
 public:
     AutoCompressorAudioProcessor();
@@ -15,6 +20,10 @@ public:
 #endif
 
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock(juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    void processBlockBypassed(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlockBypassed(juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override;
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override;
     const juce::String getName() const override;
@@ -24,58 +33,83 @@ public:
     double getTailLengthSeconds() const override;
     int getNumPrograms() override;
     int getCurrentProgram() override;
-    void setCurrentProgram(int index) override;
+    void setCurrentProgram(int index) override;   // 메시지 스레드 전용
     const juce::String getProgramName(int index) override;
     void changeProgramName(int index, const juce::String& newName) override;
     void getStateInformation(juce::MemoryBlock& destData) override;
     void setStateInformation(const void* data, int sizeInBytes) override;
 
-    // UI ȣ  ִ public Լ
+    // UI에서 호출할 수 있는 public 함수들
     void setAutoCompressionEnabled(bool enabled);
     bool isAutoCompressionEnabled() const;
-    void setCompressionLevel(int level); //  Լ ߰!
+    void setCompressionLevel(int level); // 이 함수 추가!
+    bool storeUserProgram(int index);   // 지금 쓰는 설정을 사용자 프로그램에 저장
+    std::uint32_t getProgramChangeCount() const;   // 프로그램 저장/이름 변경/불러오기마다 증가 (에디터 목록 갱신용)
+    autocomp::CompressorSettings getActiveSettings();
+    autocomp::LoudnessReading getLoudness();   // 에디터 전용 (락 없음)
+    void resetIntegratedLoudness();
+    autocomp::LevelReading getLevels();        // 에디터 타이머 전용 (락 없음)
+    void setMeteringEnabled(bool enabled);
 
-    // Ķ 
+    // 파라미터 관리
     juce::AudioProcessorValueTreeState parameters;
 
 private:
-    //   
+    // 동작 모드 ("mode" 파라미터 인덱스)
+    enum Mode { autoMode = 0, levelMode, customMode };
+
+    // 채널 링크 ("linkMode" 파라미터 인덱스)
+    enum LinkMode { linkedMode = 0, unlinkedMode, surroundMode };
+
+    static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+    autocomp::CompressorSettings getCustomSettings() const;
+    void handleAsyncUpdate() override;
+    bool updateLatencyParameters();
+
+    // float/double processBlock 공통 경로 (엔진도 같은 템플릿 코드)
+    template <typename SampleType>
+    void process(juce::AudioBuffer<SampleType>& buffer, bool hostBypassed);
+    void prepareSurroundLink();
+    bool restoreStateChunk(const void* data, int sizeInBytes);
+
+    // 컴프레서 관련 변수들
     std::atomic<float>* autoCompressEnabled;
+    std::atomic<float>* modeParameter;
+    std::atomic<float>* lookaheadParameter;
+    std::atomic<float>* oversamplingParameter;
+    std::atomic<float>* bandsParameter;
+    std::atomic<float>* sidechainParameter;
+    std::atomic<float>* detectorHighPassParameter;
+    std::atomic<float>* linkModeParameter;
+    std::atomic<float>* targetLoudnessParameter;
+    std::atomic<float>* levelParameter;
+    std::atomic<float>* thresholdParameter;
+    std::atomic<float>* ratioParameter;
+    std::atomic<float>* attackParameter;
+    std::atomic<float>* releaseParameter;
+    std::atomic<float>* makeupParameter;
+
+    // 프로그램이 바꾸는 파라미터 (threshold, ratio, attack, release, makeup 순서)
+    std::array<juce::RangedAudioParameter*, 5> programParameters {};
+    juce::RangedAudioParameter* modeChoice = nullptr;
+
+    // 팩토리 프로그램 (레벨 1-5) + 사용자 프로그램, 고정 크기 (선택 시 할당 없음)
+    autocomp::ProgramBank programs;
+
+    // 상태 저장용 (파라미터 ID 해시, 파라미터) - 생성자에서 한 번 만듦
+    std::vector<std::pair<std::uint32_t, juce::RangedAudioParameter*>> stateParameters;
+
+    // 컴프레서 DSP 코어 (JUCE 비의존, 헤드리스 빌드/테스트 가능)
+    autocomp::CompressorEngine engine;
+
+    // 서라운드 링크 그룹 (메인 버스 레이아웃에서 prepareToPlay 때 생성)
+    autocomp::LinkGroups surroundGroups;
 
-    //   
-    float currentRMS = 0.0f;
-    float rmsSmoothing = 0.99f;
-
-    //  Ķ͵
-    float threshold = -20.0f;
-    float ratio = 4.0f;
-    float attack = 10.0f;
-    float release = 100.0f;
-    float makeupGain = 0.0f;
-
-    //   
-    float envelope = 0.0f;
-    float attackCoeff = 0.0f;
-    float releaseCoeff = 0.0f;
-
-    double sampleRate = 44100.0;
-
-    // ڵ м 
-    static const int analysisBufferSize = 4096;
-    juce::AudioBuffer<float> analysisBuffer;
-    int analysisBufferIndex = 0;
-    bool needsAnalysis = true;
-
-    // ƿƼ Լ
-    void updateCompressorCoefficients();
-    void analyzeAudioLevel(const juce::AudioBuffer<float>& buffer);
-    void calculateAutoParameters();
-    float applyCompression(float inputSample);
-    float dbToLinear(float db) { return std::pow(10.0f, db / 20.0f); }
-    float linearToDb(float linear) { return 20.0f * std::log10(std::max(linear, 1e-6f)); }
+    // 오토 모드 분석 스레드 (FFT/크레스트/틸트), 엔진보다 먼저 소멸
+    autocomp::AnalysisWorker analysisWorker { engine };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AutoCompressorAudioProcessor)
 };
 
-// Editor ȣȯ  typedef
+// Editor와의 호환성을 위한 typedef
 using NewProjectAudioProcessor = AutoCompressorAudioProcessor;
\ No newline at end of file
@@ -0,0 +1,125 @@
+/*
+  ==============================================================================
+
+    AudioFifoTests.cpp
+
+  ==============================================================================
+*/
+
+#include "TestHarness.h"
+#include "../Source/DSP/AudioFifo.h"
+
+#include <thread>
+#include <vector>
+
+using autocomp::AudioFifo;
+
+TEST_CASE("Capacity rounds up to a power of two")
+{
+    AudioFifo fifo;
+    fifo.prepare(2, 1000);
+    CHECK(fifo.getCapacity() == 1024);
+    CHECK(fifo.getNumChannels() == 2);
+    CHECK(fifo.getNumReady() == 0);
+}
+
+TEST_CASE("Frames come out in order across the wrap")
+{
+    AudioFifo fifo;
+    fifo.prepare(2, 64);
+
+    std::vector<float> left(48), right(48), outLeft(48), outRight(48);
+    const float* source[] = { left.data(), right.data() };
+    float* dest[] = { outLeft.data(), outRight.data() };
+    float next = 0.0f, expected = 0.0f;
+
+    for (int round = 0; round < 10; ++round)
+    {
+        for (size_t i = 0; i < left.size(); ++i)
+        {
+            left[i] = next;
+            right[i] = -next;
+            next += 1.0f;
+        }
+
+        CHECK(fifo.push(source, 2, 48) == 48);
+        CHECK(fifo.getNumReady() == 48);
+        CHECK(fifo.pop(dest, 2, 48) == 48);
+
+        for (size_t i = 0; i < outLeft.size(); ++i)
+        {
+            CHECK(outLeft[i] == expected);
+            CHECK(outRight[i] == -expected);
+            expected += 1.0f;
+        }
+    }
+}
+
+TEST_CASE("Push stops when full and missing channels are silent")
+{
+    AudioFifo fifo;
+    fifo.prepare(2, 16);
+
+    std::vector<float> ones(20, 1.0f), outLeft(20, -1.0f), outRight(20, -1.0f);
+    const float* source[] = { ones.data() };
+    float* dest[] = { outLeft.data(), outRight.data() };
+
+    CHECK(fifo.push(source, 1, 20) == 16);
+    CHECK(fifo.push(source, 1, 1) == 0);
+    CHECK(fifo.pop(dest, 2, 20) == 16);
+    CHECK(outLeft[15] == 1.0f && outRight[15] == 0.0f);
+    CHECK(outLeft[16] == -1.0f);
+}
+
+TEST_CASE("Concurrent producer and consumer keep every frame in order")
+{
+    AudioFifo fifo;
+    fifo.prepare(1, 256);
+
+    constexpr int totalFrames = 500000;
+    bool ordered = true;
+
+    std::thread consumer([&]
+    {
+        std::vector<float> block(100);
+        float* dest[] = { block.data() };
+        int received = 0;
+
+        while (received < totalFrames)
+        {
+            const auto count = fifo.pop(dest, 1, 100);
+
+            for (int i = 0; i < count; ++i)
+                ordered = ordered && block[(size_t) i] == (float) ((received + i) % 1000000);
+
+            received += count;
+
+            if (count == 0)
+                std::this_thread::yield();
+        }
+    });
+
+    std::vector<float> block(77);
+    const float* source[] = { block.data() };
+
+    for (int sent = 0; sent < totalFrames;)
+    {
+        const auto count = std::min(77, totalFrames - sent);
+
+        for (int i = 0; i < count; ++i)
+            block[(size_t) i] = (float) ((sent + i) % 1000000);
+
+        const auto written = fifo.push(source, 1, count);
+        sent += written;
+
+        // Unwritten frames are re-sent with the same values next time
+        if (written < count)
+            std::this_thread::yield();
+    }
+
+    consumer.join();
+    CHECK(ordered);
+    CHECK(fifo.getNumReady() == 0);
+}
+
+TEST_MAIN()
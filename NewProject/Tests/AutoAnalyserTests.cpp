@@ -0,0 +1,184 @@
+/*
+  ==============================================================================
+
+    AutoAnalyserTests.cpp
+
+  ==============================================================================
+*/
+
+#include "TestHarness.h"
+#include "../Source/DSP/AnalysisWorker.h"
+#include "../Source/DSP/AutoAnalyser.h"
+#include "../Source/DSP/CompressorEngine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+
+using autocomp::AutoAnalyser;
+using autocomp::CompressorEngine;
+
+namespace
+{
+    const autocomp::AutoAnalysis& analyse(AutoAnalyser& analyser, const std::vector<float>& signal)
+    {
+        const float* channels[] = { signal.data() };
+        analyser.process(channels, 1, (int) signal.size());
+        return analyser.getResult();
+    }
+
+    std::vector<float> whiteNoise(int length, float amplitude, unsigned seed)
+    {
+        std::mt19937 random(seed);
+        std::uniform_real_distribution<float> distribution(-amplitude, amplitude);
+        std::vector<float> noise((size_t) length);
+
+        for (auto& value : noise)
+            value = distribution(random);
+
+        return noise;
+    }
+}
+
+TEST_CASE("Results arrive once per analysis block")
+{
+    AutoAnalyser analyser;
+    analyser.prepare(48000.0, 1);
+
+    std::vector<float> block(1000, 0.1f);
+    const float* channels[] = { block.data() };
+    int completed = 0;
+
+    for (int i = 0; i < 41; ++i)
+        completed += analyser.process(channels, 1, 1000) ? 1 : 0;
+
+    CHECK(completed == 41000 / AutoAnalyser::blockSize);
+}
+
+TEST_CASE("Crest factor of a sine and of a steady level")
+{
+    AutoAnalyser analyser;
+    analyser.prepare(48000.0, 1);
+
+    std::vector<float> sine(48000);
+
+    for (size_t i = 0; i < sine.size(); ++i)
+        sine[i] = 0.5f * std::sin(2.0f * 3.14159265f * 1000.0f * (float) i / 48000.0f);
+
+    CHECK_NEAR(analyse(analyser, sine).crestDb, 3.01f, 0.05);
+    CHECK_NEAR(analyser.getResult().rms, 0.5f / std::sqrt(2.0f), 1e-3);
+
+    analyser.reset();
+    CHECK_NEAR(analyse(analyser, std::vector<float>(48000, 0.25f)).crestDb, 0.0f, 1e-3);
+}
+
+TEST_CASE("Spectral tilt of white and brown noise")
+{
+    AutoAnalyser analyser;
+    analyser.prepare(48000.0, 1);
+
+    const auto white = whiteNoise(48000, 0.5f, 3);
+    CHECK_NEAR(analyse(analyser, white).tiltDbPerOctave, 0.0f, 1.5);
+
+    // Leaky integrator: -6 dB per octave above a few Hz
+    auto brown = whiteNoise(48000, 0.05f, 4);
+    float state = 0.0f;
+
+    for (auto& value : brown)
+        value = state = 0.999f * state + value;
+
+    analyser.reset();
+    CHECK_NEAR(analyse(analyser, brown).tiltDbPerOctave, -6.0f, 1.5);
+}
+
+TEST_CASE("Settings adapt to peaky and bass-heavy material")
+{
+    const auto& tier = autocomp::presets::autoTiers[2].settings;
+
+    CHECK(AutoAnalyser::adaptToProgram(tier, 6.0f, -3.0f) == tier);
+
+    const auto peaky = AutoAnalyser::adaptToProgram(tier, 18.0f, 0.0f);
+    CHECK_NEAR(peaky.attack, tier.attack * 1.5f, 1e-5);
+    CHECK_NEAR(peaky.release, tier.release, 0.0);
+
+    const auto heavy = AutoAnalyser::adaptToProgram(tier, 0.0f, -30.0f);
+    CHECK_NEAR(heavy.release, tier.release * 2.0f, 1e-5);
+    CHECK_NEAR(heavy.attack, tier.attack, 0.0);
+}
+
+TEST_CASE("Tier follows the short-term loudness and makeup the target")
+{
+    AutoAnalyser analyser;
+    analyser.prepare(48000.0, 1);
+
+    std::vector<float> tone(48000 * 4);
+
+    // 1 kHz at -20 dBFS in one channel: -23 LUFS
+    for (size_t i = 0; i < tone.size(); ++i)
+        tone[i] = 0.1f * std::sin(6.2831853f * 1000.0f * (float) i / 48000.0f);
+
+    const auto& result = analyse(analyser, tone);
+    CHECK_NEAR(result.loudness.shortTerm, -23.0f, 0.2);
+    CHECK(result.tier == autocomp::presets::findAutoTier(-23.0f));
+    CHECK(result.settings == autocomp::presets::autoTiers[(size_t) result.tier].settings);
+
+    analyser.reset();
+    analyser.setLoudnessTarget(-14.0f);
+    const auto& targeted = analyse(analyser, tone);
+    const auto expected = AutoAnalyser::makeupForTarget(targeted.settings, targeted.loudness.shortTerm, -14.0f);
+    CHECK_NEAR(targeted.settings.makeupGain, expected, 0.0);
+
+    // -23 LUFS against a -20 dB, 4:1 curve: 2.25 dB predicted reduction
+    const auto& tier = autocomp::presets::autoTiers[2].settings;
+    CHECK_NEAR(AutoAnalyser::makeupForTarget(tier, -23.0f, -14.0f), 9.0f, 1e-5);
+    CHECK_NEAR(AutoAnalyser::makeupForTarget(tier, -23.0f, -40.0f), 0.0f, 0.0);
+}
+
+TEST_CASE("Background worker re-tiers the engine off the audio thread")
+{
+    CompressorEngine engine;
+    engine.prepare(44100.0, 512, 2);
+
+    autocomp::AnalysisWorker worker(engine);
+    worker.start();
+    CHECK(engine.isBackgroundAnalysis());
+
+    std::vector<float> left(512), right(512);
+    float* channels[] = { left.data(), right.data() };
+
+    // 1 kHz at 0.8 peak in both channels: about -2 LUFS
+    double phase = 0.0;
+
+    auto processLoudBlock = [&]
+    {
+        for (size_t i = 0; i < left.size(); ++i)
+        {
+            left[i] = right[i] = 0.8f * (float) std::sin(phase);
+            phase += 6.283185307179586 * 1000.0 / 44100.0;
+        }
+
+        engine.processBlock(channels, 2, 512);
+    };
+
+    // Nothing analysed yet: tier 0 from prepare()
+    processLoudBlock();
+    CHECK(engine.getAutoTier() == 0);
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+
+    while (engine.getAutoTier() != autocomp::CompressorEngine::numAutoTiers - 1
+           && std::chrono::steady_clock::now() < deadline)
+    {
+        processLoudBlock();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    CHECK(engine.getAutoTier() == autocomp::CompressorEngine::numAutoTiers - 1);
+
+    worker.stop();
+    CHECK(! engine.isBackgroundAnalysis());
+}
+
+TEST_MAIN()
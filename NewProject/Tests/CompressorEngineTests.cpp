@@ -0,0 +1,1280 @@
+/*
+  ==============================================================================
+
+    CompressorEngineTests.cpp
+
+  ==============================================================================
+*/
+
+#include "TestHarness.h"
+#include "../Source/DSP/CompressorEngine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using autocomp::CompressorEngine;
+using autocomp::CompressorSettings;
+using autocomp::LinkGroups;
+using autocomp::StereoLink;
+
+namespace
+{
+    // Runs a constant (DC) level through the engine until the envelope settles
+    float settledGainDb(CompressorEngine& engine, float level, int numSamples)
+    {
+        auto output = 0.0f;
+
+        for (int i = 0; i < numSamples; ++i)
+            output = engine.applyCompression(level);
+
+        return CompressorEngine::linearToDb(output / level);
+    }
+}
+
+TEST_CASE("dB conversions round-trip")
+{
+    CHECK_NEAR(CompressorEngine::dbToLinear(0.0f), 1.0f, 1e-6);
+    CHECK_NEAR(CompressorEngine::dbToLinear(-20.0f), 0.1f, 1e-6);
+    CHECK_NEAR(CompressorEngine::linearToDb(0.5f), -6.0206f, 1e-3);
+    CHECK_NEAR(CompressorEngine::linearToDb(0.0f), -120.0f, 1e-3);
+
+    for (float db = -100.0f; db <= 20.0f; db += 5.0f)
+        CHECK_NEAR(CompressorEngine::linearToDb(CompressorEngine::dbToLinear(db)), db, 1e-3);
+}
+
+TEST_CASE("Static curve above threshold")
+{
+    CompressorEngine engine;
+    engine.prepare(48000.0, 512, 2);
+    engine.setSettings({ -20.0f, 4.0f, 1.0f, 10.0f, 0.0f });
+
+    // -6.02 dB in, 13.98 dB over the threshold at 4:1 -> 10.49 dB reduction
+    CHECK_NEAR(settledGainDb(engine, 0.5f, 48000), -10.485f, 0.01);
+}
+
+TEST_CASE("Below threshold only makeup is applied")
+{
+    CompressorEngine engine;
+    engine.prepare(48000.0, 512, 2);
+    engine.setSettings({ -20.0f, 4.0f, 1.0f, 10.0f, 3.0f });
+
+    CHECK_NEAR(settledGainDb(engine, 0.01f, 48000), 3.0f, 0.01);
+}
+
+TEST_CASE("Attack is faster than release")
+{
+    CompressorEngine engine;
+    engine.prepare(48000.0, 512, 2);
+    engine.setSettings({ -20.0f, 8.0f, 1.0f, 200.0f, 0.0f });
+
+    settledGainDb(engine, 0.01f, 48000);
+    const auto unity = engine.getEnvelope();
+
+    // 5 ms of a loud signal moves the envelope most of the way down
+    settledGainDb(engine, 1.0f, 240);
+    const auto attacked = engine.getEnvelope();
+    CHECK(attacked < 0.2f);
+
+    // 5 ms of quiet afterwards barely recovers
+    settledGainDb(engine, 0.01f, 240);
+    CHECK(engine.getEnvelope() < 0.5f * (unity + attacked));
+}
+
+TEST_CASE("Compression levels map to presets")
+{
+    CompressorEngine engine;
+    engine.prepare(44100.0, 512, 2);
+
+    engine.setCompressionLevel(0);
+    CHECK_NEAR(engine.getSettings().ratio, 1.5f, 1e-6);
+    CHECK_NEAR(engine.getSettings().threshold, -30.0f, 1e-6);
+
+    engine.setCompressionLevel(4);
+    CHECK_NEAR(engine.getSettings().ratio, 8.0f, 1e-6);
+    CHECK_NEAR(engine.getSettings().attack, 2.0f, 1e-6);
+
+    // Out of range leaves the settings untouched
+    engine.setCompressionLevel(7);
+    CHECK_NEAR(engine.getSettings().ratio, 8.0f, 1e-6);
+}
+
+TEST_CASE("Preset tables give the same result as deriving on the fly")
+{
+    for (int level = 0; level < CompressorEngine::numCompressionLevels; ++level)
+    {
+        CompressorEngine fromTable, derived;
+        fromTable.prepare(88200.0, 256, 1);
+        derived.prepare(88200.0, 256, 1);
+
+        fromTable.setCompressionLevel(level);
+        derived.setSettings(autocomp::presets::compressionLevels[(size_t) level]);
+        CHECK(fromTable.getSettings() == derived.getSettings());
+
+        for (int i = 0; i < 2000; ++i)
+        {
+            const auto x = 0.9f * std::sin(0.02f * (float) i);
+            CHECK_NEAR(fromTable.applyCompression(x), derived.applyCompression(x), 0.0);
+        }
+    }
+}
+
+TEST_CASE("Auto parameters follow the measured loudness")
+{
+    constexpr int blockSize = 512;
+    std::vector<float> left(blockSize), right(blockSize);
+    float* channels[] = { left.data(), right.data() };
+
+    // Stereo 1 kHz sine: loudness in LUFS is about 20 * log10(level)
+    auto runAt = [&](float level)
+    {
+        CompressorEngine engine;
+        engine.prepare(44100.0, blockSize, 2);
+        double phase = 0.0;
+
+        for (int block = 0; block < 2000; ++block)
+        {
+            for (int i = 0; i < blockSize; ++i)
+            {
+                left[(size_t) i] = level * (float) std::sin(phase);
+                right[(size_t) i] = -left[(size_t) i];
+                phase += 6.283185307179586 * 1000.0 / 44100.0;
+            }
+
+            engine.processBlock(channels, 2, blockSize);
+        }
+
+        CHECK(engine.getSettings() == autocomp::presets::autoTiers[(size_t) engine.getAutoTier()].settings);
+        return engine.getSettings();
+    };
+
+    CHECK_NEAR(runAt(0.0001f).threshold, -40.0f, 1e-6); // -80 dB
+    CHECK_NEAR(runAt(0.005f).threshold, -30.0f, 1e-6);  // -46 dB
+    CHECK_NEAR(runAt(0.05f).threshold, -20.0f, 1e-6);   // -26 dB
+    CHECK_NEAR(runAt(0.2f).threshold, -15.0f, 1e-6);    // -14 dB
+    CHECK_NEAR(runAt(0.8f).threshold, -10.0f, 1e-6);    // -2 dB
+}
+
+TEST_CASE("Analysis is flagged when the analysis buffer wraps")
+{
+    CompressorEngine engine;
+    engine.prepare(44100.0, 1024, 2);
+    CHECK(engine.isAnalysisDue());
+
+    std::vector<float> left(1024, 0.1f), right(1024, 0.1f);
+    float* channels[] = { left.data(), right.data() };
+
+    // First block consumes the pending analysis from prepare()
+    engine.processBlock(channels, 2, 1024);
+    CHECK(! engine.isAnalysisDue());
+
+    // The buffer wraps after 4096 frames, whatever the channel count
+    engine.analyzeAudioLevel(channels, 2, 1024);
+    engine.analyzeAudioLevel(channels, 2, 1024);
+    CHECK(! engine.isAnalysisDue());
+
+    engine.analyzeAudioLevel(channels, 2, 1024);
+    CHECK(engine.isAnalysisDue());
+}
+
+TEST_CASE("Measured RMS does not depend on the host block size")
+{
+    constexpr int totalSamples = 48000;
+    std::vector<float> input(totalSamples);
+
+    for (int i = 0; i < totalSamples; ++i)
+        input[(size_t) i] = (i < 30000 ? 0.5f : 0.05f) * std::sin(0.05f * (float) i);
+
+    auto rmsAfter = [&](int blockSize)
+    {
+        CompressorEngine engine;
+        engine.prepare(48000.0, blockSize, 1);
+
+        for (int offset = 0; offset < totalSamples; offset += blockSize)
+        {
+            const float* block[] = { input.data() + offset };
+            engine.analyzeAudioLevel(block, 1, std::min(blockSize, totalSamples - offset));
+        }
+
+        return engine.getCurrentRms();
+    };
+
+    const auto reference = rmsAfter(64);
+    CHECK(reference > 0.02f && reference < 0.06f); // only the quiet part is in the window
+
+    for (int blockSize : { 31, 256, 1000, 4096 })
+        CHECK_NEAR(rmsAfter(blockSize), reference, 1e-5);
+}
+
+TEST_CASE("Analysis ignores prepared channels that carry no audio")
+{
+    // Prepared for a main bus plus a stereo sidechain, fed the main bus only
+    auto analyse = [](int numPreparedChannels)
+    {
+        CompressorEngine engine;
+        engine.prepare(48000.0, 512, numPreparedChannels);
+
+        std::vector<float> left(512), right(512);
+        const float* channels[] = { left.data(), right.data() };
+
+        for (int block = 0; block < 40; ++block)
+        {
+            for (int i = 0; i < 512; ++i)
+            {
+                const auto phase = 0.07f * (float) (block * 512 + i);
+                left[(size_t) i] = 0.5f * std::sin(phase) * (i % 128 == 0 ? 1.0f : 0.2f);
+                right[(size_t) i] = 0.3f * std::sin(1.3f * phase);
+            }
+
+            engine.analyzeAudioLevel(channels, 2, 512);
+        }
+
+        return engine.getLatestAnalysis();
+    };
+
+    const auto expected = analyse(2);
+    const auto widened = analyse(4);
+
+    CHECK(expected.rms > 0.0f);
+    CHECK_NEAR(widened.rms, expected.rms, 1e-6);
+    CHECK_NEAR(widened.crestDb, expected.crestDb, 1e-4);
+    CHECK_NEAR(widened.loudness.momentary, expected.loudness.momentary, 1e-4);
+    CHECK_NEAR(widened.loudness.shortTerm, expected.loudness.shortTerm, 1e-4);
+    CHECK(widened.tier == expected.tier);
+}
+
+TEST_CASE("Block compression matches the single-sample path")
+{
+    CompressorEngine blockEngine, sampleEngine;
+
+    for (auto* engine : { &blockEngine, &sampleEngine })
+    {
+        engine->prepare(48000.0, 1000, 1);
+        engine->setSettings({ -24.0f, 5.0f, 3.0f, 60.0f, 2.0f });
+    }
+
+    std::vector<float> block(1000), reference(1000);
+
+    for (int i = 0; i < 1000; ++i)
+        block[i] = reference[i] = 0.9f * std::sin(0.05f * (float) i) * (i < 500 ? 1.0f : 0.05f);
+
+    float* channels[] = { block.data() };
+    blockEngine.compress(channels, 1, 1000);
+
+    for (auto& sample : reference)
+        sample = sampleEngine.applyCompression(sample);
+
+    for (int i = 0; i < 1000; ++i)
+        CHECK_NEAR(block[i], reference[i], 1e-6);
+}
+
+TEST_CASE("Linked detector applies identical gain to every channel")
+{
+    CompressorEngine engine;
+    engine.prepare(48000.0, 512, 2);
+    engine.setSettings({ -20.0f, 4.0f, 1.0f, 50.0f, 0.0f });
+
+    // Loud left, quiet right: the right channel must be ducked just as much
+    std::vector<float> left(512, 0.8f), right(512, 0.01f);
+    float* channels[] = { left.data(), right.data() };
+    engine.compress(channels, 2, 512);
+
+    for (int i = 0; i < 512; ++i)
+        CHECK_NEAR(left[i] / 0.8f, right[i] / 0.01f, 1e-5);
+}
+
+TEST_CASE("Channels do not inherit each other's envelope")
+{
+    // Same stereo input processed twice from a fresh state must give the
+    // same right channel whatever the left channel did before it.
+    auto processRight = [](float leftLevel)
+    {
+        CompressorEngine engine;
+        engine.prepare(48000.0, 256, 2);
+        engine.setStereoLink(StereoLink::unlinked);
+        engine.setSettings({ -20.0f, 4.0f, 1.0f, 50.0f, 0.0f });
+
+        std::vector<float> left(256, leftLevel), right(256, 0.5f);
+        float* channels[] = { left.data(), right.data() };
+        engine.compress(channels, 2, 256);
+        return right;
+    };
+
+    const auto withQuietLeft = processRight(0.0f);
+    const auto withLoudLeft = processRight(1.0f);
+
+    for (int i = 0; i < 256; ++i)
+        CHECK_NEAR(withQuietLeft[i], withLoudLeft[i], 0.0);
+}
+
+TEST_CASE("Unlinked detector keeps independent envelopes")
+{
+    CompressorEngine engine;
+    engine.prepare(48000.0, 4800, 2);
+    engine.setStereoLink(StereoLink::unlinked);
+    engine.setSettings({ -20.0f, 4.0f, 1.0f, 50.0f, 0.0f });
+
+    std::vector<float> left(4800, 0.8f), right(4800, 0.01f);
+    float* channels[] = { left.data(), right.data() };
+    engine.compress(channels, 2, 4800);
+
+    CHECK(engine.getEnvelope(0) < 0.5f);
+    CHECK(engine.getEnvelope(1) > 0.95f);
+}
+
+TEST_CASE("Link groups share gain within a group and leave excluded channels alone")
+{
+    // 5.1: L R C linked, LFE excluded, Ls Rs linked
+    constexpr int layout[] = { 0, 0, 0, LinkGroups::excluded, 1, 1 };
+    constexpr float levels[] = { 0.8f, 0.05f, 0.1f, 0.9f, 0.02f, 0.03f };
+
+    for (int numBands : { 1, 3 })
+    {
+        CompressorEngine engine;
+        engine.prepare(48000.0, 512, 6);
+        engine.setNumBands(numBands);
+        engine.setSettings({ -20.0f, 4.0f, 1.0f, 50.0f, 0.0f });
+
+        LinkGroups groups;
+        groups.assign(layout, 6);
+        engine.setLinkGroups(groups);
+        CHECK(engine.getStereoLink() == StereoLink::grouped);
+        CHECK(groups.getNumGroups() == 2);
+
+        std::vector<std::vector<float>> data;
+        float* channels[6];
+
+        for (int channel = 0; channel < 6; ++channel)
+            data.emplace_back(512, levels[channel]);
+
+        for (int channel = 0; channel < 6; ++channel)
+            channels[channel] = data[static_cast<size_t>(channel)].data();
+
+        engine.compress(channels, 6, 512);
+
+        // The loud left channel pulls the whole front down by the same gain
+        CHECK(data[0][511] < 0.5f * levels[0]);
+
+        for (int channel : { 1, 2 })
+            CHECK_NEAR(data[static_cast<size_t>(channel)][511] / levels[channel], data[0][511] / levels[0], 1e-4);
+
+        // The quiet surrounds are not touched by the front, nor the LFE at all
+        for (int channel : { 4, 5 })
+            CHECK_NEAR(data[static_cast<size_t>(channel)][511], levels[channel], 1e-4);
+
+        for (int i = 0; i < 512; ++i)
+            CHECK_NEAR(data[3][static_cast<size_t>(i)], levels[3], 0.0);
+    }
+}
+
+TEST_CASE("Linked and unlinked are the two trivial link groups")
+{
+    CompressorEngine engine;
+    engine.prepare(48000.0, 256, 12);
+
+    engine.setStereoLink(StereoLink::unlinked);
+    CHECK(engine.getLinkGroups() == LinkGroups::unlinked());
+    CHECK(engine.getLinkGroups().getNumGroups() == 16);
+
+    engine.setStereoLink(StereoLink::linked);
+    CHECK(engine.getStereoLink() == StereoLink::linked);
+    CHECK(engine.getLinkGroups().getNumGroups() == 1);
+
+    // A 7.1.4 bed linked: every channel gets the loudest channel's gain
+    std::vector<std::vector<float>> data;
+    float* channels[12];
+
+    for (int channel = 0; channel < 12; ++channel)
+        data.emplace_back(256, channel == 9 ? 0.8f : 0.1f);
+
+    for (int channel = 0; channel < 12; ++channel)
+        channels[channel] = data[static_cast<size_t>(channel)].data();
+
+    engine.setSettings({ -20.0f, 4.0f, 1.0f, 50.0f, 0.0f });
+    engine.compress(channels, 12, 256);
+
+    for (int channel = 0; channel < 12; ++channel)
+        CHECK_NEAR(data[static_cast<size_t>(channel)][255] / (channel == 9 ? 8.0f : 1.0f), data[0][255], 1e-5);
+
+    CHECK(data[0][255] < 0.09f);
+}
+
+TEST_CASE("Gain curve stage and apply stage match one-shot compression")
+{
+    CompressorEngine staged, oneShot;
+
+    for (auto* engine : { &staged, &oneShot })
+    {
+        engine->prepare(44100.0, 256, 2);
+        engine->setSettings({ -18.0f, 3.0f, 2.0f, 40.0f, 1.5f });
+    }
+
+    std::vector<float> left(1000), right(1000);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        left[i] = 0.7f * std::sin(0.01f * (float) i);
+        right[i] = 0.3f * std::cos(0.013f * (float) i);
+    }
+
+    auto expectedLeft = left, expectedRight = right;
+    float* expected[] = { expectedLeft.data(), expectedRight.data() };
+    oneShot.compress(expected, 2, 1000); // longer than the prepared block size
+
+    for (int offset = 0; offset < 1000; offset += 250)
+    {
+        float* slice[] = { left.data() + offset, right.data() + offset };
+        staged.computeGainCurve(slice, 2, 250);
+
+        // Linked: both channels read the same curve
+        CHECK(staged.getGainCurve(0) == staged.getGainCurve(1));
+
+        for (int i = 0; i < 250; ++i)
+        {
+            slice[0][i] *= staged.getGainCurve(0)[i];
+            slice[1][i] *= staged.getGainCurve(1)[i];
+        }
+    }
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        CHECK_NEAR(left[i], expectedLeft[i], 1e-6);
+        CHECK_NEAR(right[i], expectedRight[i], 1e-6);
+    }
+}
+
+TEST_CASE("Requested settings are picked up at the next block")
+{
+    CompressorEngine engine;
+    engine.prepare(44100.0, 512, 2);
+    engine.setCompressionLevel(2);
+
+    engine.requestCompressionLevel(4);
+    CHECK_NEAR(engine.getSettings().ratio, 4.0f, 0.0); // not yet
+
+    engine.beginBlock();
+    CHECK_NEAR(engine.getSettings().ratio, 8.0f, 0.0);
+    CHECK_NEAR(engine.getActiveSettings().ratio, 8.0f, 0.0);
+
+    // Invalid levels are ignored
+    engine.requestCompressionLevel(-1);
+    engine.beginBlock();
+    CHECK_NEAR(engine.getSettings().ratio, 8.0f, 0.0);
+}
+
+TEST_CASE("Auto-mode parameters are published to other threads")
+{
+    CompressorEngine engine;
+    engine.prepare(44100.0, 512, 2);
+
+    std::vector<float> left(512), right(512);
+    float* channels[] = { left.data(), right.data() };
+    double phase = 0.0;
+
+    // Loud 1 kHz tone, about -2 LUFS
+    for (int block = 0; block < 2000; ++block)
+    {
+        for (size_t i = 0; i < left.size(); ++i)
+        {
+            left[i] = right[i] = 0.8f * (float) std::sin(phase);
+            phase += 6.283185307179586 * 1000.0 / 44100.0;
+        }
+
+        engine.processBlock(channels, 2, 512);
+    }
+
+    CHECK_NEAR(engine.getActiveSettings().threshold, -10.0f, 0.0);
+    CHECK_NEAR(engine.getLoudness().shortTerm, -1.94f, 0.2);
+}
+
+TEST_CASE("Target settings glide without steps")
+{
+    CompressorEngine engine;
+    engine.prepare(48000.0, 480, 1);
+    engine.setSettings({ -20.0f, 4.0f, 1.0f, 10.0f, 0.0f });
+
+    // Quiet signal, so only the makeup gain moves: 0 -> 12 dB
+    std::vector<float> block(480, 0.01f);
+    float* channels[] = { block.data() };
+
+    engine.setTargetSettings({ -20.0f, 4.0f, 1.0f, 10.0f, 12.0f });
+
+    auto previousGain = 1.0f;
+    auto largestStep = 0.0f;
+
+    for (int b = 0; b < 4; ++b) // 40 ms, longer than the 20 ms glide
+    {
+        std::fill(block.begin(), block.end(), 0.01f);
+        engine.compress(channels, 1, 480);
+
+        for (auto sample : block)
+        {
+            largestStep = std::max(largestStep, std::abs(sample / 0.01f - previousGain));
+            previousGain = sample / 0.01f;
+        }
+    }
+
+    CHECK_NEAR(CompressorEngine::linearToDb(previousGain), 12.0f, 0.01);
+    CHECK(largestStep < 0.0035f); // (3.98 - 1) / 960 samples
+}
+
+TEST_CASE("Attack and release coefficients match exp()")
+{
+    for (float attack : { 0.5f, 2.0f, 10.0f, 30.0f })
+    {
+        for (float release : { 20.0f, 100.0f, 1000.0f })
+        {
+            CompressorEngine engine;
+            engine.prepare(96000.0, 64, 1);
+            engine.setSettings({ -24.0f, 4.0f, attack, release, 0.0f });
+
+            // 0 dB into a -24 dB threshold at 4:1 asks for -18 dB: one sample
+            // of attack moves the envelope by (1 - coeff) of the distance
+            engine.applyCompression(1.0f);
+            const auto target = CompressorEngine::dbToLinear(-24.0f * 0.75f);
+            const auto expectedCoeff = std::exp(-1.0 / (attack * 0.001 * 96000.0));
+            const auto actualCoeff = (engine.getEnvelope() - target) / (1.0f - target);
+
+            CHECK_NEAR(actualCoeff, expectedCoeff, 1e-5);
+        }
+    }
+}
+
+TEST_CASE("Lookahead delays the audio by the reported latency")
+{
+    CompressorEngine engine;
+    engine.prepare(48000.0, 100, 2);
+    engine.setSettings({ 0.0f, 1.0f, 1.0f, 10.0f, 0.0f }); // 1:1, unity gain
+
+    CHECK(engine.setLookahead(5.0f));
+    CHECK(! engine.setLookahead(5.0f));
+    CHECK(engine.getLatencySamples() == 240);
+
+    // Impulse, processed in uneven blocks across ring wrap-arounds
+    std::vector<float> left(1000, 0.0f), right(1000, 0.0f);
+    left[10] = 0.5f;
+    right[20] = -0.25f;
+
+    for (int offset = 0, size = 37; offset < 1000; offset += size)
+    {
+        const auto count = std::min(size, 1000 - offset);
+        float* slice[] = { left.data() + offset, right.data() + offset };
+        engine.compress(slice, 2, count);
+    }
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        CHECK_NEAR(left[(size_t) i], i == 250 ? 0.5f : 0.0f, 1e-6);
+        CHECK_NEAR(right[(size_t) i], i == 260 ? -0.25f : 0.0f, 1e-6);
+    }
+
+    // Clamped to the maximum
+    engine.setLookahead(50.0f);
+    CHECK(engine.getLatencySamples() == 480);
+}
+
+TEST_CASE("Lookahead reduces gain before the transient arrives")
+{
+    constexpr int length = 2000, onset = 1000;
+
+    auto firstLoudOutput = [](float lookaheadMs)
+    {
+        CompressorEngine engine;
+        engine.prepare(48000.0, length, 1);
+        engine.setSettings({ -20.0f, 10.0f, 0.5f, 100.0f, 0.0f });
+        engine.setLookahead(lookaheadMs);
+
+        std::vector<float> data(length, 0.01f);
+        std::fill(data.begin() + onset, data.end(), 1.0f);
+
+        float* channels[] = { data.data() };
+        engine.compress(channels, 1, length);
+
+        // Output sample where the step appears, after the latency
+        return data[(size_t) (onset + engine.getLatencySamples())];
+    };
+
+    // Without lookahead the step passes at full level before the attack
+    CHECK(firstLoudOutput(0.0f) > 0.9f);
+    CHECK(firstLoudOutput(5.0f) < 0.2f);
+}
+
+TEST_CASE("Oversampling adds its filter delay to the latency")
+{
+    CompressorEngine engine;
+    engine.prepare(48000.0, 64, 1);
+    engine.setSettings({ 0.0f, 1.0f, 1.0f, 10.0f, 0.0f }); // 1:1, unity gain
+    engine.setLookahead(1.0f);
+
+    CHECK(engine.setOversamplingFactor(2));
+    CHECK(! engine.setOversamplingFactor(2));
+    CHECK(engine.getProcessingRate() == 96000.0);
+    CHECK(engine.getLatencySamples() == 48 + 23);
+
+    std::vector<float> input(3000), output(3000);
+
+    for (size_t i = 0; i < input.size(); ++i)
+        input[i] = output[i] = 0.5f * std::sin(0.13f * (float) i);
+
+    for (int offset = 0, size = 37; offset < 3000; offset += size)
+    {
+        float* slice[] = { output.data() + offset };
+        engine.compress(slice, 1, std::min(size, 3000 - offset));
+    }
+
+    auto maxError = 0.0f;
+
+    for (size_t i = 200; i < output.size(); ++i)
+        maxError = std::max(maxError, std::abs(output[i] - input[i - 71]));
+
+    CHECK(maxError < 2e-3f);
+
+    // 4x: half a sample of filter delay is rounded
+    CHECK(engine.setOversamplingFactor(4));
+    CHECK(engine.getLatencySamples() == 48 + 29);
+}
+
+TEST_CASE("Oversampled detector catches inter-sample peaks")
+{
+    // fs/4 at 45 degrees: samples at +-0.707, true peak 1.0
+    auto outputRms = [](int factor)
+    {
+        CompressorEngine engine;
+        engine.prepare(48000.0, 512, 1);
+        engine.setOversamplingFactor(factor);
+        engine.setSettings({ -1.0f, 20.0f, 0.1f, 50.0f, 0.0f });
+
+        std::vector<float> data(512);
+        double sum = 0.0;
+
+        for (int block = 0; block < 40; ++block)
+        {
+            for (int i = 0; i < 512; ++i)
+                data[(size_t) i] = std::sin(1.5707963f * (float) (block * 512 + i) + 0.7853982f);
+
+            float* channels[] = { data.data() };
+            engine.compress(channels, 1, 512);
+
+            if (block >= 20)
+                for (auto x : data)
+                    sum += x * x;
+        }
+
+        return std::sqrt(sum / (20 * 512));
+    };
+
+    CHECK_NEAR(outputRms(1), std::sqrt(0.5), 1e-3);
+    CHECK(outputRms(4) < 0.95 * std::sqrt(0.5));
+}
+
+TEST_CASE("Multiband without gain reduction keeps the level")
+{
+    // 1:1 bands sum back to an allpass of the input, with or without lookahead
+    for (float lookahead : { 0.0f, 2.0f })
+    {
+        CompressorEngine engine;
+        engine.prepare(48000.0, 256, 2);
+        engine.setSettings({ 0.0f, 1.0f, 1.0f, 10.0f, 0.0f });
+        engine.setLookahead(lookahead);
+
+        CHECK(engine.setNumBands(4));
+        CHECK(! engine.setNumBands(4));
+        CHECK(! engine.setNumBands(2));
+        CHECK(engine.getNumBands() == 4);
+        CHECK(engine.getLatencySamples() == static_cast<int>(lookahead * 48.0f));
+
+        for (double frequency : { 80.0, 1000.0, 9000.0 })
+        {
+            std::vector<float> left(256), right(256);
+            float* channels[] = { left.data(), right.data() };
+            auto sumSquares = 0.0;
+
+            for (int block = 0; block < 100; ++block)
+            {
+                for (int i = 0; i < 256; ++i)
+                    left[(size_t) i] = right[(size_t) i] = 0.5f * (float) std::sin(6.283185307 * frequency * (block * 256 + i) / 48000.0);
+
+                engine.compress(channels, 2, 256);
+
+                if (block >= 50)
+                    for (auto x : left)
+                        sumSquares += x * x;
+            }
+
+            CHECK_NEAR(std::sqrt(sumSquares / (50 * 256)), 0.5 / std::sqrt(2.0), 2e-3);
+        }
+    }
+}
+
+TEST_CASE("Lowest band compresses like the broadband path")
+{
+    // DC only reaches the lowest band, whose time constants the layout scales
+    CompressorEngine multiband, broadband;
+    const CompressorSettings settings { -20.0f, 4.0f, 1.0f, 10.0f, 0.0f };
+
+    for (auto* engine : { &multiband, &broadband })
+    {
+        engine->prepare(48000.0, 480, 1);
+        engine->setSettings(settings);
+    }
+
+    multiband.setNumBands(3);
+
+    std::vector<float> data(480);
+    float* channels[] = { data.data() };
+
+    for (int block = 0; block < 100; ++block)
+    {
+        std::fill(data.begin(), data.end(), 0.5f);
+        multiband.compress(channels, 1, 480);
+    }
+
+    CHECK_NEAR(CompressorEngine::linearToDb(data.back() / 0.5f), settledGainDb(broadband, 0.5f, 48000), 0.05);
+    CHECK_NEAR(multiband.getBandEnvelope(1), 1.0f, 1e-3);
+    CHECK_NEAR(multiband.getBandEnvelope(2), 1.0f, 1e-3);
+
+    // Back to one band: the broadband path again
+    CHECK(multiband.setNumBands(1));
+    CHECK(multiband.getNumBands() == 1);
+}
+
+TEST_CASE("External detector input ducks the audio")
+{
+    // Quiet programme, loud sidechain: the gain follows the sidechain
+    for (int bands : { 1, 3 })
+    {
+        for (int factor : { 1, 2 })
+        {
+            CompressorEngine engine;
+            engine.prepare(48000.0, 256, 2);
+            engine.setSettings({ -20.0f, 8.0f, 1.0f, 50.0f, 0.0f });
+            engine.setNumBands(bands);
+            engine.setOversamplingFactor(factor);
+
+            std::vector<float> left(256), right(256), key(256);
+            float* channels[] = { left.data(), right.data() };
+            const float* sidechain[] = { key.data() };
+            auto sumSquares = 0.0;
+
+            for (int block = 0; block < 100; ++block)
+            {
+                for (int i = 0; i < 256; ++i)
+                {
+                    const auto phase = 0.13f * (float) (block * 256 + i);
+                    left[(size_t) i] = right[(size_t) i] = 0.05f * std::sin(phase);
+                    key[(size_t) i] = 0.8f * std::sin(phase);
+                }
+
+                engine.compress(channels, 2, 256, sidechain, 1);
+
+                if (block >= 50)
+                    for (auto x : left)
+                        sumSquares += x * x;
+            }
+
+            // 0.05 peak would be -29 dB RMS; the sidechain pulls it well below
+            const auto rmsDb = CompressorEngine::linearToDb((float) std::sqrt(sumSquares / (50 * 256)));
+            CHECK(rmsDb < -29.0f - 10.0f);
+        }
+    }
+}
+
+TEST_CASE("Sidechain carrying the audio matches plain compression")
+{
+    CompressorEngine plain, keyed;
+
+    for (auto* engine : { &plain, &keyed })
+    {
+        engine->prepare(48000.0, 128, 2);
+        engine->setStereoLink(StereoLink::unlinked);
+        engine->setSettings({ -24.0f, 5.0f, 3.0f, 60.0f, 2.0f });
+    }
+
+    std::vector<float> left(1000), right(1000);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        left[(size_t) i] = 0.9f * std::sin(0.05f * (float) i) * (i < 500 ? 1.0f : 0.05f);
+        right[(size_t) i] = 0.4f * std::cos(0.031f * (float) i);
+    }
+
+    auto keyedLeft = left, keyedRight = right;
+    float* plainChannels[] = { left.data(), right.data() };
+    plain.compress(plainChannels, 2, 1000);
+
+    // A separate pointer array takes the external path over the same data
+    const auto original = keyedLeft;
+    const auto originalRight = keyedRight;
+    const float* sidechain[] = { original.data(), originalRight.data() };
+    float* keyedChannels[] = { keyedLeft.data(), keyedRight.data() };
+    keyed.compress(keyedChannels, 2, 1000, sidechain, 2);
+
+    for (size_t i = 0; i < left.size(); ++i)
+    {
+        CHECK_NEAR(left[i], keyedLeft[i], 0.0);
+        CHECK_NEAR(right[i], keyedRight[i], 0.0);
+    }
+}
+
+TEST_CASE("A stereo key drives every channel of a 5.1 bed alike")
+{
+    // L R C LFE Ls Rs: fronts, LFE excluded, surrounds
+    const int surroundGroups[] = { 0, 0, 0, LinkGroups::excluded, 1, 1 };
+
+    for (int layout = 0; layout < 2; ++layout)
+    {
+        for (int bands : { 1, 3 })
+        {
+            CompressorEngine engine;
+            engine.prepare(48000.0, 256, 6);
+            engine.setSettings({ -20.0f, 8.0f, 1.0f, 50.0f, 0.0f });
+            engine.setNumBands(bands);
+
+            LinkGroups groups;
+            groups.assign(surroundGroups, 6);
+
+            if (layout == 0)
+                engine.setLinkGroups(groups);
+            else
+                engine.setStereoLink(StereoLink::unlinked);
+
+            // The same quiet programme on every channel; the key is loud on
+            // its left only, so keying anything from its right would miss it
+            std::vector<std::vector<float>> audio(6, std::vector<float>(256));
+            std::vector<float> keyLeft(256), keyRight(256, 0.0f);
+            float* channels[6];
+            const float* key[] = { keyLeft.data(), keyRight.data() };
+            double sumSquares[6] {};
+
+            for (int channel = 0; channel < 6; ++channel)
+                channels[channel] = audio[(size_t) channel].data();
+
+            for (int block = 0; block < 100; ++block)
+            {
+                for (int i = 0; i < 256; ++i)
+                {
+                    const auto phase = 0.13f * (float) (block * 256 + i);
+
+                    for (auto& channel : audio)
+                        channel[(size_t) i] = 0.05f * std::sin(phase);
+
+                    keyLeft[(size_t) i] = 0.8f * std::sin(phase);
+                }
+
+                engine.compress(channels, 6, 256, key, 2);
+
+                if (block >= 50)
+                    for (int channel = 0; channel < 6; ++channel)
+                        for (auto x : audio[(size_t) channel])
+                            sumSquares[channel] += x * x;
+            }
+
+            auto rmsDb = [&](int channel)
+            {
+                return CompressorEngine::linearToDb((float) std::sqrt(sumSquares[channel] / (50 * 256)));
+            };
+
+            // 0.05 peak is -29 dB RMS; every keyed channel is pulled well below
+            // (by the key's mono sum, 6 dB under its left channel)
+            for (int channel = 0; channel < 6; ++channel)
+            {
+                if (layout == 0 && channel == 3)
+                    CHECK_NEAR(rmsDb(channel), -29.0f, 0.5);
+                else
+                    CHECK(rmsDb(channel) < -29.0f - 6.0f);
+            }
+
+            CHECK_NEAR(rmsDb(4), rmsDb(0), 0.01);
+            CHECK_NEAR(rmsDb(5), rmsDb(1), 0.01);
+        }
+    }
+}
+
+TEST_CASE("Detector high-pass keeps bass from driving the gain")
+{
+    auto gainReductionDb = [](float highPassHz)
+    {
+        CompressorEngine engine;
+        engine.prepare(48000.0, 480, 1);
+        engine.setSettings({ -20.0f, 4.0f, 1.0f, 50.0f, 0.0f });
+        engine.setDetectorHighPass(highPassHz);
+
+        std::vector<float> data(480);
+        float* channels[] = { data.data() };
+        auto peak = 0.0f;
+
+        for (int block = 0; block < 100; ++block)
+        {
+            for (int i = 0; i < 480; ++i)
+                data[(size_t) i] = 0.5f * (float) std::sin(6.283185307 * 40.0 * (block * 480 + i) / 48000.0);
+
+            engine.compress(channels, 1, 480);
+
+            if (block >= 50)
+                for (auto x : data)
+                    peak = std::max(peak, std::abs(x));
+        }
+
+        return CompressorEngine::linearToDb(0.5f / peak);
+    };
+
+    CHECK(gainReductionDb(0.0f) > 8.0f);
+    CHECK(gainReductionDb(300.0f) < 1.0f);
+}
+
+TEST_CASE("Double precision matches the float path")
+{
+    for (int numBands : { 1, 3 })
+    {
+        for (int factor : { 1, 2 })
+        {
+            CompressorEngine single, wide;
+            single.prepare(48000.0, 256, 2);
+            wide.prepare(48000.0, 256, 2, true);
+            CHECK(wide.isDoublePrecision());
+
+            for (auto* engine : { &single, &wide })
+            {
+                engine->setNumBands(numBands);
+                engine->setOversamplingFactor(factor);
+                engine->setLookahead(2.0f);
+                engine->setSettings({ -24.0f, 4.0f, 2.0f, 80.0f, 3.0f });
+            }
+
+            std::vector<float> left(2000), right(2000);
+            std::vector<double> wideLeft(2000), wideRight(2000);
+
+            for (size_t i = 0; i < 2000; ++i)
+            {
+                wideLeft[i] = 0.8 * std::sin(0.013 * static_cast<double>(i)) * (i > 1000 ? 1.0 : 0.1);
+                wideRight[i] = 0.3 * std::cos(0.071 * static_cast<double>(i));
+                left[i] = static_cast<float>(wideLeft[i]);
+                right[i] = static_cast<float>(wideRight[i]);
+            }
+
+            float* channels[] = { left.data(), right.data() };
+            double* wideChannels[] = { wideLeft.data(), wideRight.data() };
+            single.compress(channels, 2, 2000);
+            wide.compress(wideChannels, 2, 2000);
+
+            // Same gains; only the rounding of the audio path differs
+            for (size_t i = 0; i < 2000; ++i)
+            {
+                CHECK_NEAR(wideLeft[i], left[i], 1e-4);
+                CHECK_NEAR(wideRight[i], right[i], 1e-4);
+            }
+
+            CHECK_NEAR(wide.getEnvelope(), single.getEnvelope(), 1e-5);
+        }
+    }
+}
+
+TEST_CASE("Double precision audio is never narrowed to float")
+{
+    CompressorEngine engine;
+    engine.prepare(48000.0, 64, 1, true);
+    engine.setLookahead(1.0f);
+
+    // Far below float resolution around 0.1: lost by any float round trip
+    std::vector<double> input(1000), output(1000);
+
+    for (size_t i = 0; i < input.size(); ++i)
+        input[i] = 0.1 + 1e-12 * static_cast<double>(i);
+
+    output = input;
+
+    for (int offset = 0; offset < 1000; offset += 64)
+    {
+        double* slice[] = { output.data() + offset };
+        engine.bypass(slice, 1, std::min(64, 1000 - offset));
+    }
+
+    const auto latency = static_cast<size_t>(engine.getLatencySamples());
+
+    for (size_t i = latency; i < output.size(); ++i)
+        CHECK_NEAR(output[i], input[i - latency], 0.0);
+}
+
+TEST_CASE("Very long releases recover fully")
+{
+    // 2 s release at 192 kHz: the per-sample envelope step near unity is
+    // below float resolution, so a float envelope would stall short of 1
+    CompressorEngine engine;
+    engine.prepare(192000.0, 4096, 1);
+    engine.setSettings({ -20.0f, 8.0f, 1.0f, 2000.0f, 0.0f });
+
+    std::vector<float> block(4096, 1.0f);
+    float* channels[] = { block.data() };
+    engine.compress(channels, 1, 4096);
+    CHECK(engine.getEnvelope() < 0.5f);
+
+    // 20 s of silence, ten time constants
+    for (int i = 0; i < 940; ++i)
+    {
+        std::fill(block.begin(), block.end(), 0.0f);
+        engine.compress(channels, 1, 4096);
+    }
+
+    CHECK(engine.getEnvelope() > 0.9995f);
+}
+
+TEST_CASE("Metering is off until asked for, then reports levels and reduction")
+{
+    CompressorEngine engine;
+    engine.prepare(48000.0, 512, 2);
+    engine.setSettings({ -20.0f, 4.0f, 1.0f, 50.0f, 0.0f });
+
+    // 1 kHz at 0.5 peak; 48 samples per period, so the peak is hit exactly
+    std::vector<float> left(4800), right(4800);
+    float* channels[] = { left.data(), right.data() };
+
+    auto fill = [&]
+    {
+        for (size_t i = 0; i < left.size(); ++i)
+            left[i] = right[i] = 0.5f * std::sin(6.2831853f * 1000.0f * static_cast<float>(i) / 48000.0f);
+    };
+
+    fill();
+    engine.compress(channels, 2, 4800);
+    CHECK(! engine.readLevels().hasNewAudio);
+
+    engine.setMetering(true);
+    fill();
+    engine.compress(channels, 2, 4800);
+
+    const auto reading = engine.readLevels();
+    CHECK(reading.hasNewAudio);
+    CHECK_NEAR(reading.inputPeak, 0.5f, 1e-4);
+    CHECK_NEAR(reading.inputRms, 0.5f / std::sqrt(2.0f), 1e-3);
+    CHECK(reading.outputPeak < 0.5f * reading.inputPeak);
+    CHECK(reading.outputRms < 0.5f * reading.inputRms);
+
+    // Envelope at the end of the block: about 10.5 dB at the static curve's
+    // peak, less on average over the sine
+    CHECK(reading.gainReduction > 4.0f && reading.gainReduction < 11.0f);
+
+    // Bypass reports its input as output, with no reduction
+    fill();
+    engine.bypass(channels, 2, 4800);
+    const auto bypassed = engine.readLevels();
+    CHECK_NEAR(bypassed.outputPeak, bypassed.inputPeak, 0.0);
+    CHECK_NEAR(bypassed.outputRms, bypassed.inputRms, 0.0);
+    CHECK_NEAR(bypassed.gainReduction, 0.0f, 0.0);
+}
+
+TEST_CASE("Reset clears the detector state")
+{
+    CompressorEngine engine;
+    engine.prepare(44100.0, 512, 2);
+    engine.setSettings({ -20.0f, 4.0f, 1.0f, 10.0f, 0.0f });
+
+    settledGainDb(engine, 1.0f, 4410);
+    CHECK(engine.getEnvelope() < 0.5f);
+
+    engine.reset();
+    CHECK_NEAR(engine.getEnvelope(), 1.0f, 0.0);
+    CHECK_NEAR(engine.getCurrentRms(), 0.0f, 0.0);
+}
+
+TEST_CASE("Silence is skipped once the tail has played out")
+{
+    for (int bands : { 1, 3 })
+    {
+        // The same audio, then digital silence into one engine and a floor
+        // far below any threshold (never skipped) into the other
+        CompressorEngine silent, quiet;
+
+        for (auto* engine : { &silent, &quiet })
+        {
+            engine->prepare(48000.0, 256, 2);
+            engine->setSettings({ -30.0f, 8.0f, 1.0f, 50.0f, 6.0f });
+            engine->setLookahead(2.0f);
+            engine->setOversamplingFactor(2);
+            engine->setNumBands(bands);
+        }
+
+        std::vector<float> left(256), right(256), quietLeft(256), quietRight(256);
+        float* channels[] = { left.data(), right.data() };
+        float* quietChannels[] = { quietLeft.data(), quietRight.data() };
+        int sample = 0, lastSound = -1, firstIdle = -1;
+        float worst = 0.0f;
+
+        for (int block = 0; block < 200; ++block)
+        {
+            for (int i = 0; i < 256; ++i, ++sample)
+            {
+                const auto x = block < 20 ? 0.8f * std::sin(0.05f * static_cast<float>(sample)) : 0.0f;
+                left[(size_t) i] = right[(size_t) i] = x;
+                quietLeft[(size_t) i] = quietRight[(size_t) i] = block < 20 ? x : 1e-20f;
+            }
+
+            silent.compress(channels, 2, 256);
+            quiet.compress(quietChannels, 2, 256);
+            CHECK(! quiet.isIdle());
+
+            for (int i = 0; i < 256; ++i)
+                if (left[(size_t) i] != 0.0f || right[(size_t) i] != 0.0f)
+                    lastSound = block * 256 + i;
+
+            if (silent.isIdle() && firstIdle < 0)
+                firstIdle = block;
+
+            // Once idle it stays idle, and releases like the processed engine
+            if (firstIdle >= 0)
+                CHECK(silent.isIdle());
+
+            for (int band = 0; band < bands; ++band)
+                worst = std::max(worst, bands == 1 ? std::abs(silent.getEnvelope() - quiet.getEnvelope())
+                                                   : std::abs(silent.getBandEnvelope(band) - quiet.getBandEnvelope(band)));
+        }
+
+        // Skipping starts as soon as the tail is flushed, and the sound
+        // ended within the tail
+        CHECK(firstIdle > 20 && (firstIdle - 20) * 256 <= silent.getTailSamples() + 2 * 256);
+        CHECK(lastSound >= 20 * 256 + silent.getLatencySamples() - 1);
+        CHECK(lastSound < 20 * 256 + silent.getTailSamples());
+        CHECK(worst < (bands == 1 ? 1e-6f : 1e-3f));    // multiband envelopes are float
+
+        // Sound wakes it up
+        std::fill(left.begin(), left.end(), 0.5f);
+        std::fill(right.begin(), right.end(), 0.5f);
+        silent.compress(channels, 2, 256);
+        CHECK(! silent.isIdle());
+        CHECK(std::abs(left.back()) > 0.01f);
+    }
+}
+
+TEST_CASE("Tail covers the oversampling filters and crossovers")
+{
+    for (int bands : { 1, 4 })
+    {
+        CompressorEngine engine;
+        engine.prepare(48000.0, 512, 1);
+        engine.setSettings({ 0.0f, 1.0f, 1.0f, 10.0f, 0.0f }); // 1:1, unity gain
+        engine.setLookahead(1.0f);
+        engine.setOversamplingFactor(4);
+        engine.setNumBands(bands);
+
+        CHECK(engine.getTailSamples() > engine.getLatencySamples());
+
+        std::vector<float> audio(48000, 0.0f);
+        audio[0] = 1.0f;
+
+        for (int offset = 0; offset < 48000; offset += 512)
+        {
+            float* slice[] = { audio.data() + offset };
+            engine.compress(slice, 1, std::min(512, 48000 - offset));
+        }
+
+        int last = 0;
+
+        for (int i = 0; i < 48000; ++i)
+            if (std::abs(audio[(size_t) i]) > 1e-6f)    // -120 dB
+                last = i;
+
+        CHECK(last >= engine.getLatencySamples());
+        CHECK(last < engine.getTailSamples());
+    }
+}
+
+TEST_CASE("Bypass crossfades instead of stepping")
+{
+    // Constant input, so any output step is a gain step (a click)
+    auto largestStep = [](bool fade)
+    {
+        CompressorEngine engine;
+        engine.prepare(48000.0, 256, 1);
+        engine.setSettings({ -30.0f, 8.0f, 5.0f, 50.0f, 0.0f });
+        engine.setLookahead(2.0f);
+
+        std::vector<float> audio(256);
+        float* channels[] = { audio.data() };
+        float previous = 0.0f, step = 0.0f;
+
+        for (int block = 0; block < 300; ++block)
+        {
+            const auto off = block >= 100 && block < 200;
+            engine.setBypassed(fade && off);
+
+            std::fill(audio.begin(), audio.end(), 0.5f);
+
+            if (off && ! fade)
+                engine.bypass(channels, 1, 256);
+            else
+                engine.compress(channels, 1, 256);
+
+            if (fade && block == 150)
+            {
+                CHECK(engine.isBypassed());
+                CHECK_NEAR(audio.front(), 0.5f, 0.0);
+                CHECK_NEAR(audio.back(), 0.5f, 0.0);
+            }
+
+            for (auto sample : audio)
+            {
+                if (block >= 100)
+                    step = std::max(step, std::abs(sample - previous));
+
+                previous = sample;
+            }
+        }
+
+        return step;
+    };
+
+    const auto faded = largestStep(true);
+    const auto jumped = largestStep(false);
+
+    CHECK(faded < 0.002f);
+    CHECK(jumped > 100.0f * faded);
+}
+
+TEST_CASE("Bypass fade lands exactly on the bypassed output")
+{
+    for (int bands : { 1, 3 })
+    {
+        CompressorEngine fading, bypassing;
+
+        for (auto* engine : { &fading, &bypassing })
+        {
+            engine->prepare(48000.0, 128, 2);
+            engine->setSettings({ -30.0f, 4.0f, 1.0f, 50.0f, 3.0f });
+            engine->setLookahead(1.0f);
+            engine->setOversamplingFactor(2);
+            engine->setNumBands(bands);
+        }
+
+        fading.setBypassed(true);
+
+        // The fade, then the downsampling filter still holding faded samples
+        const auto fadeSamples = static_cast<int>(CompressorEngine::bypassFadeSeconds * 48000.0) + fading.getTailSamples();
+
+        std::vector<float> left(128), right(128), expectedLeft(128), expectedRight(128);
+        float* channels[] = { left.data(), right.data() };
+        float* expected[] = { expectedLeft.data(), expectedRight.data() };
+        float worst = 0.0f;
+
+        for (int block = 0; block < 60; ++block)
+        {
+            for (int i = 0; i < 128; ++i)
+            {
+                const auto phase = static_cast<float>(block * 128 + i);
+                left[(size_t) i] = expectedLeft[(size_t) i] = 0.7f * std::sin(0.031f * phase);
+                right[(size_t) i] = expectedRight[(size_t) i] = 0.4f * std::sin(0.17f * phase);
+            }
+
+            fading.compress(channels, 2, 128);
+            bypassing.bypass(expected, 2, 128);
+
+            // Same delay path throughout: identical once the fade is over
+            for (int i = 0; i < 128; ++i)
+                if (block * 128 + i >= fadeSamples)
+                    worst = std::max({ worst, std::abs(left[(size_t) i] - expectedLeft[(size_t) i]),
+                                              std::abs(right[(size_t) i] - expectedRight[(size_t) i]) });
+        }
+
+        CHECK_NEAR(worst, 0.0f, 0.0);
+    }
+}
+
+TEST_MAIN()
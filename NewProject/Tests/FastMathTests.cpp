@@ -0,0 +1,68 @@
+/*
+  ==============================================================================
+
+    FastMathTests.cpp
+
+  ==============================================================================
+*/
+
+#include "TestHarness.h"
+#include "../Source/DSP/FastMath.h"
+
+#include <cmath>
+
+using namespace autocomp::fastmath;
+
+TEST_CASE("fastLog2 stays inside its documented error bound")
+{
+    double maxError = 0.0;
+
+    // 1e-6 (the detector floor) up to +24 dB, dense enough to hit every fold
+    for (double x = 1.0e-6; x < 16.0; x *= 1.0001)
+    {
+        const auto approx = fastLog2(static_cast<float>(x));
+        const auto exact = std::log2(static_cast<double>(static_cast<float>(x)));
+        maxError = std::max(maxError, std::abs(approx - exact));
+    }
+
+    CHECK(maxError < 2.0e-6 + 4.0e-6); // analytic bound + float rounding
+}
+
+TEST_CASE("fastLog2 is exact on powers of two")
+{
+    for (int e = -20; e <= 4; ++e)
+        CHECK_NEAR(fastLog2(std::ldexp(1.0f, e)), (float) e, 1e-6);
+}
+
+TEST_CASE("fastExp2 stays inside its documented error bound")
+{
+    double maxRelativeError = 0.0;
+
+    for (double x = -40.0; x <= 8.0; x += 0.00037)
+    {
+        const auto approx = fastExp2(static_cast<float>(x));
+        const auto exact = std::exp2(static_cast<double>(static_cast<float>(x)));
+        maxRelativeError = std::max(maxRelativeError, std::abs(approx - exact) / exact);
+    }
+
+    CHECK(maxRelativeError < 1.8e-7 + 5.0e-7); // analytic bound + float rounding
+}
+
+TEST_CASE("fastExp2 clamps out-of-range input")
+{
+    CHECK(fastExp2(-1000.0f) > 0.0f);
+    CHECK(std::isfinite(fastExp2(1000.0f)));
+    CHECK_NEAR(fastExp2(0.0f), 1.0f, 1e-7);
+}
+
+TEST_CASE("dB helpers agree with the exact conversions")
+{
+    for (float db = -120.0f; db <= 24.0f; db += 0.25f)
+    {
+        const auto linear = std::pow(10.0f, db / 20.0f);
+        CHECK_NEAR(fastDbToLinear(db), linear, linear * 1e-5);
+        CHECK_NEAR(fastLinearToDb(linear), db, 1e-4);
+    }
+}
+
+TEST_MAIN()
@@ -0,0 +1,60 @@
+/*
+  ==============================================================================
+
+    FftTests.cpp
+
+  ==============================================================================
+*/
+
+#include "TestHarness.h"
+#include "../Source/DSP/Fft.h"
+
+#include <complex>
+#include <random>
+#include <vector>
+
+using autocomp::Fft;
+
+TEST_CASE("Matches a direct DFT")
+{
+    Fft fft(6);
+    const auto size = fft.getSize();
+    CHECK(size == 64);
+
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    std::vector<std::complex<float>> data((size_t) size);
+
+    for (auto& value : data)
+        value = { distribution(random), distribution(random) };
+
+    const auto input = data;
+    fft.perform(data.data());
+
+    for (int k = 0; k < size; ++k)
+    {
+        std::complex<double> expected;
+
+        for (int n = 0; n < size; ++n)
+            expected += std::complex<double>(input[(size_t) n]) * std::polar(1.0, -6.283185307179586 * k * n / size);
+
+        CHECK_NEAR(data[(size_t) k].real(), expected.real(), 1e-4);
+        CHECK_NEAR(data[(size_t) k].imag(), expected.imag(), 1e-4);
+    }
+}
+
+TEST_CASE("Frequency-only transform finds a sine in its bin")
+{
+    Fft fft(10);
+    std::vector<float> data(2048, 0.0f);
+
+    for (int i = 0; i < 1024; ++i)
+        data[(size_t) i] = 0.5f * std::cos(6.2831853f * 37.0f * (float) i / 1024.0f);
+
+    fft.performFrequencyOnlyForwardTransform(data.data());
+
+    CHECK_NEAR(data[37], 0.5f * 512.0f, 1e-2);
+    CHECK(data[36] < 1e-2f && data[38] < 1e-2f && data[0] < 1e-2f);
+}
+
+TEST_MAIN()
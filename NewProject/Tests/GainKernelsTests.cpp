@@ -0,0 +1,224 @@
+/*
+  ==============================================================================
+
+    GainKernelsTests.cpp
+
+  ==============================================================================
+*/
+
+#include "TestHarness.h"
+#include "../Source/DSP/CompressorEngine.h"
+#include "../Source/DSP/GainKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using autocomp::CompressorEngine;
+using autocomp::kernels::GainStage;
+using autocomp::kernels::InstructionSet;
+
+namespace kernels = autocomp::kernels;
+
+namespace
+{
+    const InstructionSet instructionSets[] = { InstructionSet::baseline, InstructionSet::avx2, InstructionSet::avx512 };
+
+    std::vector<float> makeLevels(int numSamples)
+    {
+        std::vector<float> levels(static_cast<size_t>(numSamples));
+        std::uint32_t seed = 0x1234567u;
+
+        for (auto& level : levels)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            level = std::pow(10.0f, -3.0f * static_cast<float>(seed >> 8) / 16777216.0f);
+        }
+
+        return levels;
+    }
+
+    // The textbook gain computer in double, with exact log2/exp2
+    std::vector<float> reference(const std::vector<float>& levels, const GainStage& stage, bool gliding, bool makeup)
+    {
+        std::vector<float> gains(levels.size());
+        double envelope = 1.0;
+
+        for (size_t i = 0; i < levels.size(); ++i)
+        {
+            const double threshold = gliding ? stage.thresholds[i] : stage.thresholdLog2;
+            const double slope = gliding ? stage.slopes[i] : stage.slope;
+            const auto overshoot = std::max(std::log2(std::max(static_cast<double>(levels[i]), 1e-6)) - threshold, 0.0);
+            const auto target = std::exp2(overshoot * slope);
+            const double coeff = target < envelope ? (gliding ? stage.attacks[i] : stage.attack)
+                                                   : (gliding ? stage.releases[i] : stage.release);
+            envelope = target + (envelope - target) * coeff;
+            gains[i] = static_cast<float>(envelope * (makeup ? (gliding ? stage.makeups[i] : stage.makeup) : 1.0));
+        }
+
+        return gains;
+    }
+
+    struct Ramps
+    {
+        std::vector<float> thresholds, slopes, attacks, releases, makeups;
+
+        explicit Ramps(int numSamples)
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const auto position = static_cast<float>(i) / static_cast<float>(numSamples);
+                thresholds.push_back(-5.0f + 2.0f * position);
+                slopes.push_back(-0.5f - 0.3f * position);
+                attacks.push_back(0.9f + 0.05f * position);
+                releases.push_back(0.999f - 0.01f * position);
+                makeups.push_back(1.0f + position);
+            }
+        }
+
+        void attach(GainStage& stage) const
+        {
+            stage.thresholds = thresholds.data();
+            stage.slopes = slopes.data();
+            stage.attacks = attacks.data();
+            stage.releases = releases.data();
+            stage.makeups = makeups.data();
+        }
+    };
+}
+
+TEST_CASE("Every variant on every instruction set matches the reference")
+{
+    constexpr int numSamples = 1027;   // not a multiple of any vector width
+    const auto levels = makeLevels(numSamples);
+    const Ramps ramps(numSamples);
+
+    GainStage stage;
+    stage.thresholdLog2 = -4.0f;
+    stage.slope = -0.75f;
+    stage.attack = 0.95;
+    stage.release = 0.9995;
+    stage.makeup = 1.5;
+    ramps.attach(stage);
+
+    for (auto instructionSet : instructionSets)
+    {
+        const auto& table = kernels::getGainKernels(instructionSet);
+        CHECK(table.instructionSet == (kernels::isSupported(instructionSet) ? instructionSet : InstructionSet::baseline));
+
+        for (auto gliding : { false, true })
+            for (auto makeup : { false, true })
+            {
+                const auto expected = reference(levels, stage, gliding, makeup);
+                auto gains = levels;
+                double envelope = 1.0;
+                table.get(gliding, makeup)(gains.data(), numSamples, envelope, stage);
+
+                double worst = 0.0;
+
+                for (size_t i = 0; i < gains.size(); ++i)
+                    worst = std::max(worst, std::abs(std::log2(gains[i] / static_cast<double>(expected[i]))));
+
+                CHECK(worst < 1e-5);   // log2 units: well under 0.0001 dB
+                CHECK_NEAR(envelope * (makeup ? (gliding ? ramps.makeups.back() : stage.makeup) : 1.0),
+                           expected.back(), 1e-5);
+            }
+    }
+}
+
+TEST_CASE("Instruction sets agree with each other")
+{
+    constexpr int numSamples = 509;
+    const auto levels = makeLevels(numSamples);
+
+    GainStage stage;
+    stage.thresholdLog2 = -3.0f;
+    stage.slope = -0.5f;
+    stage.attack = 0.9;
+    stage.release = 0.999;
+    stage.makeup = 2.0;
+
+    auto expected = levels;
+    double expectedEnvelope = 1.0;
+    kernels::getGainKernels(InstructionSet::baseline).get(false, true)(expected.data(), numSamples, expectedEnvelope, stage);
+
+    for (auto instructionSet : instructionSets)
+    {
+        auto gains = levels;
+        double envelope = 1.0;
+        kernels::getGainKernels(instructionSet).get(false, true)(gains.data(), numSamples, envelope, stage);
+
+        for (size_t i = 0; i < gains.size(); ++i)
+            CHECK_NEAR(gains[i], expected[i], 1e-6 * expected[i]);
+    }
+}
+
+TEST_CASE("The default is the widest supported set")
+{
+    const auto chosen = kernels::getGainKernels().instructionSet;
+    CHECK(kernels::isSupported(chosen));
+
+    if (kernels::isSupported(InstructionSet::avx512))
+        CHECK(chosen == InstructionSet::avx512);
+    else if (kernels::isSupported(InstructionSet::avx2))
+        CHECK(chosen == InstructionSet::avx2);
+
+    CHECK(kernels::isSupported(InstructionSet::baseline));
+    CHECK(std::string(kernels::getName(InstructionSet::baseline)).size() > 0);
+}
+
+TEST_CASE("The engine sounds the same on every instruction set")
+{
+    constexpr int blockSize = 480;
+
+    auto render = [&](InstructionSet instructionSet)
+    {
+        CompressorEngine engine;
+        engine.prepare(48000.0, blockSize, 2);
+        engine.setInstructionSet(instructionSet);
+        engine.setSettings({ -24.0f, 4.0f, 5.0f, 80.0f, 3.0f });
+
+        std::vector<float> output;
+        std::vector<float> left(blockSize), right(blockSize);
+        float* channels[] = { left.data(), right.data() };
+
+        for (int block = 0; block < 40; ++block)
+        {
+            // Steady, then gliding, then steady with no makeup
+            if (block == 10)
+                engine.setTargetSettings({ -12.0f, 8.0f, 1.0f, 200.0f, 6.0f });
+            else if (block == 25)
+                engine.setSettings({ -30.0f, 2.0f, 20.0f, 300.0f, 0.0f });
+
+            for (int i = 0; i < blockSize; ++i)
+            {
+                const auto phase = static_cast<float>(block * blockSize + i) * 0.0625f;
+                left[static_cast<size_t>(i)] = 0.8f * std::sin(phase) * (block % 3 == 0 ? 0.1f : 1.0f);
+                right[static_cast<size_t>(i)] = 0.5f * std::cos(0.5f * phase);
+            }
+
+            engine.compress(channels, 2, blockSize);
+            output.insert(output.end(), left.begin(), left.end());
+            output.insert(output.end(), right.begin(), right.end());
+        }
+
+        return output;
+    };
+
+    const auto expected = render(InstructionSet::baseline);
+
+    for (auto instructionSet : instructionSets)
+    {
+        const auto output = render(instructionSet);
+        float worst = 0.0f;
+
+        for (size_t i = 0; i < output.size(); ++i)
+            worst = std::max(worst, std::abs(output[i] - expected[i]));
+
+        CHECK(worst < 1e-6f);
+    }
+}
+
+TEST_MAIN()
@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+    LevelMeterTests.cpp
+
+  ==============================================================================
+*/
+
+#include "TestHarness.h"
+#include "../Source/DSP/LevelMeter.h"
+
+#include <atomic>
+#include <thread>
+
+using autocomp::BlockLevels;
+using autocomp::LevelMeter;
+
+namespace
+{
+    BlockLevels constantBlock(float level, int numSamples)
+    {
+        BlockLevels block;
+        block.inputPeak = level;
+        block.outputPeak = 0.5f * level;
+        block.inputSquares = static_cast<double>(level) * level * numSamples;
+        block.outputSquares = block.inputSquares * 0.25;
+        return block;
+    }
+}
+
+TEST_CASE("Nothing published reads as silence")
+{
+    LevelMeter meter;
+    const auto reading = meter.read();
+
+    CHECK(! reading.hasNewAudio);
+    CHECK_NEAR(reading.inputPeak, 0.0f, 0.0);
+    CHECK_NEAR(reading.inputRms, 0.0f, 0.0);
+    CHECK_NEAR(reading.gainReduction, 0.0f, 0.0);
+}
+
+TEST_CASE("Peaks are held and RMS covers everything since the last read")
+{
+    LevelMeter meter;
+    meter.publish(constantBlock(0.8f, 100), 100, 6.0f);
+    meter.publish(constantBlock(0.2f, 300), 300, 2.0f);
+
+    auto reading = meter.read();
+    CHECK(reading.hasNewAudio);
+    CHECK_NEAR(reading.inputPeak, 0.8f, 0.0);
+    CHECK_NEAR(reading.outputPeak, 0.4f, 0.0);
+    CHECK_NEAR(reading.gainReduction, 6.0f, 0.0);
+
+    // (0.64 * 100 + 0.04 * 300) / 400 = 0.19
+    CHECK_NEAR(reading.inputRms, std::sqrt(0.19f), 1e-6);
+    CHECK_NEAR(reading.outputRms, 0.5f * std::sqrt(0.19f), 1e-6);
+
+    // Taken: the next read starts afresh
+    reading = meter.read();
+    CHECK(! reading.hasNewAudio);
+    CHECK_NEAR(reading.inputPeak, 0.0f, 0.0);
+
+    meter.publish(constantBlock(0.1f, 50), 50, 0.0f);
+    reading = meter.read();
+    CHECK_NEAR(reading.inputPeak, 0.1f, 0.0);
+    CHECK_NEAR(reading.inputRms, 0.1f, 1e-6);
+}
+
+TEST_CASE("A concurrent reader sees every peak exactly once")
+{
+    LevelMeter meter;
+    std::atomic<bool> done { false };
+    std::atomic<int> reads { 0 };
+    constexpr int numBlocks = 200000;
+
+    // A few loud blocks among quiet ones; each must be reported by exactly
+    // one read however the reads and publishes interleave. After a spike
+    // the writer waits for a read to start, so no two share a read.
+    std::thread writer([&]
+    {
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            const auto spike = block % (numBlocks / 4) == 1000;
+            meter.publish(constantBlock(spike ? 1.0f : 0.1f, 64), 64, spike ? 12.0f : 1.0f);
+
+            if (spike)
+                for (const auto target = reads.load() + 2; reads.load() < target;)
+                    std::this_thread::yield();
+        }
+
+        done.store(true);
+    });
+
+    int spikesSeen = 0, reductionsSeen = 0;
+
+    for (;;)
+    {
+        const auto finished = done.load();
+        const auto reading = meter.read();
+        reads.fetch_add(1);
+
+        spikesSeen += reading.inputPeak == 1.0f ? 1 : 0;
+        reductionsSeen += reading.gainReduction == 12.0f ? 1 : 0;
+        CHECK(reading.inputPeak == 0.0f || reading.inputPeak == 0.1f || reading.inputPeak == 1.0f);
+
+        if (finished)
+            break;
+    }
+
+    writer.join();
+    CHECK(spikesSeen == 4);
+    CHECK(reductionsSeen == 4);
+}
+
+TEST_MAIN()
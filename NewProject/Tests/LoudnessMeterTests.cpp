@@ -0,0 +1,160 @@
+/*
+  ==============================================================================
+
+    LoudnessMeterTests.cpp
+
+    Level cases from EBU Tech 3341 (stereo 1 kHz sine, both channels).
+
+  ==============================================================================
+*/
+
+#include "TestHarness.h"
+#include "../Source/DSP/LoudnessMeter.h"
+
+#include <cmath>
+#include <vector>
+
+using autocomp::LoudnessMeter;
+
+namespace
+{
+    // Feeds seconds of a 1 kHz stereo sine at levelDb dBFS, continuing the phase
+    void feedSine(LoudnessMeter& meter, double& phase, float levelDb, double seconds, int blockSize = 480)
+    {
+        constexpr double sampleRate = 48000.0;
+        const auto amplitude = std::pow(10.0, levelDb / 20.0);
+        auto remaining = static_cast<int>(seconds * sampleRate);
+        std::vector<float> block((size_t) blockSize);
+        const float* channels[] = { block.data(), block.data() };
+
+        while (remaining > 0)
+        {
+            const auto count = std::min(remaining, blockSize);
+
+            for (int i = 0; i < count; ++i)
+            {
+                block[(size_t) i] = (float) (amplitude * std::sin(phase));
+                phase += 6.283185307179586 * 1000.0 / sampleRate;
+            }
+
+            meter.process(channels, 2, count);
+            remaining -= count;
+        }
+    }
+}
+
+TEST_CASE("Steady -23 dBFS tone reads -23 LUFS on every scale")
+{
+    LoudnessMeter meter;
+    meter.prepare(48000.0, 2);
+
+    double phase = 0.0;
+    feedSine(meter, phase, -23.0f, 20.0);
+
+    CHECK_NEAR(meter.getMomentary(), -23.0f, 0.1);
+    CHECK_NEAR(meter.getShortTerm(), -23.0f, 0.1);
+    CHECK_NEAR(meter.getIntegrated(), -23.0f, 0.1);
+}
+
+TEST_CASE("Absolute and relative gates ignore the quiet sections")
+{
+    LoudnessMeter meter;
+    meter.prepare(48000.0, 2);
+
+    // Tech 3341 case 4
+    double phase = 0.0;
+    feedSine(meter, phase, -72.0f, 10.0, 1000);
+    feedSine(meter, phase, -36.0f, 10.0, 1000);
+    feedSine(meter, phase, -23.0f, 60.0, 1000);
+    feedSine(meter, phase, -36.0f, 10.0, 1000);
+    feedSine(meter, phase, -72.0f, 10.0, 1000);
+
+    CHECK_NEAR(meter.getIntegrated(), -23.0f, 0.1);
+
+    meter.resetIntegrated();
+    CHECK_NEAR(meter.getIntegrated(), LoudnessMeter::floorLufs, 0.0);
+}
+
+TEST_CASE("Momentary and short-term windows fill at their own rates")
+{
+    LoudnessMeter meter;
+    meter.prepare(48000.0, 2);
+
+    double phase = 0.0;
+    feedSine(meter, phase, -20.0f, 0.4, 64);
+
+    // Full 400 ms window, 4 of 30 short-term hops
+    CHECK_NEAR(meter.getMomentary(), -20.0f, 0.2);
+    CHECK_NEAR(meter.getShortTerm(), -20.0f - 10.0f * std::log10(30.0f / 4.0f), 0.2);
+
+    feedSine(meter, phase, -20.0f, 2.6, 64);
+    CHECK_NEAR(meter.getShortTerm(), -20.0f, 0.1);
+}
+
+TEST_CASE("K-weighting removes DC and channel weights apply")
+{
+    LoudnessMeter meter;
+    meter.prepare(44100.0, 2);
+
+    std::vector<float> dc(44100, 0.5f), silence(44100, 0.0f);
+    const float* channels[] = { dc.data(), silence.data() };
+    meter.process(channels, 2, 44100);
+    CHECK(meter.getMomentary() < -70.0f);
+
+    // One channel at 0 dB weight vs. the same tone with a surround weight
+    LoudnessMeter front, surround;
+    front.prepare(48000.0, 1);
+    surround.prepare(48000.0, 1);
+    surround.setChannelWeight(0, 1.41f);
+
+    double phaseA = 0.0, phaseB = 0.0;
+    feedSine(front, phaseA, -20.0f, 1.0);
+    feedSine(surround, phaseB, -20.0f, 1.0);
+    CHECK_NEAR(surround.getMomentary() - front.getMomentary(), 10.0f * std::log10(1.41f), 0.01);
+}
+
+TEST_CASE("Channels filtered as lanes read the same as one at a time")
+{
+    // 2 channels: one padded group; 6 (5.1): a full group and a padded one
+    for (int numChannels : { 2, 6 })
+    {
+        constexpr int numSamples = 48000;
+        const float weights[] = { 1.0f, 1.0f, 1.0f, 0.0f, 1.41f, 1.41f };
+        std::vector<std::vector<float>> audio((size_t) numChannels, std::vector<float>(numSamples));
+        const float* channels[6];
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            for (int i = 0; i < numSamples; ++i)
+                audio[(size_t) ch][(size_t) i] = (0.1f + 0.1f * (float) ch) * std::sin((0.02f + 0.03f * (float) ch) * (float) i);
+
+            channels[ch] = audio[(size_t) ch].data();
+        }
+
+        LoudnessMeter meter;
+        meter.prepare(48000.0, numChannels);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            meter.setChannelWeight(ch, weights[ch]);
+
+        meter.process(channels, numChannels, numSamples);
+
+        // The weighted energies add up across channels
+        double energy = 0.0;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            LoudnessMeter single;
+            single.prepare(48000.0, 1);
+            single.setChannelWeight(0, weights[ch]);
+            single.process(&channels[ch], 1, numSamples);
+
+            if (single.getMomentary() > LoudnessMeter::floorLufs)
+                energy += std::pow(10.0, (single.getMomentary() + 0.691) / 10.0);
+        }
+
+        CHECK_NEAR(meter.getMomentary(), LoudnessMeter::energyToLufs(energy), 0.001);
+    }
+}
+
+TEST_MAIN()
@@ -0,0 +1,170 @@
+/*
+  ==============================================================================
+
+    MultibandCompressorTests.cpp
+
+  ==============================================================================
+*/
+
+#include "TestHarness.h"
+#include "../Source/DSP/MultibandCompressor.h"
+
+#include <cmath>
+#include <vector>
+
+using autocomp::BandParameters;
+using Crossover = autocomp::Crossover<float>;
+using autocomp::LinkGroups;
+using autocomp::MultibandCompressor;
+
+namespace
+{
+    constexpr double twoPi = 6.283185307179586;
+    constexpr double sampleRate = 48000.0;
+    constexpr float fourBands[] = { 150.0f, 1000.0f, 6000.0f };
+
+    // Splits a sine and returns the steady-state amplitude of each band and
+    // of their sum (last element)
+    std::vector<double> bandAmplitudes(int numBands, double frequency)
+    {
+        Crossover crossover;
+        crossover.prepare(1);
+        crossover.setFrequencies(numBands, fourBands, sampleRate);
+
+        constexpr int length = 48000;
+        std::vector<float> input(length);
+        std::vector<std::vector<float>> bands(static_cast<size_t>(numBands), std::vector<float>(length));
+        float* outputs[Crossover::maxBands];
+
+        for (int i = 0; i < length; ++i)
+            input[static_cast<size_t>(i)] = static_cast<float>(std::sin(twoPi * frequency * i / sampleRate));
+
+        for (int band = 0; band < numBands; ++band)
+            outputs[band] = bands[static_cast<size_t>(band)].data();
+
+        crossover.process(0, input.data(), outputs, length);
+
+        // Amplitude from the RMS over whole seconds, so the sample phase doesn't matter
+        std::vector<double> sumSquares(static_cast<size_t>(numBands + 1), 0.0);
+
+        for (size_t i = length / 2; i < length; ++i)
+        {
+            double sum = 0.0;
+
+            for (size_t band = 0; band < static_cast<size_t>(numBands); ++band)
+            {
+                sumSquares[band] += static_cast<double>(bands[band][i]) * bands[band][i];
+                sum += bands[band][i];
+            }
+
+            sumSquares.back() += sum * sum;
+        }
+
+        for (auto& amplitude : sumSquares)
+            amplitude = std::sqrt(2.0 * amplitude / (length / 2));
+
+        return sumSquares;
+    }
+
+    BandParameters parametersFor(float thresholdDb, float ratio)
+    {
+        BandParameters parameters;
+
+        for (size_t band = 0; band < static_cast<size_t>(Crossover::maxBands); ++band)
+        {
+            parameters.thresholdLog2[band] = thresholdDb / 6.0206f;
+            parameters.slope[band] = 1.0f / ratio - 1.0f;
+            parameters.attack[band] = 0.99f;
+            parameters.release[band] = 0.999f;
+            parameters.makeup[band] = 1.0f;
+        }
+
+        return parameters;
+    }
+}
+
+TEST_CASE("Crossover bands sum to a flat magnitude")
+{
+    for (int numBands : { 2, 3, 4 })
+        for (double frequency : { 40.0, 150.0, 440.0, 1000.0, 3000.0, 6000.0, 15000.0 })
+            CHECK_NEAR(bandAmplitudes(numBands, frequency).back(), 1.0, 0.002);
+}
+
+TEST_CASE("Crossover puts a tone in its own band")
+{
+    // Well inside a band: the others are at least 30 dB down
+    const auto low = bandAmplitudes(4, 40.0);
+    CHECK(low[0] > 0.99);
+    CHECK(low[1] < 0.03 && low[2] < 0.03 && low[3] < 0.03);
+
+    const auto mid = bandAmplitudes(4, 2500.0);
+    CHECK(mid[2] > 0.9);
+    CHECK(mid[0] < 0.03);
+
+    const auto high = bandAmplitudes(4, 20000.0);
+    CHECK(high[3] > 0.99);
+    CHECK(high[0] < 0.03 && high[1] < 0.03);
+
+    // At a crossover both neighbours are at -6 dB
+    const auto edge = bandAmplitudes(4, 1000.0);
+    CHECK_NEAR(edge[1], 0.5, 0.05);
+    CHECK_NEAR(edge[2], 0.5, 0.05);
+}
+
+TEST_CASE("Only the band with the energy is compressed")
+{
+    MultibandCompressor compressor;
+    compressor.prepare(2, 512, 0);
+    compressor.setProcessingRate(sampleRate, 960);
+    compressor.setLayout(4, fourBands);
+    compressor.setParameters(parametersFor(-20.0f, 4.0f), false);
+
+    std::vector<float> left(512), right(512);
+    float* channels[] = { left.data(), right.data() };
+    auto phase = 0.0;
+
+    for (int block = 0; block < 200; ++block)
+    {
+        for (size_t i = 0; i < 512; ++i, ++phase)
+        {
+            // Loud bass, quiet treble
+            left[i] = right[i] = static_cast<float>(0.5 * std::sin(twoPi * 60.0 * phase / sampleRate)
+                                                  + 0.01 * std::sin(twoPi * 12000.0 * phase / sampleRate));
+        }
+
+        compressor.computeGains(channels, 2, 512, LinkGroups::linked());
+        compressor.applyGains(channels, 2, 512, LinkGroups::linked());
+    }
+
+    CHECK(compressor.getEnvelope(0) < 0.5f);
+    CHECK_NEAR(compressor.getEnvelope(1), 1.0f, 1e-3);
+    CHECK_NEAR(compressor.getEnvelope(2), 1.0f, 1e-3);
+    CHECK_NEAR(compressor.getEnvelope(3), 1.0f, 1e-3);
+}
+
+TEST_CASE("Unlinked bands keep per-channel envelopes")
+{
+    MultibandCompressor compressor;
+    compressor.prepare(2, 256, 0);
+    compressor.setProcessingRate(sampleRate, 960);
+    compressor.setLayout(3, fourBands);
+    compressor.setParameters(parametersFor(-20.0f, 4.0f), false);
+
+    std::vector<float> left(256), right(256, 0.0f);
+    float* channels[] = { left.data(), right.data() };
+
+    for (int block = 0; block < 200; ++block)
+    {
+        for (size_t i = 0; i < 256; ++i)
+            left[i] = static_cast<float>(0.5 * std::sin(twoPi * 60.0 * static_cast<double>(block * 256 + static_cast<int>(i)) / sampleRate));
+
+        std::fill(right.begin(), right.end(), 0.0f);
+        compressor.computeGains(channels, 2, 256, LinkGroups::unlinked());
+        compressor.applyGains(channels, 2, 256, LinkGroups::unlinked());
+    }
+
+    CHECK(compressor.getEnvelope(0, 0) < 0.5f);
+    CHECK_NEAR(compressor.getEnvelope(0, 1), 1.0f, 1e-6);
+}
+
+TEST_MAIN()
@@ -0,0 +1,161 @@
+/*
+  ==============================================================================
+
+    OversamplerTests.cpp
+
+  ==============================================================================
+*/
+
+#include "TestHarness.h"
+#include "../Source/DSP/Oversampler.h"
+
+#include <cmath>
+#include <vector>
+
+using Oversampler = autocomp::Oversampler<float>;
+
+namespace
+{
+    constexpr double twoPi = 6.283185307179586;
+
+    // Amplitude of the component at frequency (cycles per sample) in signal
+    double amplitudeAt(const std::vector<float>& signal, size_t start, double frequency)
+    {
+        double re = 0.0, im = 0.0;
+        const auto length = signal.size() - start;
+
+        for (size_t i = start; i < signal.size(); ++i)
+        {
+            // Hann window keeps the leakage of the other components down
+            const auto window = 0.5 - 0.5 * std::cos(twoPi * (double) (i - start) / (double) length);
+            re += window * signal[i] * std::cos(twoPi * frequency * (double) i);
+            im += window * signal[i] * std::sin(twoPi * frequency * (double) i);
+        }
+
+        return 4.0 * std::sqrt(re * re + im * im) / (double) length;
+    }
+}
+
+TEST_CASE("Factor switches and reports its latency")
+{
+    Oversampler oversampler;
+    oversampler.prepare(2, 256);
+
+    CHECK(oversampler.getFactor() == 1);
+    CHECK_NEAR(oversampler.getLatencyInSamples(), 0.0, 0.0);
+
+    CHECK(oversampler.setFactor(2));
+    CHECK(! oversampler.setFactor(2));
+    CHECK(! oversampler.setFactor(3));
+    CHECK(oversampler.getFactor() == 2);
+    CHECK_NEAR(oversampler.getLatencyInSamples(), 23.0, 0.0);
+
+    CHECK(oversampler.setFactor(4));
+    CHECK_NEAR(oversampler.getLatencyInSamples(), 28.5, 0.0);
+}
+
+TEST_CASE("Round trip is a pure delay in the pass band")
+{
+    for (int factor : { 1, 2 })
+    {
+        Oversampler oversampler;
+        oversampler.prepare(1, 100);
+        oversampler.setFactor(factor);
+
+        const auto latency = (int) oversampler.getLatencyInSamples();
+        std::vector<float> input(4000), output(4000);
+
+        for (size_t i = 0; i < input.size(); ++i)
+            input[i] = 0.5f * (float) (std::sin(twoPi * 0.02 * (double) i) + 0.5 * std::sin(twoPi * 0.17 * (double) i));
+
+        for (int offset = 0; offset < 4000; offset += 100)
+        {
+            const float* in[] = { input.data() + offset };
+            float* out[] = { output.data() + offset };
+            oversampler.upsample(in, 1, 100);
+            oversampler.downsample(out, 1, 100);
+        }
+
+        auto maxError = 0.0f;
+
+        for (size_t i = 200; i < output.size(); ++i)
+            maxError = std::max(maxError, std::abs(output[i] - input[i - (size_t) latency]));
+
+        CHECK(maxError < 2e-3f);
+    }
+}
+
+TEST_CASE("Double precision runs the same filters")
+{
+    Oversampler single;
+    autocomp::Oversampler<double> wide;
+
+    single.prepare(1, 64);
+    wide.prepare(1, 64);
+    single.setFactor(4);
+    wide.setFactor(4);
+    CHECK_NEAR(wide.getLatencyInSamples(), single.getLatencyInSamples(), 0.0);
+
+    std::vector<float> input(64), output(64);
+    std::vector<double> wideInput(64), wideOutput(64);
+    auto maxDifference = 0.0;
+
+    for (int block = 0; block < 20; ++block)
+    {
+        for (size_t i = 0; i < 64; ++i)
+        {
+            wideInput[i] = 0.7 * std::sin(twoPi * 0.031 * static_cast<double>(block * 64 + static_cast<int>(i)));
+            input[i] = static_cast<float>(wideInput[i]);
+        }
+
+        const float* in[] = { input.data() };
+        float* out[] = { output.data() };
+        single.upsample(in, 1, 64);
+        single.downsample(out, 1, 64);
+
+        const double* wideIn[] = { wideInput.data() };
+        double* wideOut[] = { wideOutput.data() };
+        wide.upsample(wideIn, 1, 64);
+        wide.downsample(wideOut, 1, 64);
+
+        for (size_t i = 0; i < 64; ++i)
+            maxDifference = std::max(maxDifference, std::abs(wideOutput[i] - output[i]));
+    }
+
+    // Float rounding only: the double path is the same response, not a
+    // different filter
+    CHECK(maxDifference < 1e-5);
+}
+
+TEST_CASE("Upsampling rejects the images")
+{
+    for (int factor : { 2, 4 })
+    {
+        Oversampler oversampler;
+        oversampler.prepare(1, 512);
+        oversampler.setFactor(factor);
+
+        // 15 kHz at 48 kHz; the first image sits at 33 kHz
+        const auto frequency = 15000.0 / 48000.0;
+        std::vector<float> input(512), upsampled;
+
+        for (int block = 0; block < 16; ++block)
+        {
+            for (int i = 0; i < 512; ++i)
+                input[(size_t) i] = (float) std::sin(twoPi * frequency * (double) (block * 512 + i));
+
+            const float* in[] = { input.data() };
+            const auto* out = oversampler.upsample(in, 1, 512)[0];
+            upsampled.insert(upsampled.end(), out, out + 512 * factor);
+        }
+
+        const auto start = (size_t) (1024 * factor);
+        const auto wanted = amplitudeAt(upsampled, start, frequency / factor);
+        const auto image = amplitudeAt(upsampled, start, (1.0 - frequency) / factor);
+
+        CHECK_NEAR(wanted, 1.0, 0.01);
+        CHECK(20.0 * std::log10(image / wanted) < -60.0);
+    }
+}
+
+TEST_MAIN()
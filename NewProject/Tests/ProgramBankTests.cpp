@@ -0,0 +1,228 @@
+/*
+  ==============================================================================
+
+    ProgramBankTests.cpp
+
+  ==============================================================================
+*/
+
+#include "TestHarness.h"
+#include "../Source/DSP/CompressorEngine.h"
+#include "../Source/DSP/ProgramBank.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+using autocomp::CompressorEngine;
+using autocomp::CompressorSettings;
+using autocomp::ProgramBank;
+
+namespace presets = autocomp::presets;
+
+TEST_CASE("Factory programs are the compression levels")
+{
+    const ProgramBank bank;
+    CHECK(ProgramBank::numFactoryPrograms == CompressorEngine::numCompressionLevels);
+
+    for (int i = 0; i < ProgramBank::numFactoryPrograms; ++i)
+    {
+        CompressorSettings settings;
+        CHECK(bank.getSettings(i, settings));
+        CHECK(settings == presets::compressionLevels[static_cast<size_t>(i)]);
+        CHECK(std::string(bank.getName(i)).size() > 0);
+    }
+
+    CHECK(std::string(bank.getName(2)) == "Medium");
+    CHECK(std::string(bank.getName(ProgramBank::numFactoryPrograms)) == "User 1");
+    CHECK(std::string(bank.getName(ProgramBank::numPrograms)).empty());
+    CHECK(std::string(bank.getName(-1)).empty());
+}
+
+TEST_CASE("Only user programs can be stored and renamed")
+{
+    ProgramBank bank;
+    const CompressorSettings settings { -12.0f, 3.0f, 7.0f, 250.0f, 1.5f };
+    const auto user = ProgramBank::numFactoryPrograms + 3;
+
+    CHECK(! bank.store(0, settings));
+    CHECK(! bank.rename(0, "Mine"));
+    CHECK(std::string(bank.getName(0)) == "Very Gentle");
+
+    CHECK(bank.store(user, settings));
+    CHECK(bank.rename(user, "Chorus vocal"));
+
+    CompressorSettings read;
+    CHECK(bank.getSettings(user, read));
+    CHECK(read == settings);
+    CHECK(std::string(bank.getName(user)) == "Chorus vocal");
+    CHECK(! bank.getSettings(ProgramBank::numPrograms, read));
+
+    CHECK(bank.setCurrent(user));
+    CHECK(bank.getCurrent() == user);
+    CHECK(! bank.setCurrent(ProgramBank::numPrograms));
+    CHECK(bank.getCurrent() == user);
+}
+
+TEST_CASE("Storing, renaming and loading count as changes; selecting doesn't")
+{
+    ProgramBank bank;
+    const auto user = ProgramBank::numFactoryPrograms;
+    auto changes = bank.getChangeCount();
+
+    CHECK(bank.setCurrent(user));
+    CHECK(! bank.store(0, {}));
+    CHECK(! bank.rename(0, "Mine"));
+    CHECK(bank.getChangeCount() == changes);
+
+    CHECK(bank.store(user, { -12.0f, 3.0f, 7.0f, 250.0f, 1.5f }));
+    CHECK(bank.getChangeCount() != changes);
+    changes = bank.getChangeCount();
+
+    CHECK(bank.rename(user, "Mine"));
+    CHECK(bank.getChangeCount() != changes);
+    changes = bank.getChangeCount();
+
+    std::vector<std::uint8_t> data(ProgramBank::serialisedSize);
+    bank.write(data.data(), data.size());
+    CHECK(! bank.read(data.data(), 4));
+    CHECK(bank.getChangeCount() == changes);
+
+    CHECK(bank.read(data.data(), data.size()));
+    CHECK(bank.getChangeCount() != changes);
+}
+
+TEST_CASE("Long names are cut at a character boundary")
+{
+    ProgramBank bank;
+    const auto user = ProgramBank::numFactoryPrograms;
+
+    // 30 ASCII bytes, then a 3-byte character that would straddle the limit
+    const std::string name = std::string(30, 'a') + "\xea\xb0\x80" + "tail";
+    CHECK(bank.rename(user, name.c_str()));
+    CHECK(std::string(bank.getName(user)) == std::string(30, 'a'));
+
+    CHECK(bank.rename(user, std::string(40, 'b').c_str()));
+    CHECK(std::string(bank.getName(user)).size() == ProgramBank::maxNameLength);
+}
+
+TEST_CASE("The user bank survives a save and load")
+{
+    ProgramBank saved;
+
+    for (int i = 0; i < ProgramBank::numUserPrograms; ++i)
+    {
+        const auto index = ProgramBank::numFactoryPrograms + i;
+        saved.store(index, { -40.0f + i, 1.0f + i, 0.5f * i, 60.0f + i, 0.25f * i });
+        saved.rename(index, ("Program " + std::to_string(i)).c_str());
+    }
+
+    saved.setCurrent(ProgramBank::numFactoryPrograms + 2);
+
+    std::vector<std::uint8_t> data(ProgramBank::serialisedSize);
+    CHECK(saved.write(data.data(), data.size()) == data.size());
+
+    ProgramBank loaded;
+    CHECK(loaded.read(data.data(), data.size()));
+    CHECK(loaded.getCurrent() == saved.getCurrent());
+
+    for (int index = 0; index < ProgramBank::numPrograms; ++index)
+    {
+        CompressorSettings expected, actual;
+        saved.getSettings(index, expected);
+        loaded.getSettings(index, actual);
+        CHECK(actual == expected);
+        CHECK(std::string(loaded.getName(index)) == saved.getName(index));
+    }
+}
+
+TEST_CASE("A damaged bank leaves the programs alone")
+{
+    ProgramBank saved;
+    saved.store(ProgramBank::numFactoryPrograms, { -1.0f, 20.0f, 1.0f, 5.0f, 9.0f });
+
+    std::vector<std::uint8_t> data(ProgramBank::serialisedSize);
+    saved.write(data.data(), data.size());
+    CHECK(saved.write(data.data(), data.size() - 1) == 0);
+
+    const ProgramBank fresh;
+    CompressorSettings before;
+    fresh.getSettings(ProgramBank::numFactoryPrograms, before);
+
+    auto check = [&](const std::vector<std::uint8_t>& bytes, size_t size)
+    {
+        ProgramBank loaded;
+        CHECK(! loaded.read(bytes.data(), size));
+
+        CompressorSettings after;
+        loaded.getSettings(ProgramBank::numFactoryPrograms, after);
+        CHECK(after == before);
+    };
+
+    check(data, data.size() - 1);
+    check(data, 4);
+
+    auto corrupt = data;
+    corrupt[20] ^= 1;
+    check(corrupt, corrupt.size());
+
+    auto newer = data;
+    newer[4] = ProgramBank::version + 1;
+    check(newer, newer.size());
+
+    ProgramBank loaded;
+    CHECK(! loaded.read(nullptr, 0));
+}
+
+TEST_CASE("Switching programs glides instead of stepping")
+{
+    // Constant input, so any output step is a gain step (a click)
+    auto largestStep = [](bool glide)
+    {
+        CompressorEngine engine;
+        engine.prepare(48000.0, 256, 1);
+
+        const ProgramBank bank;
+        CompressorSettings gentle, strong;
+        bank.getSettings(0, gentle);
+        bank.getSettings(ProgramBank::numFactoryPrograms - 1, strong);
+        engine.setSettings(gentle);
+
+        std::vector<float> audio(256);
+        float* channels[] = { audio.data() };
+        float previous = 0.0f, step = 0.0f;
+
+        for (int block = 0; block < 200; ++block)
+        {
+            if (block == 100)
+            {
+                if (glide)
+                    engine.setTargetSettings(strong);
+                else
+                    engine.setSettings(strong);
+            }
+
+            std::fill(audio.begin(), audio.end(), 0.5f);
+            engine.compress(channels, 1, 256);
+
+            for (auto sample : audio)
+            {
+                if (block >= 100)
+                    step = std::max(step, std::abs(sample - previous));
+
+                previous = sample;
+            }
+        }
+
+        return step;
+    };
+
+    const auto glided = largestStep(true);
+    const auto jumped = largestStep(false);
+
+    CHECK(glided < 0.001f);
+    CHECK(jumped > 10.0f * glided);
+}
+
+TEST_MAIN()
@@ -0,0 +1,318 @@
+/*
+  ==============================================================================
+
+    RealtimeSafetyTests.cpp
+
+    Built with CUMPRESSOR_REALTIME_CHECKS=1. Runs the engine through the
+    same per-block calls as the plugin's processBlock, with every mode,
+    layout, precision and latency setting changing under it, and fails on
+    any allocation or lock inside the block.
+
+  ==============================================================================
+*/
+
+#include "TestHarness.h"
+#include "../Source/DSP/AnalysisWorker.h"
+#include "../Source/DSP/CompressorEngine.h"
+#include "../Source/DSP/RealtimeCheck.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using autocomp::AnalysisWorker;
+using autocomp::CompressorEngine;
+using autocomp::LinkGroups;
+using autocomp::StereoLink;
+
+namespace realtime = autocomp::realtime;
+
+namespace
+{
+    std::vector<int>* volatile allocationSink = nullptr;
+
+    struct Random
+    {
+        std::uint32_t state = 0x2545f491u;
+
+        std::uint32_t next() noexcept
+        {
+            state = state * 1664525u + 1013904223u;
+            return state >> 8;
+        }
+
+        int below(int limit) noexcept { return static_cast<int>(next() % static_cast<std::uint32_t>(limit)); }
+        float uniform() noexcept { return static_cast<float>(next()) / 16777216.0f; }
+    };
+
+    enum Mode { autoMode, levelMode, customMode, bypassed, numModes };
+
+    struct Layout
+    {
+        const char* name;
+        int numChannels;
+        std::vector<int> groups;    // empty: linked/unlinked picked per block
+    };
+
+    const Layout layouts[] = {
+        { "mono", 1, {} },
+        { "stereo", 2, {} },
+        { "5.1", 6, { 0, 0, 0, LinkGroups::excluded, 1, 1 } },
+        { "7.1", 8, { 0, 0, 0, LinkGroups::excluded, 1, 1, 1, 1 } },
+        { "7.1.4", 12, { 0, 0, 0, LinkGroups::excluded, 1, 1, 1, 1, 2, 2, 2, 2 } }
+    };
+
+    // The parameters processBlock reads from the host, changed at random
+    struct Parameters
+    {
+        int mode = autoMode, level = 2, oversampling = 1, bands = 1;
+        float lookahead = 0.0f, highPass = 0.0f;
+        bool unlinked = false, sidechain = false;
+
+        void mutate(Random& random)
+        {
+            static constexpr int factors[] = { 1, 2, 4 };
+            static constexpr int bandCounts[] = { 1, 3, 4 };
+            static constexpr float lookaheads[] = { 0.0f, 2.5f, CompressorEngine::maxLookaheadMs };
+
+            if (random.below(6) == 0) mode = random.below(numModes);
+            if (random.below(6) == 0) level = random.below(CompressorEngine::numCompressionLevels);
+            if (random.below(12) == 0) oversampling = factors[random.below(3)];
+            if (random.below(12) == 0) bands = bandCounts[random.below(3)];
+            if (random.below(12) == 0) lookahead = lookaheads[random.below(3)];
+            if (random.below(8) == 0) highPass = random.below(2) == 0 ? 0.0f : 80.0f + 200.0f * random.uniform();
+            if (random.below(8) == 0) unlinked = ! unlinked;
+            if (random.below(8) == 0) sidechain = ! sidechain;
+        }
+    };
+
+    // One block the way the plugin's process() does it, checked
+    template <typename SampleType>
+    void processBlock(CompressorEngine& engine, const Parameters& parameters, const LinkGroups* groups,
+                      SampleType* const* channels, int numChannels, const SampleType* const* sidechain, int numSamples)
+    {
+        const realtime::ScopedCheck check;
+
+        engine.beginBlock();
+        engine.setOversamplingFactor(parameters.oversampling);
+        engine.setLookahead(parameters.lookahead);
+        engine.setNumBands(parameters.bands);
+
+        engine.setLoudnessTarget(-14.0f);
+        engine.analyzeAudioLevel(channels, numChannels, numSamples);
+
+        if (parameters.mode == bypassed)
+        {
+            engine.bypass(channels, numChannels, numSamples);
+            return;
+        }
+
+        if (parameters.mode == autoMode)
+            engine.applyAutoParameters();
+        else if (parameters.mode == levelMode)
+            engine.setTargetCompressionLevel(parameters.level);
+        else
+            engine.setTargetSettings({ -30.0f + 20.0f * parameters.highPass / 300.0f, 4.0f, 3.0f, 80.0f, 2.0f });
+
+        engine.setDetectorHighPass(parameters.highPass);
+
+        if (groups != nullptr)
+            engine.setLinkGroups(*groups);
+        else
+            engine.setStereoLink(parameters.unlinked ? StereoLink::unlinked : StereoLink::linked);
+
+        if (parameters.sidechain)
+            engine.compress(channels, numChannels, numSamples, sidechain, 2);
+        else
+            engine.compress(channels, numChannels, numSamples);
+    }
+
+    // Prepares outside the check, then processes a few hundred blocks of
+    // random length and parameters. A second thread plays the editor and
+    // message thread, using the lock-free handoffs and the meter while the
+    // audio runs.
+    template <typename SampleType>
+    void stress(const Layout& layout, bool backgroundAnalysis)
+    {
+        constexpr int maximumBlockSize = 512;
+        constexpr int numBlocks = 300;
+
+        auto engine = std::make_unique<CompressorEngine>();
+        engine->prepare(48000.0, maximumBlockSize, layout.numChannels, std::is_same_v<SampleType, double>);
+
+        LinkGroups groups;
+
+        if (! layout.groups.empty())
+            groups.assign(layout.groups.data(), layout.numChannels);
+
+        std::vector<std::vector<SampleType>> audio(static_cast<size_t>(layout.numChannels),
+                                                   std::vector<SampleType>(maximumBlockSize));
+        std::vector<std::vector<SampleType>> sidechain(2, std::vector<SampleType>(maximumBlockSize));
+        std::vector<SampleType*> channels;
+        std::vector<const SampleType*> sidechainChannels;
+
+        for (auto& channel : audio)
+            channels.push_back(channel.data());
+
+        for (auto& channel : sidechain)
+            sidechainChannels.push_back(channel.data());
+
+        engine->setMetering(true);
+        AnalysisWorker worker(*engine);
+
+        if (backgroundAnalysis)
+            worker.start();
+
+        std::atomic<bool> running { true };
+        std::thread messageThread([&]
+        {
+            for (int i = 0; running.load(); ++i)
+            {
+                engine->requestCompressionLevel(i % CompressorEngine::numCompressionLevels);
+                engine->getActiveSettings();
+                engine->getLoudness();
+                engine->readLevels();
+
+                if (i % 64 == 0)
+                    engine->resetIntegratedLoudness();
+
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        });
+
+        Random random;
+        Parameters parameters;
+        realtime::clearViolations();
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            parameters.mutate(random);
+
+            const auto numSamples = 1 + random.below(maximumBlockSize);
+            const auto silent = random.below(10) == 0;
+            const auto gain = 0.05f + random.uniform();
+
+            for (auto& channel : audio)
+                for (int i = 0; i < numSamples; ++i)
+                    channel[static_cast<size_t>(i)] = silent ? SampleType() : static_cast<SampleType>(gain * (random.uniform() - 0.5f));
+
+            for (auto& channel : sidechain)
+                for (int i = 0; i < numSamples; ++i)
+                    channel[static_cast<size_t>(i)] = static_cast<SampleType>(random.uniform() - 0.5f);
+
+            processBlock(*engine, parameters, layout.groups.empty() ? nullptr : &groups, channels.data(),
+                         layout.numChannels, sidechainChannels.data(), numSamples);
+        }
+
+        running.store(false);
+        messageThread.join();
+        worker.stop();
+
+        if (realtime::getNumViolations() > 0)
+            std::printf("  %s, %s, %s analysis:\n%s", layout.name, std::is_same_v<SampleType, double> ? "double" : "float",
+                        backgroundAnalysis ? "background" : "inline", realtime::describeViolations().c_str());
+
+        CHECK(realtime::getNumViolations() == 0);
+    }
+}
+
+//==============================================================================
+TEST_CASE("Allocations inside a check are recorded with their call stack")
+{
+    realtime::clearViolations();
+
+    {
+        const realtime::ScopedCheck check;
+        allocationSink = new std::vector<int>(64);
+    }
+
+    CHECK(realtime::getNumViolations() == 2);   // the vector and its storage
+
+    delete allocationSink;
+    CHECK(realtime::getNumViolations() == 2);   // outside the check
+
+    const auto report = realtime::describeViolations();
+    CHECK(report.find("operator new") != std::string::npos);
+
+#if defined(__GLIBC__)
+    CHECK(report.find("RealtimeSafetyTests") != std::string::npos);
+#endif
+}
+
+TEST_CASE("Frees and locks inside a check are recorded")
+{
+    allocationSink = new std::vector<int>(64);
+    realtime::clearViolations();
+
+    {
+        const realtime::ScopedCheck check;
+        delete allocationSink;
+    }
+
+    CHECK(realtime::getNumViolations() == 2);
+
+#if defined(__GLIBC__)
+    std::mutex mutex;
+    realtime::clearViolations();
+
+    {
+        const realtime::ScopedCheck check;
+        const std::lock_guard<std::mutex> lock(mutex);
+    }
+
+    CHECK(realtime::getNumViolations() == 1);
+    CHECK(realtime::describeViolations().find("pthread_mutex_lock") != std::string::npos);
+#endif
+}
+
+TEST_CASE("Other threads are not checked")
+{
+    std::atomic<int> step { 0 };
+
+    std::thread other([&]
+    {
+        while (step.load() != 1)
+            std::this_thread::yield();
+
+        std::vector<int> unchecked(1024);
+        step.store(2);
+    });
+
+    realtime::clearViolations();
+
+    {
+        const realtime::ScopedCheck check;
+        step.store(1);
+
+        while (step.load() != 2)
+            std::this_thread::yield();
+    }
+
+    other.join();
+    CHECK(realtime::getNumViolations() == 0);
+}
+
+TEST_CASE("processBlock never allocates or locks: float")
+{
+    for (const auto& layout : layouts)
+    {
+        stress<float>(layout, true);
+        stress<float>(layout, false);
+    }
+}
+
+TEST_CASE("processBlock never allocates or locks: double")
+{
+    for (const auto& layout : layouts)
+    {
+        stress<double>(layout, true);
+        stress<double>(layout, false);
+    }
+}
+
+TEST_MAIN()
@@ -0,0 +1,196 @@
+/*
+  ==============================================================================
+
+    SimdKernelsTests.cpp
+
+  ==============================================================================
+*/
+
+#include "TestHarness.h"
+#include "../Source/DSP/SimdKernels.h"
+
+#include <vector>
+
+using namespace autocomp;
+
+namespace
+{
+    float testSignal(int channel, int index)
+    {
+        return std::sin(0.37f * (float) index + (float) channel) * (channel % 2 == 0 ? 1.0f : -0.7f);
+    }
+}
+
+TEST_CASE("absMaxAcrossChannels matches the scalar reference")
+{
+    std::printf("  instruction set: %s\n", simd::instructionSet);
+
+    for (int numChannels : { 1, 2, 3, 6, 12 })
+    {
+        // Lengths around every vector width, plus an unaligned offset
+        for (int numSamples : { 0, 1, 3, 4, 5, 7, 8, 9, 15, 16, 17, 63, 64 })
+        {
+            const int offset = 3;
+            std::vector<std::vector<float>> data(numChannels, std::vector<float>(numSamples + offset));
+            std::vector<const float*> pointers;
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                for (int i = 0; i < numSamples + offset; ++i)
+                    data[ch][i] = testSignal(ch, i);
+
+                pointers.push_back(data[ch].data());
+            }
+
+            std::vector<float> result(numSamples + 1, -1.0f);
+            simd::absMaxAcrossChannels(pointers.data(), numChannels, offset, result.data(), numSamples);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                auto expected = 0.0f;
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                    expected = std::max(expected, std::abs(data[ch][offset + i]));
+
+                CHECK_NEAR(result[i], expected, 0.0);
+            }
+
+            CHECK_NEAR(result[numSamples], -1.0f, 0.0); // nothing written past the end
+        }
+    }
+}
+
+TEST_CASE("multiply matches the scalar reference")
+{
+    for (int numSamples : { 0, 1, 5, 8, 13, 64, 67 })
+    {
+        std::vector<float> dest(numSamples), gain(numSamples), expected(numSamples);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            dest[i] = testSignal(0, i);
+            gain[i] = 0.5f + 0.01f * (float) i;
+            expected[i] = dest[i] * gain[i];
+        }
+
+        simd::multiply(dest.data(), gain.data(), numSamples);
+
+        for (int i = 0; i < numSamples; ++i)
+            CHECK_NEAR(dest[i], expected[i], 0.0);
+    }
+}
+
+TEST_CASE("Double-precision kernels match the scalar reference")
+{
+    for (int numChannels : { 1, 2, 5 })
+    {
+        for (int numSamples : { 0, 1, 3, 4, 5, 8, 9, 31 })
+        {
+            const int offset = 1;
+            std::vector<std::vector<double>> data(numChannels, std::vector<double>(numSamples + offset));
+            std::vector<const double*> pointers;
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                for (int i = 0; i < numSamples + offset; ++i)
+                    data[ch][i] = testSignal(ch, i) + 1e-10 * i;
+
+                pointers.push_back(data[ch].data());
+            }
+
+            std::vector<float> levels(numSamples + 1, -1.0f);
+            simd::absMaxAcrossChannels(pointers.data(), numChannels, offset, levels.data(), numSamples);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                auto expected = 0.0;
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                    expected = std::max(expected, std::abs(data[ch][offset + i]));
+
+                CHECK_NEAR(levels[i], static_cast<float>(expected), 0.0);
+            }
+
+            CHECK_NEAR(levels[numSamples], -1.0f, 0.0);
+
+            // The gain is widened, the audio keeps its double precision
+            std::vector<double> dest(data[0].begin() + offset, data[0].end());
+            std::vector<float> gain(numSamples);
+
+            for (int i = 0; i < numSamples; ++i)
+                gain[i] = 0.5f + 0.01f * (float) i;
+
+            simd::multiply(dest.data(), gain.data(), numSamples);
+
+            for (int i = 0; i < numSamples; ++i)
+                CHECK_NEAR(dest[i], data[0][offset + i] * static_cast<double>(gain[i]), 1e-12);
+        }
+    }
+}
+
+TEST_CASE("accumulatePeakAndPower matches the scalar reference")
+{
+    for (int numSamples : { 0, 1, 3, 4, 5, 7, 8, 9, 17, 64, 100 })
+    {
+        std::vector<float> data(numSamples);
+        std::vector<double> wide(numSamples);
+
+        for (int i = 0; i < numSamples; ++i)
+            wide[i] = data[i] = testSignal(1, i);
+
+        auto expectedPeak = 0.25f;      // carried in from an earlier slice
+        auto expectedSquares = 2.0;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            expectedPeak = std::max(expectedPeak, std::abs(data[i]));
+            expectedSquares += static_cast<double>(data[i]) * data[i];
+        }
+
+        auto peak = 0.25f;
+        auto squares = 2.0;
+        simd::accumulatePeakAndPower(data.data(), numSamples, peak, squares);
+        CHECK_NEAR(peak, expectedPeak, 0.0);
+        CHECK_NEAR(squares, expectedSquares, 1e-5);
+
+        peak = 0.25f;
+        squares = 2.0;
+        simd::accumulatePeakAndPower(wide.data(), numSamples, peak, squares);
+        CHECK_NEAR(peak, expectedPeak, 0.0);
+        CHECK_NEAR(squares, expectedSquares, 1e-5);
+    }
+}
+
+TEST_CASE("Four-lane log2/exp2 match the scalar approximations")
+{
+    for (float x = 1e-6f; x < 100.0f; x *= 1.37f)
+    {
+        const float input[] = { x, 0.5f * x, 3.0f * x, 1.0f / x };
+        float result[4];
+
+        simd::store4(result, simd::fastLog2x4(simd::load4(input)));
+
+        for (int lane = 0; lane < 4; ++lane)
+            CHECK_NEAR(result[lane], fastmath::fastLog2(input[lane]), 1e-6);
+    }
+
+    for (float x = -130.0f; x < 130.0f; x += 0.73f)
+    {
+        const float input[] = { x, -x, 0.1f * x, 0.5f };
+        float result[4];
+
+        simd::store4(result, simd::fastExp2x4(simd::load4(input)));
+
+        for (int lane = 0; lane < 4; ++lane)
+            CHECK_NEAR(result[lane] / fastmath::fastExp2(input[lane]), 1.0f, 1e-6);
+    }
+
+    // Per-lane select: a < b ? x : y
+    const float a[] = { 1.0f, 2.0f, 3.0f, 4.0f }, b[] = { 2.0f, 2.0f, 1.0f, 5.0f };
+    float selected[4];
+    simd::store4(selected, simd::selectLess4(simd::load4(a), simd::load4(b), simd::splat4(1.0f), simd::splat4(0.0f)));
+
+    CHECK(selected[0] == 1.0f && selected[1] == 0.0f && selected[2] == 0.0f && selected[3] == 1.0f);
+}
+
+TEST_MAIN()
@@ -0,0 +1,76 @@
+/*
+  ==============================================================================
+
+    SlidingMaximumTests.cpp
+
+  ==============================================================================
+*/
+
+#include "TestHarness.h"
+#include "../Source/DSP/SlidingMaximum.h"
+
+#include <random>
+#include <vector>
+
+using autocomp::SlidingMaximum;
+
+TEST_CASE("Matches a brute-force window maximum")
+{
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+
+    std::vector<float> input(5000);
+
+    for (auto& value : input)
+        value = distribution(random);
+
+    // Long decreasing runs stress the deque the most
+    for (int i = 2000; i < 2600; ++i)
+        input[(size_t) i] = 1.0f - (float) (i - 2000) / 600.0f;
+
+    SlidingMaximum peak;
+    peak.prepare(500);
+
+    for (int window : { 1, 2, 7, 64, 441, 500 })
+    {
+        peak.setWindowLength(window);
+
+        for (int i = 0; i < (int) input.size(); ++i)
+        {
+            auto expected = 0.0f;
+
+            for (int j = std::max(0, i - window + 1); j <= i; ++j)
+                expected = std::max(expected, input[(size_t) j]);
+
+            CHECK_NEAR(peak.push(input[(size_t) i]), expected, 0.0);
+        }
+    }
+}
+
+TEST_CASE("Window is clamped to the prepared size")
+{
+    SlidingMaximum peak;
+    peak.prepare(16);
+    peak.setWindowLength(1000);
+    CHECK(peak.getWindowLength() == 16);
+
+    peak.setWindowLength(0);
+    CHECK(peak.getWindowLength() == 1);
+}
+
+TEST_CASE("Block processing works in place")
+{
+    SlidingMaximum peak;
+    peak.prepare(4);
+    peak.setWindowLength(3);
+
+    std::vector<float> data { 1.0f, 0.0f, 0.0f, 0.0f, 5.0f, 2.0f, 1.0f, 0.5f };
+    peak.process(data.data(), data.data(), (int) data.size());
+
+    const std::vector<float> expected { 1.0f, 1.0f, 1.0f, 0.0f, 5.0f, 5.0f, 5.0f, 2.0f };
+
+    for (size_t i = 0; i < data.size(); ++i)
+        CHECK_NEAR(data[i], expected[i], 0.0);
+}
+
+TEST_MAIN()
@@ -0,0 +1,103 @@
+/*
+  ==============================================================================
+
+    SlidingRmsTests.cpp
+
+  ==============================================================================
+*/
+
+#include "TestHarness.h"
+#include "../Source/DSP/SlidingRms.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using autocomp::SlidingRms;
+
+TEST_CASE("Matches a brute-force window RMS across channels")
+{
+    std::mt19937 random(99);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    std::vector<float> left(20000), right(20000);
+
+    for (size_t i = 0; i < left.size(); ++i)
+    {
+        left[i] = distribution(random);
+        right[i] = 0.25f * distribution(random);
+    }
+
+    constexpr int window = 441;
+    SlidingRms rms;
+    rms.prepare(window);
+
+    int position = 0;
+
+    for (int blockSize : { 1, 7, 128, 440, 441, 442, 1000, 3000 })
+    {
+        const float* channels[] = { left.data() + position, right.data() + position };
+        rms.process(channels, 2, blockSize);
+        position += blockSize;
+
+        double expected = 0.0;
+
+        for (int i = position - window; i < position; ++i)
+            if (i >= 0)
+                expected += 0.5 * ((double) left[(size_t) i] * left[(size_t) i]
+                                   + (double) right[(size_t) i] * right[(size_t) i]);
+
+        CHECK_NEAR(rms.getRms(), std::sqrt(expected / window), 1e-5);
+    }
+}
+
+TEST_CASE("Sine reads its RMS once the window is full")
+{
+    SlidingRms rms;
+    rms.prepare(4800);
+
+    std::vector<float> sine(48000);
+
+    for (size_t i = 0; i < sine.size(); ++i)
+        sine[i] = 0.8f * std::sin(2.0f * 3.14159265f * 100.0f * (float) i / 48000.0f);
+
+    const float* channels[] = { sine.data() };
+    rms.process(channels, 1, (int) sine.size());
+
+    CHECK_NEAR(rms.getRms(), 0.8f / std::sqrt(2.0f), 1e-4);
+}
+
+TEST_CASE("Running sum does not drift over long runs")
+{
+    SlidingRms rms;
+    rms.prepare(1000);
+
+    std::vector<float> loud(512, 1.0f), silence(512, 0.0f);
+    const float* loudChannels[] = { loud.data() };
+    const float* silentChannels[] = { silence.data() };
+
+    for (int block = 0; block < 20000; ++block)
+        rms.process(loudChannels, 1, 512);
+
+    CHECK_NEAR(rms.getRms(), 1.0f, 1e-6);
+
+    rms.process(silentChannels, 1, 512);
+    rms.process(silentChannels, 1, 512);
+    CHECK_NEAR(rms.getRms(), 0.0f, 0.0);
+}
+
+TEST_CASE("Reset clears the window")
+{
+    SlidingRms rms;
+    rms.prepare(100);
+
+    std::vector<float> ones(50, 1.0f);
+    const float* channels[] = { ones.data() };
+    rms.process(channels, 1, 50);
+    CHECK_NEAR(rms.getMeanSquare(), 0.5f, 1e-6);
+
+    rms.reset();
+    CHECK_NEAR(rms.getMeanSquare(), 0.0f, 0.0);
+}
+
+TEST_MAIN()
@@ -0,0 +1,131 @@
+/*
+  ==============================================================================
+
+    StateChunkTests.cpp
+
+  ==============================================================================
+*/
+
+#include "TestHarness.h"
+#include "../Source/DSP/StateChunk.h"
+
+#include <iterator>
+#include <vector>
+
+namespace state = autocomp::state;
+
+namespace
+{
+    std::vector<state::ParameterValue> someParameters()
+    {
+        return { { state::hashId("threshold"), -24.5f },
+                 { state::hashId("ratio"), 4.0f },
+                 { state::hashId("attack"), 0.1f },
+                 { state::hashId("sidechain"), 1.0f } };
+    }
+
+    std::vector<std::uint8_t> writeChunk(const std::vector<state::ParameterValue>& values)
+    {
+        const auto numValues = static_cast<int>(values.size());
+        std::vector<std::uint8_t> chunk(state::getSize(numValues));
+        CHECK(state::write(values.data(), numValues, chunk.data(), chunk.size()) == chunk.size());
+        return chunk;
+    }
+}
+
+TEST_CASE("Values survive a round trip bit for bit")
+{
+    const auto values = someParameters();
+    const auto chunk = writeChunk(values);
+    CHECK(chunk.size() == 8 + 4 * 8 + 4);
+    CHECK(state::isChunk(chunk.data(), chunk.size()));
+
+    state::ParameterValue read[state::maxParameters];
+    CHECK(state::read(chunk.data(), chunk.size(), read, state::maxParameters) == 4);
+
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        CHECK(read[i].id == values[i].id);
+        CHECK(read[i].value == values[i].value);
+    }
+}
+
+TEST_CASE("The layout is little-endian whatever the host")
+{
+    const std::vector<state::ParameterValue> values { { 0x04030201u, 1.0f } };
+    const auto chunk = writeChunk(values);
+
+    const std::uint8_t expected[] = { 'C', 'U', 'M', 'S', 1, 0, 1, 0,
+                                      0x01, 0x02, 0x03, 0x04, 0x00, 0x00, 0x80, 0x3f };
+
+    for (size_t i = 0; i < sizeof(expected); ++i)
+        CHECK(chunk[i] == expected[i]);
+}
+
+TEST_CASE("Parameter ids hash to distinct stable keys")
+{
+    CHECK(state::hashId("") == 2166136261u);
+    CHECK(state::hashId("a") == 0xe40c292cu);       // FNV-1a reference value
+
+    const char* ids[] = { "autoCompress", "mode", "level", "threshold", "ratio", "attack", "release", "makeup",
+                          "targetLoudness", "lookahead", "oversampling", "bands", "sidechain", "detectorHighPass",
+                          "linkMode" };
+
+    for (size_t i = 0; i < std::size(ids); ++i)
+        for (size_t j = i + 1; j < std::size(ids); ++j)
+            CHECK(state::hashId(ids[i]) != state::hashId(ids[j]));
+}
+
+TEST_CASE("Old XML states are not mistaken for chunks")
+{
+    // copyXmlToBinary's header: magic 0x21324356, then the size
+    const std::uint8_t xmlState[] = { 0x56, 0x43, 0x32, 0x21, 0x10, 0, 0, 0, '<', '?', 'x', 'm', 'l' };
+    state::ParameterValue read[state::maxParameters];
+
+    CHECK(! state::isChunk(xmlState, sizeof(xmlState)));
+    CHECK(state::read(xmlState, sizeof(xmlState), read, state::maxParameters) == -1);
+    CHECK(! state::isChunk(nullptr, 0));
+    CHECK(! state::isChunk("CUM", 3));
+}
+
+TEST_CASE("Truncated, corrupt and newer chunks are rejected")
+{
+    const auto chunk = writeChunk(someParameters());
+    state::ParameterValue read[state::maxParameters];
+
+    for (size_t size = 0; size < chunk.size(); ++size)
+        CHECK(state::read(chunk.data(), size, read, state::maxParameters) == -1);
+
+    auto corrupt = chunk;
+    corrupt[13] ^= 0x10;
+    CHECK(state::read(corrupt.data(), corrupt.size(), read, state::maxParameters) == -1);
+
+    auto tooManyEntries = chunk;
+    tooManyEntries[6] = 200;
+    CHECK(state::read(tooManyEntries.data(), tooManyEntries.size(), read, state::maxParameters) == -1);
+
+    auto newer = chunk;
+    newer[4] = state::version + 1;
+    CHECK(state::isChunk(newer.data(), newer.size()));
+    CHECK(state::read(newer.data(), newer.size(), read, state::maxParameters) == -1);
+}
+
+TEST_CASE("Reading stops at the caller's capacity and writing at the buffer's")
+{
+    const auto values = someParameters();
+    const auto chunk = writeChunk(values);
+
+    state::ParameterValue read[2];
+    CHECK(state::read(chunk.data(), chunk.size(), read, 2) == 2);
+    CHECK(read[1].id == values[1].id);
+
+    std::vector<std::uint8_t> small(state::getSize(4) - 1);
+    CHECK(state::write(values.data(), 4, small.data(), small.size()) == 0);
+
+    // An empty state is still a valid chunk
+    std::uint8_t empty[state::getSize(0)];
+    CHECK(state::write(nullptr, 0, empty, sizeof(empty)) == sizeof(empty));
+    CHECK(state::read(empty, sizeof(empty), read, 2) == 0);
+}
+
+TEST_MAIN()
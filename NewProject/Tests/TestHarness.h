@@ -0,0 +1,93 @@
+/*
+  ==============================================================================
+
+    TestHarness.h
+
+    Minimal self-registering test runner for the headless DSP tests.
+    Each test executable is one source file; ctest runs them all.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+namespace autocomp::test
+{
+
+struct TestCase
+{
+    const char* name;
+    std::function<void()> body;
+};
+
+inline std::vector<TestCase>& registry()
+{
+    static std::vector<TestCase> tests;
+    return tests;
+}
+
+inline int& failureCount()
+{
+    static int failures = 0;
+    return failures;
+}
+
+struct Registrar
+{
+    Registrar(const char* name, std::function<void()> body)
+    {
+        registry().push_back({ name, std::move(body) });
+    }
+};
+
+inline void reportFailure(const char* file, int line, const char* expression)
+{
+    std::printf("  FAILED %s:%d: %s\n", file, line, expression);
+    ++failureCount();
+}
+
+inline int runAll()
+{
+    int failedTests = 0;
+
+    for (auto& test : registry())
+    {
+        const auto failuresBefore = failureCount();
+        test.body();
+
+        const bool passed = failureCount() == failuresBefore;
+        std::printf("[%s] %s\n", passed ? "PASS" : "FAIL", test.name);
+
+        if (! passed)
+            ++failedTests;
+    }
+
+    std::printf("%d/%d tests passed\n", (int) registry().size() - failedTests, (int) registry().size());
+    return failedTests == 0 ? 0 : 1;
+}
+
+} // namespace autocomp::test
+
+#define AC_CONCAT_INNER(a, b) a##b
+#define AC_CONCAT(a, b) AC_CONCAT_INNER(a, b)
+
+#define TEST_CASE(name) \
+    static void AC_CONCAT(testBody, __LINE__)(); \
+    static autocomp::test::Registrar AC_CONCAT(testRegistrar, __LINE__)(name, AC_CONCAT(testBody, __LINE__)); \
+    static void AC_CONCAT(testBody, __LINE__)()
+
+#define CHECK(expression) \
+    do { if (! (expression)) autocomp::test::reportFailure(__FILE__, __LINE__, #expression); } while (false)
+
+#define CHECK_NEAR(actual, expected, tolerance) \
+    do { if (! (std::abs((double) (actual) - (double) (expected)) <= (double) (tolerance))) { \
+        std::printf("  %s = %g, expected %g +/- %g\n", #actual, (double) (actual), (double) (expected), (double) (tolerance)); \
+        autocomp::test::reportFailure(__FILE__, __LINE__, #actual " ~= " #expected); } } while (false)
+
+#define TEST_MAIN() \
+    int main() { return autocomp::test::runAll(); }
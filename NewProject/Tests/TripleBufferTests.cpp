@@ -0,0 +1,103 @@
+/*
+  ==============================================================================
+
+    TripleBufferTests.cpp
+
+  ==============================================================================
+*/
+
+#include "TestHarness.h"
+#include "../Source/DSP/TripleBuffer.h"
+
+#include <thread>
+
+using autocomp::TripleBuffer;
+
+namespace
+{
+    // Every field derived from one counter, so a torn read is detectable
+    struct Snapshot
+    {
+        long long sequence = 0;
+        float values[15] {};
+
+        static Snapshot make(long long n)
+        {
+            Snapshot s;
+            s.sequence = n;
+
+            for (int i = 0; i < 15; ++i)
+                s.values[i] = (float) (n % 100000) + (float) i;
+
+            return s;
+        }
+
+        bool isConsistent() const
+        {
+            for (int i = 0; i < 15; ++i)
+                if (values[i] != (float) (sequence % 100000) + (float) i)
+                    return false;
+
+            return true;
+        }
+    };
+}
+
+TEST_CASE("Reads only report fresh values")
+{
+    TripleBuffer<int> buffer;
+    int value = -1;
+
+    CHECK(! buffer.read(value));
+
+    buffer.write(1);
+    buffer.write(2);
+    CHECK(buffer.read(value));
+    CHECK(value == 2);
+    CHECK(! buffer.read(value));
+    CHECK(buffer.latest() == 2);
+
+    buffer.write(3);
+    CHECK(buffer.latest() == 3);
+    CHECK(! buffer.read(value));
+}
+
+TEST_CASE("Initial value is visible before any write")
+{
+    TripleBuffer<float> buffer(0.25f);
+    CHECK(buffer.latest() == 0.25f);
+}
+
+TEST_CASE("Concurrent writer and reader never tear or go backwards")
+{
+    TripleBuffer<Snapshot> buffer;
+    constexpr long long numWrites = 2000000;
+
+    std::thread writer([&]
+    {
+        for (long long n = 1; n <= numWrites; ++n)
+            buffer.write(Snapshot::make(n));
+    });
+
+    long long lastSeen = 0;
+    int torn = 0, backwards = 0;
+    Snapshot snapshot;
+
+    while (lastSeen < numWrites)
+    {
+        if (buffer.read(snapshot))
+        {
+            torn += snapshot.isConsistent() ? 0 : 1;
+            backwards += snapshot.sequence < lastSeen ? 1 : 0;
+            lastSeen = snapshot.sequence;
+        }
+    }
+
+    writer.join();
+
+    CHECK(torn == 0);
+    CHECK(backwards == 0);
+    CHECK(lastSeen == numWrites);
+}
+
+TEST_MAIN()
@@ -0,0 +1,464 @@
+/*
+  ==============================================================================
+
+    BatchRender.cpp
+
+    Offline batch renderer: runs the plugin's processor over files and
+    folders of WAV, FLAC and AIFF audio, without a host. Folders are
+    searched recursively and mirrored under the output folder; each file
+    comes out in its own format, bit depth and sample rate, the same length
+    as it went in (the processor's latency is trimmed off the front and
+    flushed with silence at the end).
+
+    One processor instance per worker thread, each worker taking the next
+    file as it finishes one, so every core stays busy whatever the mix of
+    file lengths. WAV and AIFF are read through a memory-mapped reader;
+    FLAC is decoded from a stream. Either way the audio is pulled in large
+    chunks, processed as one block each, and handed to a ThreadedWriter,
+    so encoding and disk writes overlap the processing. The processor runs
+    in non-realtime mode: the auto analysis runs inline, so renders are
+    reproducible.
+
+      cumpressor_render [--threads N] [--chunk FRAMES] [--program N]
+                        [--set id=value,...] --output DIR INPUT...
+
+    --set takes the host's parameter IDs and display text, e.g.
+    --set mode=Custom,threshold=-18,ratio=3,oversampling=2x
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../Source/PluginProcessor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct Options
+    {
+        int threads = juce::SystemStats::getNumCpus();
+        int chunk = 65536;                  // frames per block and read
+        int program = -1;                   // none: the default settings
+        juce::StringArray settings;         // id=value
+        juce::File output;
+        juce::StringArray inputs;
+    };
+
+    // A file to render and where its output goes
+    struct Job
+    {
+        juce::File input, output;
+    };
+
+    void printUsage()
+    {
+        std::printf("usage: cumpressor_render [--threads N] [--chunk FRAMES] [--program N]\n"
+                    "                         [--set id=value,...] --output DIR INPUT...\n"
+                    "       INPUT is a WAV, FLAC or AIFF file, or a folder (searched recursively)\n");
+    }
+
+    // Returns false (after printing usage) for --help or a bad argument
+    bool parseOptions(int argc, char** argv, Options& options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string argument = argv[i];
+            const auto hasValue = i + 1 < argc;
+
+            if ((argument == "--output" || argument == "-o") && hasValue)
+                options.output = juce::File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+            else if (argument == "--threads" && hasValue)   options.threads = std::max(std::atoi(argv[++i]), 1);
+            else if (argument == "--chunk" && hasValue)     options.chunk = std::max(std::atoi(argv[++i]), 64);
+            else if (argument == "--program" && hasValue)   options.program = std::atoi(argv[++i]);
+            else if (argument == "--set" && hasValue)       options.settings.addTokens(argv[++i], ",", "");
+            else if (! argument.empty() && argument[0] != '-')
+                options.inputs.add(argv[i]);
+            else
+            {
+                printUsage();
+                return false;
+            }
+        }
+
+        if (options.output == juce::File() || options.inputs.isEmpty())
+        {
+            printUsage();
+            return false;
+        }
+
+        return true;
+    }
+
+    bool isAudioFile(const juce::File& file)
+    {
+        return file.hasFileExtension("wav;flac;aif;aiff");
+    }
+
+    // Every audio file named or found under a named folder, with its output
+    // path; false if an input doesn't exist or would be overwritten
+    bool collectJobs(const Options& options, std::vector<Job>& jobs)
+    {
+        const auto cwd = juce::File::getCurrentWorkingDirectory();
+
+        for (const auto& name : options.inputs)
+        {
+            const auto input = cwd.getChildFile(name);
+
+            if (input.isDirectory())
+            {
+                auto files = input.findChildFiles(juce::File::findFiles, true);
+                files.sort();
+
+                for (const auto& file : files)
+                    if (isAudioFile(file))
+                        jobs.push_back({ file, options.output.getChildFile(file.getRelativePathFrom(input)) });
+            }
+            else if (input.existsAsFile() && isAudioFile(input))
+            {
+                jobs.push_back({ input, options.output.getChildFile(input.getFileName()) });
+            }
+            else
+            {
+                std::printf("not an audio file or folder: %s\n", input.getFullPathName().toRawUTF8());
+                return false;
+            }
+        }
+
+        for (const auto& job : jobs)
+        {
+            if (job.output == job.input)
+            {
+                std::printf("output would overwrite its input: %s\n", job.input.getFullPathName().toRawUTF8());
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // --program, then --set in order, on a fresh processor
+    bool applySettings(AutoCompressorAudioProcessor& processor, const Options& options, juce::String& error)
+    {
+        if (options.program >= 0)
+        {
+            if (options.program >= processor.getNumPrograms())
+            {
+                error = "no program " + juce::String(options.program);
+                return false;
+            }
+
+            processor.setCurrentProgram(options.program);
+        }
+
+        for (const auto& setting : options.settings)
+        {
+            const auto id = setting.upToFirstOccurrenceOf("=", false, false).trim();
+            const auto text = setting.fromFirstOccurrenceOf("=", false, false).trim();
+            auto* parameter = processor.parameters.getParameter(id);
+
+            if (parameter == nullptr || text.isEmpty())
+            {
+                error = "bad setting: " + setting;
+                return false;
+            }
+
+            parameter->setValueNotifyingHost(parameter->getValueForText(text));
+        }
+
+        return true;
+    }
+
+    //==============================================================================
+    struct Totals
+    {
+        std::atomic<int> next { 0 };            // index of the next job to take
+        std::atomic<int> failed { 0 };
+        std::atomic<std::int64_t> audioMicroseconds { 0 };
+        juce::CriticalSection printLock;
+    };
+
+    // One worker thread: its own processor, writer thread and buffers,
+    // reused from file to file
+    class RenderWorker : public juce::ThreadPoolJob
+    {
+    public:
+        RenderWorker(const std::vector<Job>& jobsToRender, Totals& sharedTotals, const juce::AudioFormatManager& manager,
+                     int chunkSize)
+            : juce::ThreadPoolJob("render"),
+              jobs(jobsToRender), totals(sharedTotals), formats(manager), chunk(chunkSize)
+        {
+            writerThread.startThread();
+        }
+
+        ~RenderWorker() override
+        {
+            writerThread.stopThread(10000);
+        }
+
+        // Set up by main() before the pool starts
+        AutoCompressorAudioProcessor processor;
+
+        JobStatus runJob() override
+        {
+            for (auto index = totals.next++; index < static_cast<int>(jobs.size()) && ! shouldExit(); index = totals.next++)
+            {
+                const auto& job = jobs[static_cast<size_t>(index)];
+                const auto start = std::chrono::steady_clock::now();
+                juce::String error;
+                double seconds = 0.0;
+
+                const auto rendered = render(job, seconds, error);
+                const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+                if (! rendered)
+                    ++totals.failed;
+
+                const juce::ScopedLock lock(totals.printLock);
+
+                if (rendered)
+                    std::printf("%-60s %9.1f s %9.1fx realtime\n", job.input.getFileName().toRawUTF8(), seconds,
+                                seconds / std::max(elapsed.count(), 1e-9));
+                else
+                    std::printf("%-60s failed: %s\n", job.input.getFullPathName().toRawUTF8(), error.toRawUTF8());
+            }
+
+            return jobHasFinished;
+        }
+
+    private:
+        std::unique_ptr<juce::AudioFormatReader> openReader(const juce::File& file, juce::AudioFormat& format)
+        {
+            // WAV and AIFF map straight from the file; the pages are read in
+            // as the chunks reach them
+            std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped(format.createMemoryMappedReader(file));
+
+            if (mapped != nullptr && mapped->mapEntireFile())
+                return mapped;
+
+            // The reader owns the stream once it opens
+            auto stream = std::make_unique<juce::FileInputStream>(file);
+
+            if (! stream->openedOk())
+                return nullptr;
+
+            std::unique_ptr<juce::AudioFormatReader> reader(format.createReaderFor(stream.get(), false));
+
+            if (reader != nullptr)
+                stream.release();
+
+            return reader;
+        }
+
+        bool render(const Job& job, double& seconds, juce::String& error)
+        {
+            auto* format = formats.findFormatForFileExtension(job.input.getFileExtension());
+            std::unique_ptr<juce::AudioFormatReader> reader;
+
+            if (format != nullptr)
+                reader = openReader(job.input, *format);
+
+            if (reader == nullptr || reader->sampleRate <= 0.0 || reader->numChannels == 0)
+            {
+                error = "cannot read the file";
+                return false;
+            }
+
+            // Main bus as wide as the file, sidechain off
+            const auto numChannels = static_cast<int>(reader->numChannels);
+            auto channelSet = juce::AudioChannelSet::canonicalChannelSet(numChannels);
+
+            if (channelSet.size() != numChannels)
+                channelSet = juce::AudioChannelSet::discreteChannels(numChannels);
+
+            juce::AudioProcessor::BusesLayout layout;
+            layout.inputBuses.add(channelSet);
+            layout.outputBuses.add(channelSet);
+
+            for (int bus = 1; bus < processor.getBusCount(true); ++bus)
+                layout.inputBuses.add(juce::AudioChannelSet::disabled());
+
+            if (! processor.setBusesLayout(layout))
+            {
+                error = juce::String(numChannels) + " channels not supported";
+                return false;
+            }
+
+            // Same format, rate, channels and (where the format allows) bit depth
+            auto bitsPerSample = static_cast<int>(reader->bitsPerSample);
+
+            if (! format->getPossibleBitDepths().contains(bitsPerSample))
+                bitsPerSample = 24;
+
+            if (! job.output.getParentDirectory().createDirectory().wasOk())
+            {
+                error = "cannot create " + job.output.getParentDirectory().getFullPathName();
+                return false;
+            }
+
+            job.output.deleteFile();
+            auto stream = std::make_unique<juce::FileOutputStream>(job.output);
+
+            if (! stream->openedOk())
+            {
+                error = "cannot write " + job.output.getFullPathName();
+                return false;
+            }
+
+            std::unique_ptr<juce::AudioFormatWriter> fileWriter(format->createWriterFor(stream.get(), reader->sampleRate,
+                                                                                       reader->numChannels, bitsPerSample,
+                                                                                       reader->metadataValues, 0));
+
+            if (fileWriter == nullptr)
+            {
+                job.output.deleteFile();
+                error = "cannot encode " + juce::String(bitsPerSample) + "-bit " + format->getFormatName();
+                return false;
+            }
+
+            stream.release();   // owned by the writer now
+
+            // The writer thread encodes and writes while the next chunk is processed
+            auto writer = std::make_unique<juce::AudioFormatWriter::ThreadedWriter>(fileWriter.release(), writerThread,
+                                                                                    4 * chunk);
+
+            processor.setNonRealtime(true);
+            processor.setRateAndBufferSizeDetails(reader->sampleRate, chunk);
+            processor.prepareToPlay(reader->sampleRate, chunk);
+
+            buffer.setSize(numChannels, chunk, false, false, true);
+            juce::MidiBuffer midi;
+            std::vector<const float*> channels(static_cast<size_t>(numChannels));
+
+            // Output frame n is input frame n - latency: feed silence past the
+            // end until the last input frame is out, drop the first latency frames
+            const auto length = reader->lengthInSamples;
+            const juce::int64 latency = processor.getLatencySamples();
+            juce::int64 processed = 0, written = 0;
+
+            while (written < length)
+            {
+                const auto available = static_cast<int>(juce::jlimit<juce::int64>(0, chunk, length - processed));
+
+                if (available > 0 && ! reader->read(&buffer, 0, available, processed, true, true))
+                {
+                    error = "read error";
+                    break;
+                }
+
+                if (available < chunk)
+                    buffer.clear(available, chunk - available);
+
+                processor.processBlock(buffer, midi);
+
+                const auto skip = static_cast<int>(juce::jlimit<juce::int64>(0, chunk, latency - processed));
+                const auto count = static_cast<int>(juce::jmin<juce::int64>(chunk - skip, length - written));
+                processed += chunk;
+
+                if (count <= 0)
+                    continue;
+
+                for (int channel = 0; channel < numChannels; ++channel)
+                    channels[static_cast<size_t>(channel)] = buffer.getReadPointer(channel, skip);
+
+                while (! writer->write(channels.data(), count))
+                    juce::Thread::sleep(1);     // writer thread behind: wait for room
+
+                written += count;
+            }
+
+            writer.reset();     // flushes what's left
+            processor.releaseResources();
+
+            if (written < length)
+            {
+                job.output.deleteFile();
+                return false;
+            }
+
+            seconds = static_cast<double>(length) / reader->sampleRate;
+            totals.audioMicroseconds += static_cast<std::int64_t>(seconds * 1e6);
+            return true;
+        }
+
+        const std::vector<Job>& jobs;
+        Totals& totals;
+        const juce::AudioFormatManager& formats;
+        const int chunk;
+
+        juce::TimeSliceThread writerThread { "render writer" };
+        juce::AudioBuffer<float> buffer;
+    };
+}
+
+//==============================================================================
+int main(int argc, char** argv)
+{
+    Options options;
+
+    if (! parseOptions(argc, argv, options))
+        return argc > 1 && std::string(argv[argc - 1]) == "--help" ? 0 : 2;
+
+    // The processors post async updates; they need a message manager to exist
+    const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    std::vector<Job> jobs;
+
+    if (! collectJobs(options, jobs))
+        return 2;
+
+    if (jobs.empty())
+    {
+        std::printf("no audio files found\n");
+        return 0;
+    }
+
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+
+    const auto numWorkers = std::min(options.threads, static_cast<int>(jobs.size()));
+    Totals totals;
+    std::vector<std::unique_ptr<RenderWorker>> workers;
+
+    // Processors are built here, on the message thread
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        workers.push_back(std::make_unique<RenderWorker>(jobs, totals, formats, options.chunk));
+        juce::String error;
+
+        if (! applySettings(workers.back()->processor, options, error))
+        {
+            std::printf("%s\n", error.toRawUTF8());
+            return 2;
+        }
+    }
+
+    std::printf("%d files, %d threads, %d-frame chunks\n", static_cast<int>(jobs.size()), numWorkers, options.chunk);
+
+    const auto start = std::chrono::steady_clock::now();
+    juce::ThreadPool pool(numWorkers);
+
+    for (auto& worker : workers)
+        pool.addJob(worker.get(), false);
+
+    for (auto& worker : workers)
+        pool.waitForJobToFinish(worker.get(), -1);
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    const auto audioSeconds = static_cast<double>(totals.audioMicroseconds.load()) * 1e-6;
+    const auto failed = totals.failed.load();
+
+    std::printf("\n%d rendered, %d failed: %.1f s of audio in %.1f s, %.1fx realtime\n",
+                static_cast<int>(jobs.size()) - failed, failed, audioSeconds, elapsed.count(),
+                audioSeconds / std::max(elapsed.count(), 1e-9));
+
+    return failed > 0 ? 1 : 0;
+}